@@ -0,0 +1,93 @@
+#include "vp_bench.hpp"
+
+#include "vulpengine/experimental/vp_jobs.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+	using namespace vulpengine::experimental;
+	using namespace vulpengine::bench;
+
+	constexpr std::size_t kElements = 1 << 16;
+
+	// A few dozen flops per element, enough that scaling isn't bound by memory bandwidth
+	float work(float value) {
+		for (int i = 0; i < 16; ++i) value = std::sqrt(value * value + 1.0f) * 0.5f;
+		return value;
+	}
+
+	std::vector<float> make_values(std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> dist(0.0f, 100.0f);
+		std::vector<float> values(kElements);
+		for (float& value : values) value = dist(rng);
+		return values;
+	}
+
+	// Restarts the job system with `Threads` threads in total, the benchmark thread included
+	template<std::uint32_t Threads>
+	void parallel_for_scaling(Context& ctx) {
+		jobs::shutdown();
+		jobs::init({ .workerCount = Threads - 1 });
+
+		std::vector<float> const input = make_values(ctx.seed());
+		std::vector<float> output(kElements);
+
+		ctx.run([&] {
+			jobs::parallel_for(0, kElements, 0, [&](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i < last; ++i) output[i] = work(input[i]);
+			});
+			clobber_memory();
+		}, kElements);
+
+		jobs::shutdown();
+	}
+
+	VP_BENCHMARK("jobs/serial", [](Context& ctx) {
+		std::vector<float> const input = make_values(ctx.seed());
+		std::vector<float> output(kElements);
+
+		ctx.run([&] {
+			for (std::size_t i = 0; i < kElements; ++i) output[i] = work(input[i]);
+			clobber_memory();
+		}, kElements);
+	});
+
+	VP_BENCHMARK("jobs/parallel_for/t01", parallel_for_scaling<1>);
+	VP_BENCHMARK("jobs/parallel_for/t02", parallel_for_scaling<2>);
+	VP_BENCHMARK("jobs/parallel_for/t04", parallel_for_scaling<4>);
+	VP_BENCHMARK("jobs/parallel_for/t08", parallel_for_scaling<8>);
+	VP_BENCHMARK("jobs/parallel_for/t16", parallel_for_scaling<16>);
+	VP_BENCHMARK("jobs/parallel_for/t32", parallel_for_scaling<32>);
+	VP_BENCHMARK("jobs/parallel_for/t64", parallel_for_scaling<64>);
+
+	// Submitting and finishing empty jobs, the fixed cost every job pays
+	VP_BENCHMARK("jobs/run_wait", [](Context& ctx) {
+		constexpr int kJobs = 256;
+		jobs::init();
+		jobs::Counter counter;
+
+		ctx.run([&] {
+			for (int i = 0; i < kJobs; ++i) jobs::run(counter, [] {});
+			jobs::wait(counter);
+		}, kJobs);
+	});
+
+	// Each job queued by the previous one finishing
+	VP_BENCHMARK("jobs/run_after_chain", [](Context& ctx) {
+		constexpr int kLinks = 64;
+		jobs::init();
+
+		ctx.run([&] {
+			jobs::Counter counters[kLinks];
+			jobs::run(counters[0], [] {});
+			for (int i = 1; i < kLinks; ++i) jobs::run_after(counters[i - 1], counters[i], [] {});
+
+			// Destroyed in reverse, so every counter has to be done, not just the last
+			for (jobs::Counter& counter : counters) jobs::wait(counter);
+		}, kLinks);
+	});
+}
@@ -0,0 +1,88 @@
+#include "vp_bench.hpp"
+
+#include "vulpengine/vp_logger.hpp"
+
+#include <cstdio>
+#include <format>
+
+namespace {
+	using namespace vulpengine;
+	using namespace vulpengine::bench;
+
+#ifdef _WIN32
+	constexpr char const* kNullDevice = "NUL";
+#else
+	constexpr char const* kNullDevice = "/dev/null";
+#endif
+
+	// Sends the logger's output to the null device while a benchmark runs
+	class NullOutput final {
+	public:
+		NullOutput() : mFile(std::fopen(kNullDevice, "wb")) {
+			if (mFile) logger::set_files(mFile, mFile);
+		}
+
+		NullOutput(NullOutput const&) = delete;
+		NullOutput& operator=(NullOutput const&) = delete;
+
+		~NullOutput() noexcept {
+			logger::set_files(stdout, stderr);
+			if (mFile) std::fclose(mFile);
+		}
+
+		inline std::FILE* file() const { return mFile; }
+	private:
+		std::FILE* mFile;
+	};
+
+	// The runtime check is all a filtered out message costs, nothing is formatted
+	VP_BENCHMARK("log/filtered", [](Context& ctx) {
+		logger::set_level(logger::Level::kInfo);
+		int handle = 42;
+
+		ctx.run([&] {
+			do_not_optimize(handle);
+			logger::write(logger::Level::kTrace, "Created texture: {}", handle);
+		});
+
+		logger::set_level(logger::Level::kTrace);
+	});
+
+	// Caller side latency with the writer thread draining, includes waiting on a full ring
+	VP_BENCHMARK("log/async", [](Context& ctx) {
+		NullOutput const output;
+		logger::start();
+		int handle = 42;
+
+		ctx.run([&] {
+			do_not_optimize(handle);
+			logger::write(logger::Level::kTrace, "Created texture: {}", handle);
+		});
+
+		logger::stop();
+	});
+
+	// The logger with no writer thread, every message is written on the calling thread
+	VP_BENCHMARK("log/sync", [](Context& ctx) {
+		NullOutput const output;
+		int handle = 42;
+
+		ctx.run([&] {
+			do_not_optimize(handle);
+			logger::write(logger::Level::kTrace, "Created texture: {}", handle);
+		});
+	});
+
+	// What VP_LOG_* did before the logger existed: std::cout << std::format(...) << '\n'
+	VP_BENCHMARK("log/format_and_write", [](Context& ctx) {
+		NullOutput const output;
+		int handle = 42;
+
+		ctx.run([&] {
+			do_not_optimize(handle);
+			std::string const line = std::format("Created texture: {}", handle);
+			std::fwrite(line.data(), 1, line.size(), output.file());
+			std::fputc('\n', output.file());
+		});
+	});
+}
@@ -0,0 +1,114 @@
+#include "vp_bench.hpp"
+#include "vp_bench_fixtures.hpp"
+
+#include "vulpengine/vp_features.hpp"
+
+#ifdef VP_HAS_GLM
+
+#include "vulpengine/vp_frustum_cull.hpp"
+#include "vulpengine/vp_transform.hpp"
+#include "vulpengine/vp_util.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+	using namespace vulpengine;
+	using namespace vulpengine::bench;
+
+	glm::mat4 camera_view_projection() {
+		glm::mat4 const projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+		glm::mat4 const view = glm::lookAt(glm::vec3(0.0f, 5.0f, 20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		return projection * view;
+	}
+
+	VP_BENCHMARK("frustum/construct", [](Context& ctx) {
+		glm::mat4 viewProj = camera_view_projection();
+
+		ctx.run([&] {
+			do_not_optimize(viewProj);
+			Frustum frustum(viewProj);
+			do_not_optimize(frustum);
+		});
+	});
+
+	// Roughly a third of the boxes are visible from the fixture camera
+	VP_BENCHMARK("frustum/intersect_aabb", [](Context& ctx) {
+		Random random(ctx.seed());
+		std::vector<Aabb> const aabbs = random_aabbs(random, 4096, 100.0f);
+		Frustum const frustum(camera_view_projection());
+
+		ctx.run([&] {
+			std::uint32_t visible = 0;
+			for (Aabb const& aabb : aabbs) visible += frustum.intersect_aabb(aabb.min, aabb.max);
+			do_not_optimize(visible);
+		}, aabbs.size());
+	});
+
+	VP_BENCHMARK("transform/get", [](Context& ctx) {
+		Random random(ctx.seed());
+		Transform transform = random_transform(random);
+
+		ctx.run([&] {
+			do_not_optimize(transform);
+			glm::mat4 matrix = transform.get();
+			do_not_optimize(matrix);
+		});
+	});
+
+	VP_BENCHMARK("transform/set", [](Context& ctx) {
+		Random random(ctx.seed());
+		glm::mat4 matrix = random_transform(random).get();
+		Transform transform;
+
+		ctx.run([&] {
+			do_not_optimize(matrix);
+			transform.set(matrix);
+			do_not_optimize(transform);
+		});
+	});
+
+	VP_BENCHMARK("transform/translate", [](Context& ctx) {
+		Random random(ctx.seed());
+		Transform transform = random_transform(random);
+		glm::vec3 direction(0.01f, 0.0f, -0.01f);
+
+		ctx.run([&] {
+			do_not_optimize(direction);
+			Transform moved = transform;
+			moved.translate(direction);
+			do_not_optimize(moved);
+		});
+	});
+
+	// World matrices for a scene graph, each node is its parent's world times its local
+	VP_BENCHMARK("transform/hierarchy_world", [](Context& ctx) {
+		Random random(ctx.seed());
+		Hierarchy const hierarchy = random_hierarchy(random, 1024, 16);
+		std::vector<glm::mat4> world(hierarchy.locals.size());
+
+		ctx.run([&] {
+			for (std::size_t i = 0; i < hierarchy.locals.size(); ++i) {
+				glm::mat4 const local = hierarchy.locals[i].get();
+				std::int32_t const parent = hierarchy.parents[i];
+				world[i] = parent < 0 ? local : world[parent] * local;
+			}
+			clobber_memory();
+		}, hierarchy.locals.size());
+	});
+
+	VP_BENCHMARK("helpers/freecam", [](Context& ctx) {
+		Transform camera;
+		camera.position = { 0.0f, 2.0f, 10.0f };
+		glm::vec3 movement(0.0f, 0.0f, -0.016f);
+		glm::vec2 rotation(0.3f, -0.1f);
+
+		ctx.run([&] {
+			do_not_optimize(movement);
+			do_not_optimize(rotation);
+			Transform moved = helpers::freecam(camera, movement, rotation);
+			do_not_optimize(moved);
+		});
+	});
+}
+
+#endif // VP_HAS_GLM
@@ -0,0 +1,282 @@
+#include "vp_bench.hpp"
+#include "vp_bench_fixtures.hpp"
+
+#include "vulpengine/vp_util.hpp"
+#include "vulpengine/experimental/vp_async_io.hpp"
+#include "vulpengine/experimental/vp_stream.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+	using namespace vulpengine;
+	using namespace vulpengine::bench;
+
+	struct Matrix final {
+		float values[16];
+	};
+
+	VP_BENCHMARK("bytestream/write_u32", [](Context& ctx) {
+		experimental::ByteStream stream;
+		std::uint32_t value = 0x12345678;
+
+		ctx.run([&] {
+			stream.mData.clear();
+			for (int i = 0; i < 1024; ++i) stream.write(value + i);
+			do_not_optimize(stream.mData.data());
+		}, 1024);
+	});
+
+	VP_BENCHMARK("bytestream/write_matrix", [](Context& ctx) {
+		experimental::ByteStream stream;
+		Matrix matrix{};
+		for (int i = 0; i < 16; ++i) matrix.values[i] = static_cast<float>(i);
+
+		ctx.run([&] {
+			stream.mData.clear();
+			for (int i = 0; i < 256; ++i) stream.write(matrix);
+			do_not_optimize(stream.mData.data());
+		}, 256);
+	});
+
+	VP_BENCHMARK("bytestream/write_bytes_64k", [](Context& ctx) {
+		Random random(ctx.seed());
+		std::vector<std::byte> const payload = random_bytes(random, 64 * 1024);
+		experimental::ByteStream stream;
+
+		ctx.run([&] {
+			stream.mData.clear();
+			stream.write(payload.data(), payload.size());
+			do_not_optimize(stream.mData.data());
+		}, payload.size());
+	});
+
+	// Files live in the temp directory for the duration of the benchmark
+	class TempFile final {
+	public:
+		TempFile(std::string_view name, std::vector<std::byte> const& content)
+			: mPath(std::filesystem::temp_directory_path() / name) {
+			std::ofstream file(mPath, std::ios::out | std::ios::binary);
+			file.write(reinterpret_cast<char const*>(content.data()), static_cast<std::streamsize>(content.size()));
+		}
+
+		TempFile(TempFile const&) = delete;
+		TempFile& operator=(TempFile const&) = delete;
+
+		~TempFile() noexcept {
+			std::error_code ec;
+			std::filesystem::remove(mPath, ec);
+		}
+
+		inline std::filesystem::path const& path() const { return mPath; }
+	private:
+		std::filesystem::path mPath;
+	};
+
+	void read_file_benchmark(Context& ctx, std::size_t size) {
+		Random random(ctx.seed());
+		TempFile const file("vp_bench_read_file_" + std::to_string(size) + ".bin", random_bytes(random, size));
+
+		ctx.run([&] {
+			auto content = read_file(file.path());
+			do_not_optimize(content);
+		}, size);
+	}
+
+	VP_BENCHMARK("read_file/4k", [](Context& ctx) { read_file_benchmark(ctx, 4 * 1024); });
+	VP_BENCHMARK("read_file/1m", [](Context& ctx) { read_file_benchmark(ctx, 1024 * 1024); });
+
+	// A level's worth of loose files, read one after another or in a single batch
+	struct FileSet final {
+		static constexpr std::size_t kCount = 64;
+		static constexpr std::size_t kSize = 256 * 1024;
+
+		std::vector<std::unique_ptr<TempFile>> files;
+		std::vector<std::vector<std::byte>> buffers;
+
+		FileSet(std::uint32_t seed) : buffers(kCount, std::vector<std::byte>(kSize)) {
+			Random random(seed);
+			for (std::size_t i = 0; i < kCount; ++i)
+				files.push_back(std::make_unique<TempFile>("vp_bench_read_files_" + std::to_string(i) + ".bin", random_bytes(random, kSize)));
+		}
+	};
+
+	void read_files_async_benchmark(Context& ctx, bool fallback) {
+		FileSet set(ctx.seed());
+		experimental::aio::Reader reader({ .forceFallback = fallback });
+		std::vector<experimental::aio::Completion> completions;
+
+		ctx.run([&] {
+			for (std::size_t i = 0; i < FileSet::kCount; ++i) reader.read(set.files[i]->path(), set.buffers[i], i);
+			reader.submit();
+
+			while (reader.pending()) {
+				completions.clear();
+				reader.wait(completions);
+			}
+
+			do_not_optimize(completions.data());
+		}, FileSet::kCount * FileSet::kSize);
+	}
+
+	VP_BENCHMARK("read_files/64x256k/read_file", [](Context& ctx) {
+		FileSet set(ctx.seed());
+
+		ctx.run([&] {
+			for (auto const& file : set.files) {
+				auto content = read_file(file->path());
+				do_not_optimize(content);
+			}
+		}, FileSet::kCount * FileSet::kSize);
+	});
+
+	VP_BENCHMARK("read_files/64x256k/aio", [](Context& ctx) { read_files_async_benchmark(ctx, false); });
+	VP_BENCHMARK("read_files/64x256k/aio_threads", [](Context& ctx) { read_files_async_benchmark(ctx, true); });
+
+	// The hash UnorderedStringMap used before it was a FlatMap
+	struct NodeHash final {
+		using is_transparent = void;
+		std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+	};
+
+	struct StringMapFixture final {
+		UnorderedStringMap<int> map;
+		std::unordered_map<std::string, int, NodeHash, std::equal_to<>> nodeMap;
+		InternedStringMap<int> internedMap;
+		std::vector<std::string> hits;
+		std::vector<std::string> misses;
+		std::vector<InternedString> internedHits;
+
+		StringMapFixture(std::uint32_t seed) {
+			Random random(seed);
+			hits = uniform_names(random, 1024);
+
+			for (std::size_t i = 0; i < hits.size(); ++i) {
+				map.emplace(hits[i], static_cast<int>(i));
+				nodeMap.emplace(hits[i], static_cast<int>(i));
+				internedHits.push_back(intern(hits[i]));
+				internedMap.emplace(internedHits.back(), static_cast<int>(i));
+			}
+
+			misses = hits;
+			for (std::string& miss : misses) miss.back() = '#';
+		}
+	};
+
+	VP_BENCHMARK("string_map/find_hit", [](Context& ctx) {
+		StringMapFixture const fixture(ctx.seed());
+
+		ctx.run([&] {
+			int sum = 0;
+			for (std::string const& key : fixture.hits) sum += fixture.map.find(std::string_view(key))->second;
+			do_not_optimize(sum);
+		}, fixture.hits.size());
+	});
+
+	VP_BENCHMARK("string_map/find_miss", [](Context& ctx) {
+		StringMapFixture const fixture(ctx.seed());
+
+		ctx.run([&] {
+			int found = 0;
+			for (std::string const& key : fixture.misses) found += fixture.map.find(std::string_view(key)) != fixture.map.end();
+			do_not_optimize(found);
+		}, fixture.misses.size());
+	});
+
+	// What UnorderedStringMap was before the flat map, a node based std::unordered_map
+	VP_BENCHMARK("string_map/node_find_hit", [](Context& ctx) {
+		StringMapFixture const fixture(ctx.seed());
+
+		ctx.run([&] {
+			int sum = 0;
+			for (std::string const& key : fixture.hits) sum += fixture.nodeMap.find(std::string_view(key))->second;
+			do_not_optimize(sum);
+		}, fixture.hits.size());
+	});
+
+	VP_BENCHMARK("string_map/node_find_miss", [](Context& ctx) {
+		StringMapFixture const fixture(ctx.seed());
+
+		ctx.run([&] {
+			int found = 0;
+			for (std::string const& key : fixture.misses) found += fixture.nodeMap.find(std::string_view(key)) != fixture.nodeMap.end();
+			do_not_optimize(found);
+		}, fixture.misses.size());
+	});
+
+	// The string isn't hashed again and keys compare by pointer
+	VP_BENCHMARK("string_map/find_interned", [](Context& ctx) {
+		StringMapFixture const fixture(ctx.seed());
+
+		ctx.run([&] {
+			int sum = 0;
+			for (InternedString key : fixture.internedHits) sum += fixture.internedMap.find(key)->second;
+			do_not_optimize(sum);
+		}, fixture.internedHits.size());
+	});
+
+	// Names already in the table, the common case when assets reload
+	VP_BENCHMARK("intern/existing", [](Context& ctx) {
+		StringMapFixture const fixture(ctx.seed());
+
+		ctx.run([&] {
+			for (std::string const& key : fixture.hits) do_not_optimize(intern(key));
+		}, fixture.hits.size());
+	});
+
+	// ShaderProgram needs a GL context, these replicate its two lookup paths over the same containers:
+	// a string keyed UnorderedStringMap and a hash sorted table searched with compile time StringIds
+	constexpr std::array<std::string_view, 12> kUniformNames{ "uModel", "uView", "uProjection", "uTime", "uColor", "uAlbedo", "uNormal", "uRoughness", "uLights[0].color", "uShadowMap", "uBones[0]", "uExposure" };
+	constexpr std::array<StringId, 12> kUniformIds{ "uModel"_sid, "uView"_sid, "uProjection"_sid, "uTime"_sid, "uColor"_sid, "uAlbedo"_sid, "uNormal"_sid, "uRoughness"_sid, "uLights[0].color"_sid, "uShadowMap"_sid, "uBones[0]"_sid, "uExposure"_sid };
+
+	struct UniformFixture final {
+		UnorderedStringMap<int> locations;
+		std::vector<std::pair<std::uint64_t, int>> ids;
+
+		UniformFixture() {
+			for (std::size_t i = 0; i < kUniformNames.size(); ++i) {
+				locations.emplace(kUniformNames[i], static_cast<int>(i));
+				ids.emplace_back(hash_fnv1a(kUniformNames[i]), static_cast<int>(i));
+			}
+
+			std::sort(ids.begin(), ids.end());
+		}
+
+		int find(StringId id) const {
+			auto it = std::lower_bound(ids.begin(), ids.end(), id.hash, [](auto const& entry, std::uint64_t hash) { return entry.first < hash; });
+			return it == ids.end() || it->first != id.hash ? -1 : it->second;
+		}
+	};
+
+	VP_BENCHMARK("uniform_lookup/string", [](Context& ctx) {
+		UniformFixture const fixture;
+
+		ctx.run([&] {
+			int sum = 0;
+			for (std::string_view name : kUniformNames) {
+				do_not_optimize(name);
+				sum += fixture.locations.find(name)->second;
+			}
+			do_not_optimize(sum);
+		}, kUniformNames.size());
+	});
+
+	VP_BENCHMARK("uniform_lookup/string_id", [](Context& ctx) {
+		UniformFixture const fixture;
+
+		ctx.run([&] {
+			int sum = 0;
+			for (StringId id : kUniformIds) {
+				do_not_optimize(id);
+				sum += fixture.find(id);
+			}
+			do_not_optimize(sum);
+		}, kUniformIds.size());
+	});
+}
@@ -0,0 +1,211 @@
+#include "vp_bench.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+namespace vulpengine::bench {
+	namespace {
+		using Clock = std::chrono::steady_clock;
+
+		struct Benchmark final {
+			char const* name;
+			BenchmarkFn fn;
+		};
+
+		// Function local so registration order between translation units doesn't matter
+		std::vector<Benchmark>& registry() {
+			static std::vector<Benchmark> benchmarks;
+			return benchmarks;
+		}
+
+		double elapsed_ns(Clock::time_point begin, Clock::time_point end) {
+			return std::chrono::duration<double, std::nano>(end - begin).count();
+		}
+
+		std::string escape_json(std::string_view str) {
+			std::string out;
+			for (char c : str) {
+				if (c == '"' || c == '\\') out += '\\';
+				out += c;
+			}
+			return out;
+		}
+
+		char const* compiler() {
+#if defined(__clang__)
+			return "clang " __clang_version__;
+#elif defined(__GNUC__)
+			return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+			return "msvc";
+#else
+			return "unknown";
+#endif
+		}
+
+		char const* configuration() {
+#if defined(VP_DIST)
+			return "dist";
+#elif defined(VP_RELEASE)
+			return "release";
+#elif defined(VP_DEBUG)
+			return "debug";
+#else
+			return "unknown";
+#endif
+		}
+
+		bool write_json(char const* path, std::vector<Result> const& results, std::uint32_t seed, std::uint32_t samples) {
+			std::ofstream file(path, std::ios::out | std::ios::binary);
+			if (!file) return false;
+
+			file << "{\n\t\"context\": { \"compiler\": \"" << escape_json(compiler()) << "\", \"configuration\": \"" << configuration() << "\", \"seed\": " << seed << ", \"samples\": " << samples << " },\n";
+			file << "\t\"benchmarks\": [";
+
+			for (std::size_t i = 0; i < results.size(); ++i) {
+				Result const& result = results[i];
+				double const itemsPerSecond = result.medianNs > 0.0 ? result.items * 1e9 / result.medianNs : 0.0;
+
+				file << (i ? ",\n" : "\n") << "\t\t{ \"name\": \"" << escape_json(result.name) << "\""
+					<< ", \"batch_size\": " << result.batchSize
+					<< ", \"items\": " << result.items
+					<< ", \"median_ns\": " << result.medianNs
+					<< ", \"mean_ns\": " << result.meanNs
+					<< ", \"min_ns\": " << result.minNs
+					<< ", \"max_ns\": " << result.maxNs
+					<< ", \"stddev_ns\": " << result.stddevNs
+					<< ", \"items_per_second\": " << itemsPerSecond << " }";
+			}
+
+			file << "\n\t]\n}\n";
+			return static_cast<bool>(file);
+		}
+
+		void print_usage() {
+			std::printf(
+				"usage: vp_bench [options]\n"
+				"  --filter <text>      only run benchmarks whose name contains text\n"
+				"  --json <path>        write results as JSON\n"
+				"  --samples <n>        timed batches per benchmark (default 15)\n"
+				"  --min-batch-ms <ms>  minimum duration of one batch (default 2)\n"
+				"  --seed <n>           fixture seed (default 1)\n"
+				"  --list               list benchmarks and exit\n"
+			);
+		}
+	}
+
+	Registration::Registration(char const* name, BenchmarkFn fn) {
+		registry().push_back({ name, fn });
+	}
+
+	Context::Context(std::string_view name, std::uint32_t seed, std::uint32_t samples, double minBatchMs)
+		: mName(name), mSeed(seed), mSamples(samples), mMinBatchMs(minBatchMs) {
+		assert(samples > 0);
+	}
+
+	void Context::run_impl(std::function<void(std::uint64_t)> const& batch, std::uint64_t items) {
+		double const minBatchNs = mMinBatchMs * 1e6;
+
+		// Warms caches and finds a batch size long enough for the clock to be accurate
+		std::uint64_t batchSize = 1;
+		for (;;) {
+			Clock::time_point const begin = Clock::now();
+			batch(batchSize);
+			double const ns = elapsed_ns(begin, Clock::now());
+
+			if (ns >= minBatchNs || batchSize >= (1ull << 40)) break;
+
+			// Jump close to the target instead of doubling from 1 for fast operations
+			std::uint64_t const estimate = ns > 0.0 ? static_cast<std::uint64_t>(batchSize * minBatchNs / ns * 1.2) : batchSize * 10;
+			batchSize = std::clamp(estimate, batchSize * 2, batchSize * 100);
+		}
+
+		std::vector<double> samples(mSamples);
+		for (double& sample : samples) {
+			Clock::time_point const begin = Clock::now();
+			batch(batchSize);
+			sample = elapsed_ns(begin, Clock::now()) / static_cast<double>(batchSize);
+		}
+
+		std::sort(samples.begin(), samples.end());
+
+		Result result;
+		result.name = mName;
+		result.batchSize = batchSize;
+		result.items = items;
+		result.minNs = samples.front();
+		result.maxNs = samples.back();
+		result.medianNs = samples.size() % 2 ? samples[samples.size() / 2] : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) * 0.5;
+		result.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+
+		double variance = 0.0;
+		for (double sample : samples) variance += (sample - result.meanNs) * (sample - result.meanNs);
+		result.stddevNs = std::sqrt(variance / samples.size());
+
+		mResults.push_back(std::move(result));
+	}
+}
+
+int main(int argc, char* argv[]) {
+	using namespace vulpengine::bench;
+
+	std::string_view filter;
+	char const* jsonPath = nullptr;
+	std::uint32_t samples = 15;
+	double minBatchMs = 2.0;
+	std::uint32_t seed = 1;
+	bool list = false;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view const arg = argv[i];
+		bool const hasValue = i + 1 < argc;
+
+		if (arg == "--filter" && hasValue) filter = argv[++i];
+		else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+		else if (arg == "--samples" && hasValue) samples = std::max(static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10)), 1u);
+		else if (arg == "--min-batch-ms" && hasValue) minBatchMs = std::strtod(argv[++i], nullptr);
+		else if (arg == "--seed" && hasValue) seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if (arg == "--list") list = true;
+		else {
+			print_usage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	std::vector<Benchmark> benchmarks = registry();
+	std::sort(benchmarks.begin(), benchmarks.end(), [](Benchmark const& a, Benchmark const& b) { return std::string_view(a.name) < std::string_view(b.name); });
+
+	std::vector<Result> results;
+
+	if (!list)
+		std::printf("%-40s %14s %14s %14s %12s\n", "benchmark", "median ns/op", "min ns/op", "stddev", "batch");
+
+	for (Benchmark const& benchmark : benchmarks) {
+		if (!filter.empty() && std::string_view(benchmark.name).find(filter) == std::string_view::npos) continue;
+
+		if (list) {
+			std::printf("%s\n", benchmark.name);
+			continue;
+		}
+
+		Context context(benchmark.name, seed, samples, minBatchMs);
+		benchmark.fn(context);
+
+		for (Result const& result : context.results()) {
+			std::printf("%-40s %14.2f %14.2f %14.2f %12llu\n", result.name.c_str(), result.medianNs, result.minNs, result.stddevNs, static_cast<unsigned long long>(result.batchSize));
+			results.push_back(result);
+		}
+	}
+
+	if (jsonPath && !write_json(jsonPath, results, seed, samples)) {
+		std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+/*!
+Minimal microbenchmark harness for the engine's CPU side paths.
+
+Benchmarks register themselves with `VP_BENCHMARK` and call `Context::run` with the
+operation to time. The operation is repeated in batches, the batch size doubles until a
+batch takes at least `--min-batch-ms`, then `--samples` batches are timed and reported
+as nanoseconds per operation. Fixtures are generated from `Context::seed` so runs are repeatable.
+
+```cpp
+VP_BENCHMARK("example/sum", [](vulpengine::bench::Context& ctx) {
+	std::vector<int> values = ...;
+	ctx.run([&] {
+		int sum = 0;
+		for (int v : values) sum += v;
+		vulpengine::bench::do_not_optimize(sum);
+	}, values.size());
+});
+```
+*/
+
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#	include <intrin.h>
+#endif
+
+namespace vulpengine::bench {
+	// Keeps the compiler from discarding a computed value
+	template<class T>
+	inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "m"(value) : "memory");
+#else
+		static_cast<void>(*static_cast<char const volatile*>(static_cast<void const*>(&value)));
+		_ReadWriteBarrier();
+#endif
+	}
+
+	// Forces memory written before this point to be considered read
+	inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#else
+		_ReadWriteBarrier();
+#endif
+	}
+
+	struct Result final {
+		std::string name;
+		std::uint64_t batchSize = 0; // Operations per sample
+		std::uint64_t items = 0; // Items processed by one operation
+		double medianNs = 0.0, meanNs = 0.0, minNs = 0.0, maxNs = 0.0, stddevNs = 0.0; // Per operation
+	};
+
+	class Context final {
+	public:
+		Context(std::string_view name, std::uint32_t seed, std::uint32_t samples, double minBatchMs);
+
+		// Times `op`, `items` is how many elements one call processes and only affects reporting
+		template<class Fn>
+		void run(Fn&& op, std::uint64_t items = 1) {
+			run_impl([&op](std::uint64_t count) { for (std::uint64_t i = 0; i < count; ++i) op(); }, items);
+		}
+
+		inline std::uint32_t seed() const { return mSeed; }
+		inline std::vector<Result> const& results() const { return mResults; }
+	private:
+		void run_impl(std::function<void(std::uint64_t)> const& batch, std::uint64_t items);
+
+		std::string mName;
+		std::uint32_t mSeed;
+		std::uint32_t mSamples;
+		double mMinBatchMs;
+		std::vector<Result> mResults;
+	};
+
+	using BenchmarkFn = void(*)(Context&);
+
+	struct Registration final {
+		Registration(char const* name, BenchmarkFn fn);
+	};
+}
+
+#define VP_BENCH_CONCAT_IMPL(a, b) a##b
+#define VP_BENCH_CONCAT(a, b) VP_BENCH_CONCAT_IMPL(a, b)
+#define VP_BENCHMARK(name, ...) static ::vulpengine::bench::Registration const VP_BENCH_CONCAT(gBenchmark, __LINE__){ name, __VA_ARGS__ }
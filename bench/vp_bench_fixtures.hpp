@@ -0,0 +1,97 @@
+#pragma once
+
+/*!
+Repeatable inputs for the benchmarks, everything is generated from the run's seed.
+*/
+
+#include "vulpengine/vp_features.hpp"
+#include "vulpengine/vp_transform.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace vulpengine::bench {
+	using Random = std::mt19937;
+
+	inline std::vector<std::byte> random_bytes(Random& random, std::size_t size) {
+		std::vector<std::byte> bytes(size);
+		std::uniform_int_distribution<int> distribution(0, 255);
+		for (std::byte& byte : bytes) byte = static_cast<std::byte>(distribution(random));
+		return bytes;
+	}
+
+	// Names shaped like the uniforms found in shaders, "uLights[3].color" and so on
+	inline std::vector<std::string> uniform_names(Random& random, std::size_t count) {
+		static char const* const kStems[] = { "uModel", "uView", "uProjection", "uTime", "uColor", "uAlbedo", "uNormal", "uRoughness", "uLights", "uShadowMap", "uBones", "uExposure" };
+		static char const* const kFields[] = { "position", "color", "radius", "intensity" };
+
+		std::vector<std::string> names;
+		names.reserve(count);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			std::string name = kStems[random() % std::size(kStems)];
+			name += '[' + std::to_string(i) + "]." + kFields[random() % std::size(kFields)];
+			names.push_back(std::move(name));
+		}
+
+		return names;
+	}
+
+#ifdef VP_HAS_GLM
+	struct Aabb final {
+		glm::vec3 min, max;
+	};
+
+	// Boxes scattered in a cube of half size `extent` around the origin
+	inline std::vector<Aabb> random_aabbs(Random& random, std::size_t count, float extent) {
+		std::uniform_real_distribution<float> position(-extent, extent);
+		std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+		std::vector<Aabb> aabbs(count);
+		for (Aabb& aabb : aabbs) {
+			aabb.min = { position(random), position(random), position(random) };
+			aabb.max = aabb.min + glm::vec3(size(random), size(random), size(random));
+		}
+
+		return aabbs;
+	}
+
+	inline Transform random_transform(Random& random) {
+		std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+		glm::vec3 rotationAxis(axis(random), axis(random), axis(random));
+		if (glm::dot(rotationAxis, rotationAxis) < 1e-4f) rotationAxis = { 0.0f, 1.0f, 0.0f };
+
+		Transform transform;
+		transform.position = { position(random), position(random), position(random) };
+		transform.orientation = glm::angleAxis(angle(random), glm::normalize(rotationAxis));
+		transform.scale = glm::vec3(scale(random));
+		return transform;
+	}
+
+	// Parents always come before their children
+	struct Hierarchy final {
+		std::vector<Transform> locals;
+		std::vector<std::int32_t> parents; // -1 for roots
+	};
+
+	inline Hierarchy random_hierarchy(Random& random, std::size_t count, std::size_t roots) {
+		Hierarchy hierarchy;
+		hierarchy.locals.reserve(count);
+		hierarchy.parents.reserve(count);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			hierarchy.locals.push_back(random_transform(random));
+			hierarchy.parents.push_back(i < roots ? -1 : static_cast<std::int32_t>(random() % i));
+		}
+
+		return hierarchy;
+	}
+#endif
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+/*!
+A read only pack of asset files, memory mapped as a whole.
+
+The index is an array of path hashes sorted for binary search that is used in place,
+opening an archive only validates it. Entries start on 64 byte boundaries so a view can be
+handed straight to a buffer upload. Entries that shrink by at least an eighth are stored
+compressed with an LZ4 style block codec, those can't be viewed and are read into a caller
+buffer instead.
+
+Paths are stored normalized, see `archive_path`. Archives are written by `ArchiveBuilder`
+or the `vp_pack` tool and are little endian only.
+
+Needs Improvment:
+1. Large entries are compressed as a single block, they can't be streamed.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulpengine::experimental {
+	namespace lz {
+		// Worst case compressed size of `size` bytes
+		constexpr std::size_t compress_bound(std::size_t size) { return size + size / 255 + 16; }
+
+		// Returns the compressed size, 0 if `output` is too small
+		std::size_t compress(std::span<std::byte const> input, std::span<std::byte> output);
+
+		// Fails on malformed input or if the decompressed size isn't exactly `output.size()`
+		bool decompress(std::span<std::byte const> input, std::span<std::byte> output);
+	}
+
+	// Forward slashes, no `.` or `..` parts, absolute paths made relative to the working directory
+	std::string archive_path(std::filesystem::path const& path);
+
+	class Archive final {
+	public:
+		struct Entry final {
+			std::string_view path;
+			std::uint64_t size = 0;
+			bool compressed = false;
+		};
+
+		Archive() noexcept;
+		Archive(std::filesystem::path const& path);
+		Archive(Archive const&) = delete;
+		Archive& operator=(Archive const&) = delete;
+		Archive(Archive&&) noexcept;
+		Archive& operator=(Archive&&) noexcept;
+		~Archive() noexcept;
+
+		// `path` is expected to be normalized already
+		std::optional<std::size_t> find(std::string_view path) const;
+
+		std::size_t entry_count() const;
+		Entry entry(std::size_t index) const;
+
+		// Points into the mapped file, empty for compressed entries
+		std::span<std::byte const> view(std::size_t index) const;
+
+		// `output` must be exactly the size of the entry
+		bool read(std::size_t index, std::span<std::byte> output) const;
+
+		inline explicit operator bool() const { return mImpl != nullptr; }
+		inline bool valid() const { return mImpl != nullptr; }
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> mImpl;
+	};
+
+	class ArchiveBuilder final {
+	public:
+		// Adding a path twice replaces the earlier data
+		void add(std::filesystem::path const& path, std::span<std::byte const> data, bool compress = true);
+
+		// Stored under its own path, relative to the working directory
+		bool add_file(std::filesystem::path const& file, bool compress = true);
+
+		bool write(std::filesystem::path const& path) const;
+
+		inline std::size_t entry_count() const { return mEntries.size(); }
+	private:
+		struct Pending final {
+			std::string path;
+			std::uint64_t size = 0;
+			std::vector<std::byte> stored;
+			bool compressed = false;
+		};
+
+		std::vector<Pending> mEntries;
+	};
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+/*!
+A cache of GL assets shared by everything that loads them.
+
+Assets are keyed by their path, canonical for loose files and normalized for archived ones
+(see `archive_path`), and the parameters they were built with. Asking for the same one twice,
+while it's loading or after, returns the same handle and adds a reference. Handles are an
+index and a generation, a handle to a released asset gets `nullptr` from `get` rather than
+whatever took its slot.
+
+Textures load in the background: the file is read on the I/O thread and decoded on a job
+worker, the GL object is created in `update`. Shaders are built right away. An asset whose
+last reference is released is destroyed `deletionDelay` frames later, so GPU work already
+submitted can still use it. Reloads, by hand or from a changed file, swap the new version
+in under the same handle and retire the old one the same way.
+
+```cpp
+AssetCache assets;
+AssetHandle<Texture> albedo = assets.texture("textures/brick.png", { .srgb = true });
+AssetHandle<ShaderProgram> shader = assets.shader("shaders/lit.glsl");
+
+// Every frame, on the GL thread
+assets.update();
+if (Texture const* texture = assets.get(albedo)) texture->bind(0);
+```
+
+Use a cache from the GL thread only.
+
+Needs Improvment:
+1. Shader reloads only watch the program file, not its includes, a ShaderLibrary does.
+2. Handles are released by hand, there's no owning handle type.
+*/
+
+#include "vulpengine/experimental/vp_ogl.hpp"
+
+#if defined(VP_HAS_SHADER_PROGRAM) && defined(VP_HAS_STB_IMAGE)
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace vulpengine::experimental {
+	template<class T>
+	struct AssetHandle final {
+		std::uint32_t index = 0;
+		std::uint32_t generation = 0; // Never 0 for a handle the cache gave out
+
+		inline explicit operator bool() const { return generation != 0; }
+		inline bool valid() const { return generation != 0; }
+		friend bool operator==(AssetHandle const&, AssetHandle const&) = default;
+	};
+
+	class AssetCache final {
+	public:
+		enum class State {
+			kLoading,
+			kReady,
+			kFailed,
+			kReleased // Also for handles the cache never gave out
+		};
+
+		struct CreateInfo final {
+			char const* includePath = "./";
+			char const* cacheDirectory = nullptr; // Program binary cache, see ShaderProgram::CreateInfo
+			std::uint32_t deletionDelay = 2; // Frames, at least the number of frames in flight
+			bool watch = true; // Reload assets whose loose file changed on disk
+			double watchInterval = 0.5; // Seconds between checks
+		};
+
+		struct TextureInfo final {
+			bool flip = true;
+			bool srgb = false;
+			bool mipmaps = true;
+			GLint minFilter = GL_LINEAR_MIPMAP_LINEAR; // Without mipmaps a mipmap filter falls back to GL_LINEAR
+			GLint magFilter = GL_LINEAR;
+			GLint wrap = GL_REPEAT;
+			GLfloat anisotropy = 1.0f;
+
+			friend bool operator==(TextureInfo const&, TextureInfo const&) = default;
+		};
+
+		AssetCache();
+		AssetCache(CreateInfo const& info);
+		AssetCache(AssetCache const&) = delete;
+		AssetCache& operator=(AssetCache const&) = delete;
+		AssetCache(AssetCache&&) noexcept;
+		AssetCache& operator=(AssetCache&&) noexcept;
+		// Waits for loads in flight, destroys every asset right away
+		~AssetCache() noexcept;
+
+		// Each call adds a reference, balance it with `release`
+		AssetHandle<Texture> texture(std::filesystem::path const& path, TextureInfo const& info);
+		inline AssetHandle<Texture> texture(std::filesystem::path const& path) { return texture(path, TextureInfo{}); }
+		AssetHandle<ShaderProgram> shader(std::filesystem::path const& path, std::span<std::string_view const> defines = {});
+
+		void retain(AssetHandle<Texture> handle);
+		void retain(AssetHandle<ShaderProgram> handle);
+		void release(AssetHandle<Texture> handle);
+		void release(AssetHandle<ShaderProgram> handle);
+
+		// nullptr until the asset is ready, if it failed or if the handle was released.
+		// During a reload the previous version is returned until the new one is ready.
+		// The pointer stays valid while the cache lives and follows reloads, once the handle
+		// is released its slot may be reused for another asset.
+		Texture const* get(AssetHandle<Texture> handle) const;
+		ShaderProgram const* get(AssetHandle<ShaderProgram> handle) const;
+
+		State state(AssetHandle<Texture> handle) const;
+		State state(AssetHandle<ShaderProgram> handle) const;
+
+		void reload(AssetHandle<Texture> handle);
+		void reload(AssetHandle<ShaderProgram> handle);
+
+		// Call once per frame on the GL thread. Finishes loads and reloads, destroys released
+		// assets whose delay is over and checks watched files. Returns how many loads finished.
+		std::size_t update();
+
+		// Loads and reloads not finished yet
+		std::size_t loading() const;
+
+		inline explicit operator bool() const { return mImpl != nullptr; }
+		inline bool valid() const { return mImpl != nullptr; }
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> mImpl;
+	};
+}
+
+#endif // VP_HAS_SHADER_PROGRAM && VP_HAS_STB_IMAGE
@@ -0,0 +1,85 @@
+#pragma once
+
+/*!
+Batched asynchronous file reads.
+
+Reads are queued with `read` into buffers the caller owns and issued together by `submit`.
+On Linux they go through io_uring, a batch is one syscall. Big reads are split into chunks
+so several are in flight at once, which is what keeps an NVMe drive busy. Without io_uring
+(other platforms, kernels before 5.6, or sandboxes that block it) a small thread pool does
+the reads instead, with the same interface. If io_uring itself fails later, the reads in flight
+complete as failed and the reader carries on with the thread pool.
+
+```cpp
+aio::Reader reader;
+for (std::size_t i = 0; i < paths.size(); ++i)
+	reader.read(paths[i], buffers[i], i);
+reader.submit();
+
+std::vector<aio::Completion> completions;
+while (reader.pending()) {
+	completions.clear();
+	reader.wait(completions);
+	for (aio::Completion const& completion : completions) { ... }
+}
+```
+
+A reader is used from one thread at a time. `tasks::read_file` batches loose file reads through one.
+
+Needs Improvment:
+1. Files are opened on the submitting thread, io_uring could open them too.
+2. The Windows build always uses the thread pool, IoRing or IOCP would do better.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace vulpengine::experimental::aio {
+	struct Completion final {
+		std::uint64_t user = 0;
+		std::size_t bytes = 0; // Less than the buffer if the file ended first
+		bool ok = false; // False if the file couldn't be opened or read
+	};
+
+	class Reader final {
+	public:
+		struct CreateInfo final {
+			std::uint32_t queueDepth = 64; // Chunks in flight at once
+			std::uint32_t chunkSize = 512 * 1024;
+			std::uint32_t fallbackThreads = 4;
+			bool forceFallback = false; // Use the thread pool even where io_uring works
+		};
+
+		Reader();
+		Reader(CreateInfo const& info);
+		Reader(Reader const&) = delete;
+		Reader& operator=(Reader const&) = delete;
+		Reader(Reader&&) noexcept;
+		Reader& operator=(Reader&&) noexcept;
+		// Waits for reads in flight, their buffers may still be written to
+		~Reader() noexcept;
+
+		// Reads `output.size()` bytes from `offset`, `output` must stay alive until the read completes
+		void read(std::filesystem::path const& path, std::span<std::byte> output, std::uint64_t user, std::uint64_t offset = 0);
+
+		// Issues everything queued since the last submit
+		void submit();
+
+		// Appends finished reads, blocking until at least `min` finished or nothing is pending.
+		// Returns how many were appended.
+		std::size_t wait(std::vector<Completion>& completions, std::size_t min = 1);
+		inline std::size_t poll(std::vector<Completion>& completions) { return wait(completions, 0); }
+
+		// Reads queued, in flight or finished but not yet returned by `wait`
+		std::size_t pending() const;
+
+		bool uses_io_uring() const;
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> mImpl;
+	};
+}
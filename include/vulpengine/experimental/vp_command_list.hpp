@@ -0,0 +1,164 @@
+#pragma once
+
+/*!
+Deferred command lists, recorded on any thread and executed on the GL thread.
+
+Commands are small POD records in an arena owned by the list, they refer to engine objects
+through handles from a CommandRegistry. Registering happens on the GL thread, the registry
+must not change while lists are recording. A list is recorded by one thread at a time.
+
+`execute` runs lists in the order they're given, not the order they finished recording,
+so the output doesn't depend on thread timing. `queue_draw` commands are submitted to a
+RenderQueue instead of drawn directly, flush it after executing.
+
+```cpp
+// GL thread
+auto mesh = registry.add(meshObject);
+
+// Workers
+lists[i].reset();
+lists[i].queue_draw({ .mesh = mesh, .program = program, .depth = distance });
+
+// GL thread
+execute_command_lists({ .registry = registry, .lists = lists, .queue = &queue });
+queue.flush();
+```
+*/
+
+#include "vulpengine/experimental/vp_ogl.hpp"
+#include "vulpengine/experimental/vp_mesh.hpp"
+#include "vulpengine/experimental/vp_render_queue.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace vulpengine::experimental {
+	template<class T>
+	struct CommandHandle final {
+		std::uint32_t index = 0xFFFFFFFF;
+
+		inline bool valid() const { return index != 0xFFFFFFFF; }
+	};
+
+	using MeshHandle = CommandHandle<Mesh>;
+	using ProgramHandle = CommandHandle<ShaderProgram>;
+	using ComputeHandle = CommandHandle<ComputeProgram>;
+	using TextureHandle = CommandHandle<Texture>;
+	using BufferHandle = CommandHandle<Buffer>;
+
+	// Objects must outlive every list referring to them
+	class CommandRegistry final {
+	public:
+		MeshHandle add(Mesh const& mesh);
+		ProgramHandle add(ShaderProgram const& program);
+		ComputeHandle add(ComputeProgram const& program);
+		TextureHandle add(Texture const& texture);
+		BufferHandle add(Buffer const& buffer);
+
+		inline Mesh const& get(MeshHandle handle) const { return *mMeshes[handle.index]; }
+		inline ShaderProgram const& get(ProgramHandle handle) const { return *mPrograms[handle.index]; }
+		inline ComputeProgram const& get(ComputeHandle handle) const { return *mComputePrograms[handle.index]; }
+		inline Texture const& get(TextureHandle handle) const { return *mTextures[handle.index]; }
+		inline Buffer const& get(BufferHandle handle) const { return *mBuffers[handle.index]; }
+
+		void clear();
+	private:
+		std::vector<Mesh const*> mMeshes;
+		std::vector<ShaderProgram const*> mPrograms;
+		std::vector<ComputeProgram const*> mComputePrograms;
+		std::vector<Texture const*> mTextures;
+		std::vector<Buffer const*> mBuffers;
+	};
+
+	class CommandList final {
+	public:
+		enum class Type : std::uint16_t {
+			kUseProgram,
+			kBindTexture,
+			kBindBufferBase,
+			kUniformUint,
+			kUniformFloats,
+			kDraw,
+			kQueueDraw,
+			kDispatch,
+			kMemoryBarrier,
+		};
+
+		struct QueueDrawInfo final {
+			MeshHandle mesh;
+			ProgramHandle program;
+			RenderQueue::MaterialHandle material = 0;
+			float depth = 0.0f;
+			std::uint8_t layer = 0;
+			bool translucent = false;
+			std::uint32_t drawId = 0;
+			GLsizei count = 0;
+		};
+
+		CommandList() noexcept = default;
+		CommandList(CommandList const&) = delete;
+		CommandList& operator=(CommandList const&) = delete;
+		CommandList(CommandList&&) noexcept = default;
+		CommandList& operator=(CommandList&&) noexcept = default;
+		~CommandList() noexcept = default;
+
+		// Uniform commands apply to the program last used in this list, dispatching unsets it
+		void use_program(ProgramHandle program);
+		void bind_texture(GLuint unit, TextureHandle texture);
+		void bind_buffer_base(GLenum target, GLuint index, BufferHandle buffer);
+		void uniform(GLint location, std::uint32_t value);
+
+		// Up to 16 floats, `components` is 1-4 for float-vec4 and 16 for mat4
+		void uniform(GLint location, std::span<float const> values, int components);
+
+		void draw(MeshHandle mesh, GLsizei count = 0);
+		void queue_draw(QueueDrawInfo const& info);
+		void dispatch(ComputeHandle program, GLuint x, GLuint y = 1, GLuint z = 1);
+		void memory_barrier(Barrier barriers);
+
+		// Keeps the arena memory for reuse
+		void reset();
+
+		inline std::size_t size() const { return mCount; }
+		inline bool empty() const { return mCount == 0; }
+	private:
+		friend struct CommandListExecutor;
+
+		struct Header final {
+			Type type;
+			std::uint16_t size; // Including the header
+		};
+
+		struct Block final {
+			std::unique_ptr<std::byte[]> data;
+			std::size_t used = 0;
+		};
+
+		template<class T>
+		void record(Type type, T const& command);
+		void record(Type type, void const* command, std::size_t size, void const* extra, std::size_t extraSize);
+
+		std::vector<Block> mBlocks;
+		std::size_t mCurrent = 0;
+		std::size_t mCount = 0;
+		bool mHasProgram = false;
+	};
+
+	struct CommandExecuteInfo final {
+		CommandRegistry const& registry;
+		std::span<CommandList const> lists;
+
+		// Required if any list has `queue_draw` commands
+		RenderQueue* queue = nullptr;
+	};
+
+	// Call on the GL thread once every list has finished recording
+	void execute_command_lists(CommandExecuteInfo const& info);
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
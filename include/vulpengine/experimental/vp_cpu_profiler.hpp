@@ -0,0 +1,87 @@
+#pragma once
+
+/*!
+CPU zone profiling without Tracy, exported as Chrome trace event JSON.
+Open the file in Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+Each thread writes finished zones into its own fixed size ring, no locks are taken on
+that path. `collect` drains every ring into the collector, call it regularly (once per frame)
+or zones are dropped when a ring fills up. `write_chrome_trace` collects and writes everything
+gathered since the last write.
+
+Recording is off by default and can be switched at runtime, a disabled zone costs one atomic load.
+Without Tracy `VP_PROFILE_CPU`, `VP_PROFILE_CPU_N` and `VP_PROFILE_FRAME` record here.
+Zone names must outlive the profiler, string literals are expected.
+*/
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+
+// The TSC is far cheaper to read than steady_clock, it's converted when the trace is written
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <intrin.h>
+#	define VP_PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#	define VP_PROFILER_RDTSC
+#endif
+
+namespace vulpengine::experimental::profiler {
+	namespace detail {
+		extern std::atomic_bool gEnabled;
+
+		void record(char const* name, std::int64_t begin, std::int64_t end);
+
+		inline std::int64_t steady_now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Ticks, only steady_clock nanoseconds without VP_PROFILER_RDTSC
+		inline std::int64_t now() {
+#ifdef VP_PROFILER_RDTSC
+			return static_cast<std::int64_t>(__rdtsc());
+#else
+			return steady_now();
+#endif
+		}
+	}
+
+	class Zone final {
+	public:
+		inline explicit Zone(char const* name) {
+			if (!detail::gEnabled.load(std::memory_order_relaxed)) return;
+			mName = name;
+			mBegin = detail::now();
+		}
+
+		inline ~Zone() noexcept {
+			if (mName) detail::record(mName, mBegin, detail::now());
+		}
+
+		Zone(Zone const&) = delete;
+		Zone& operator=(Zone const&) = delete;
+	private:
+		char const* mName = nullptr;
+		std::int64_t mBegin = 0;
+	};
+
+	void set_enabled(bool enabled);
+	inline bool enabled() { return detail::gEnabled.load(std::memory_order_relaxed); }
+
+	// Shown as the thread name in the trace
+	void set_thread_name(char const* name);
+
+	// Marks a frame boundary on the calling thread
+	void frame();
+
+	// Returns the number of zones drained
+	std::size_t collect();
+
+	// Writes everything collected since the last write, then discards it
+	bool write_chrome_trace(char const* path);
+
+	// Zones lost to full rings since startup
+	std::uint64_t dropped();
+}
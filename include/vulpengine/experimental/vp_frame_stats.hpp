@@ -0,0 +1,136 @@
+#pragma once
+
+/*!
+Frame timing with percentiles, histograms and hitch detection.
+
+`frame` is called once per frame, the time between calls is the frame time.
+While a FrameStats is active `Window::swap_buffers` reports how long it blocked,
+the rest of the frame is CPU time. GPU time comes from a GpuProfiler if one is given,
+it lags a few frames behind.
+
+The last `capacity` frames are kept in a ring and binned into histograms as they arrive,
+a snapshot reads percentiles from the histograms without sorting anything. Bins are log
+spaced, about 2% wide at any frame time, so a 500 ms hitch is measured as well as a 5 ms frame.
+Frames over the hitch threshold are kept in a separate list until cleared.
+
+```cpp
+vulpengine::experimental::FrameStats stats({ .hitchThresholdMs = 25.0 });
+stats.make_active();
+
+while (!window.should_close()) {
+	...
+	window.swap_buffers();
+	stats.frame();
+}
+
+auto snapshot = stats.snapshot();
+VP_LOG_INFO("p99 {}ms", snapshot.frame.p99);
+```
+*/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vulpengine::experimental {
+	class GpuProfiler;
+
+	class FrameStats final {
+	public:
+		enum class Metric : std::uint8_t {
+			kFrame, // Between `frame` calls
+			kCpu,   // Frame minus swap
+			kSwap,
+			kGpu,
+			kCount
+		};
+
+		// The first bin holds everything under kHistogramMinMs, then kHistogramBinsPerOctave bins
+		// per doubling up to kHistogramMaxMs, the last bin holds everything above
+		static constexpr double kHistogramMinMs = 0.0625;
+		static constexpr std::size_t kHistogramBinsPerOctave = 32;
+		static constexpr std::size_t kHistogramOctaves = 18;
+		static constexpr double kHistogramMaxMs = kHistogramMinMs * (1 << kHistogramOctaves); // ~16 s
+		static constexpr std::size_t kHistogramBins = kHistogramBinsPerOctave * kHistogramOctaves + 2;
+
+		struct CreateInfo final {
+			std::uint32_t capacity = 1024;
+			double hitchThresholdMs = 33.3;
+
+			// Also a hitch if the frame took this many times the median, 0 to disable
+			double hitchMedianFactor = 0.0;
+
+			GpuProfiler const* gpu = nullptr;
+		};
+
+		struct Percentiles final {
+			double p50 = 0.0, p95 = 0.0, p99 = 0.0;
+			double max = 0.0;
+			double average = 0.0;
+		};
+
+		struct Snapshot final {
+			Percentiles frame, cpu, swap, gpu;
+			std::uint32_t frames = 0;
+			std::uint64_t totalFrames = 0;
+			std::uint64_t hitches = 0;
+		};
+
+		struct Hitch final {
+			std::uint64_t frame;
+			double frameMs, cpuMs, swapMs, gpuMs;
+		};
+
+		FrameStats() noexcept = default;
+		FrameStats(CreateInfo const& info);
+		FrameStats(FrameStats const&) = delete;
+		FrameStats& operator=(FrameStats const&) = delete;
+		~FrameStats() noexcept;
+
+		void frame();
+
+		// Called by Window::swap_buffers on the active instance
+		void begin_swap();
+		void end_swap();
+
+		Snapshot snapshot() const;
+		Percentiles percentiles(Metric metric) const;
+		inline std::span<std::uint32_t const> histogram(Metric metric) const { return mHistograms[std::size_t(metric)]; }
+
+		// Where a histogram bin starts, the next bin's start is where it ends
+		static double bin_lower_ms(std::size_t bin);
+
+		inline std::span<Hitch const> hitches() const { return mHitches; }
+		inline void clear_hitches() { mHitches.clear(); }
+
+		void make_active();
+		static FrameStats* active();
+	private:
+		using Clock = std::chrono::steady_clock;
+		using Sample = std::array<double, std::size_t(Metric::kCount)>;
+
+		static std::size_t bin(double ms);
+
+		std::uint32_t mCapacity = 0;
+		double mHitchThresholdMs = 0.0;
+		double mHitchMedianFactor = 0.0;
+		GpuProfiler const* mGpu = nullptr;
+
+		std::vector<Sample> mSamples;
+		std::uint32_t mNext = 0;
+		std::uint32_t mCount = 0;
+		std::uint64_t mTotalFrames = 0;
+		std::uint64_t mTotalHitches = 0;
+
+		std::array<std::array<std::uint32_t, kHistogramBins>, std::size_t(Metric::kCount)> mHistograms{};
+		Sample mSums{};
+
+		Clock::time_point mLastFrame;
+		Clock::time_point mSwapBegin;
+		double mSwapMs = 0.0;
+
+		std::vector<Hitch> mHitches;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/*!
+Accounting of the GPU memory allocated through the vp_ogl wrappers.
+
+Buffer, Texture and Renderbuffer report their storage size when created and deleted.
+Texture sizes are computed from the internal format, levels and dimensions, formats
+missing from the table are asked from the driver. Drivers pad and compress allocations
+so these are the sizes requested, not what the driver actually uses.
+
+Totals are kept per category and per label with high-water marks. Objects still alive
+when `entry_uninit` runs are reported as leaks.
+*/
+
+#include <glad/gl.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulpengine::experimental::gpumemory {
+	enum class Category : std::uint8_t {
+		kBuffer,
+		kTexture,
+		kRenderbuffer,
+		kCount
+	};
+
+	struct Totals final {
+		std::uint64_t bytes = 0;
+		std::uint64_t peakBytes = 0;
+		std::uint32_t objects = 0;
+	};
+
+	struct LabelTotals final {
+		std::string label;
+		Category category;
+		Totals totals;
+	};
+
+	void track(Category category, GLuint handle, std::uint64_t bytes, std::string_view label);
+	void untrack(Category category, GLuint handle);
+
+	// Size of the storage allocated by glTextureStorage*
+	std::uint64_t texture_size(GLuint texture, GLenum target, GLenum internalFormat, GLsizei levels, GLsizei width, GLsizei height, GLsizei depth);
+	std::uint64_t renderbuffer_size(GLuint renderbuffer, GLenum internalFormat, GLsizei width, GLsizei height);
+
+	Totals totals(Category category);
+	Totals total();
+
+	// Sorted by size, largest first
+	std::vector<LabelTotals> by_label();
+
+	// Logs a warning whenever the total crosses `bytes`, 0 disables
+	void set_budget(std::uint64_t bytes);
+	bool over_budget();
+
+	// Logs every tracked object, returns how many there were
+	std::size_t report_leaks();
+
+	char const* to_string(Category category);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+/*!
+GPU timings with timestamp queries, doesn't need Tracy.
+
+Zones write a timestamp when they begin and end. Every frame has its own set of queries
+in a ring `latency` frames deep, results are read once available so nothing stalls.
+Frames the GPU hasn't finished when their slot comes around again are dropped.
+
+Zones form a tree per frame. Each zone is identified by its name and parent, its
+rolling average, min and max are kept across frames. Names must outlive the profiler,
+string literals are expected.
+
+Without Tracy `VP_PROFILE_GPU` and `VP_PROFILE_FRAME` use the active profiler.
+```cpp
+vulpengine::experimental::GpuProfiler profiler({});
+profiler.make_active();
+
+{
+	VP_PROFILE_GPU_N("Shadows");
+	...
+}
+
+VP_PROFILE_FRAME;
+```
+*/
+
+#include <glad/gl.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vulpengine::experimental {
+	class GpuProfiler final {
+	public:
+		struct CreateInfo final {
+			std::uint32_t latency = 4;
+			std::uint32_t maxZones = 256;
+
+			// Weight of the newest frame in the rolling averages
+			double smoothing = 0.05;
+		};
+
+		// Flattened in depth first order, `parent` is an index into the same list
+		struct ZoneStats final {
+			char const* name;
+			std::uint32_t depth;
+			std::uint32_t parent;
+			double lastMs;
+			double averageMs;
+			double minMs;
+			double maxMs;
+		};
+
+		class Zone final {
+		public:
+			inline Zone(GpuProfiler* profiler, char const* name) : mProfiler(profiler) { if (mProfiler) mProfiler->begin_zone(name); }
+			inline ~Zone() noexcept { if (mProfiler) mProfiler->end_zone(); }
+			Zone(Zone const&) = delete;
+			Zone& operator=(Zone const&) = delete;
+		private:
+			GpuProfiler* mProfiler;
+		};
+
+		GpuProfiler() noexcept = default;
+		GpuProfiler(CreateInfo const& info);
+		GpuProfiler(GpuProfiler const&) = delete;
+		GpuProfiler& operator=(GpuProfiler const&) = delete;
+		inline GpuProfiler(GpuProfiler&& other) noexcept { *this = std::move(other); }
+		GpuProfiler& operator=(GpuProfiler&& other) noexcept;
+		~GpuProfiler() noexcept;
+
+		void begin_zone(char const* name);
+		void end_zone();
+
+		// Call once per frame after the last zone, usually right after swapping buffers
+		void frame();
+
+		// The most recent frame the GPU finished
+		inline std::span<ZoneStats const> zones() const { return mResolved; }
+		inline double frame_ms() const { return mFrameMs; }
+		inline double average_frame_ms() const { return mAverageFrameMs; }
+		inline std::uint64_t dropped_frames() const { return mDroppedFrames; }
+
+		// Zone tree of the most recent frame as JSON
+		std::string to_json() const;
+		bool write_json(char const* path) const;
+
+		// Used by VP_PROFILE_GPU when Tracy isn't available
+		void make_active();
+		static GpuProfiler* active();
+
+		inline bool valid() const { return !mFrames.empty(); }
+	private:
+		struct RecordedZone final {
+			char const* name;
+			std::uint32_t parent;
+			std::uint32_t depth;
+			std::uint32_t begin;
+			std::uint32_t end;
+		};
+
+		struct Frame final {
+			std::vector<GLuint> queries;
+			std::vector<RecordedZone> zones;
+			bool pending = false;
+		};
+
+		struct Accumulator final {
+			double averageMs = 0.0;
+			double minMs = 0.0;
+			double maxMs = 0.0;
+			bool initialized = false;
+		};
+
+		bool resolve(Frame& frame);
+		double accumulate(Accumulator& accumulator, double ms) const;
+
+		std::vector<Frame> mFrames;
+		std::uint32_t mCurrent = 0;
+		std::uint32_t mMaxZones = 0;
+		double mSmoothing = 0.05;
+
+		// Zones past `maxZones` are pushed as kSkipped so their end is ignored
+		std::vector<std::uint32_t> mStack;
+
+		std::vector<ZoneStats> mResolved;
+		std::unordered_map<std::uint64_t, Accumulator> mAccumulators;
+		Accumulator mFrameAccumulator;
+		double mFrameMs = 0.0;
+		double mAverageFrameMs = 0.0;
+		std::uint64_t mDroppedFrames = 0;
+	};
+}
@@ -3,6 +3,9 @@
 /*!
 A wrapper around an stb_image allocated image
 
+Files are read through the virtual filesystem, so they can come from a mounted archive.
+`load_image` reads on the I/O thread and decodes on a job worker.
+
 Needs Improvment:
 1. Needs more documentation.
 
@@ -13,7 +16,12 @@ Needs Improvment:
 
 #ifdef VP_HAS_STB_IMAGE
 
+#include "vulpengine/experimental/vp_task.hpp"
+
+#include <cstddef>
+#include <filesystem>
 #include <utility>
+#include <span>
 #include <string>
 
 namespace vulpengine::experimental {
@@ -22,6 +30,8 @@ namespace vulpengine::experimental {
 		constexpr Image() noexcept = default;
 		Image(char const* filename, bool flip = true);
 		Image(std::string const& filename, bool flip = true);
+		// An encoded image already in memory, eg. a view from an archive
+		Image(std::span<std::byte const> encoded, bool flip = true);
 		Image(Image const&) = delete;
 		Image& operator=(Image const&) = delete;
 		inline Image(Image&& other) noexcept { *this = std::move(other); }
@@ -38,6 +48,9 @@ namespace vulpengine::experimental {
 		int mHeight = 0;
 		void* mPixels = nullptr;
 	};
+
+	// An invalid image if the file couldn't be read or decoded
+	Task<Image> load_image(std::filesystem::path path, bool flip = true);
 }
 
 #endif // VP_HAS_STB_IMAGE
\ No newline at end of file
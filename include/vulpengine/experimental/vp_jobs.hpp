@@ -0,0 +1,191 @@
+#pragma once
+
+/*!
+A work stealing job system.
+
+Every worker, and the thread that called `init`, owns a Chase-Lev deque: it pushes and pops
+its own jobs from the bottom while idle workers steal from the top. Other threads submit
+through a shared queue. Jobs are counted on a `Counter`, `wait` keeps running jobs on the
+calling thread until the counter reaches zero, so waiting never idles a thread and jobs may
+wait on other jobs. `run_after` defers a job until a counter reaches zero.
+
+Each job runs inside a profiler zone named after it, worker threads are named in traces.
+The first submission starts the workers if `init` wasn't called.
+
+```cpp
+jobs::Counter counter;
+jobs::run(counter, [&] { decode(image); }, "decode");
+jobs::parallel_for(0, transforms.size(), 256, [&](std::size_t first, std::size_t last) { ... });
+jobs::wait(counter);
+```
+
+Needs Improvment:
+1. Deques are a fixed size, a full deque runs the pushed job right away instead of growing.
+2. No job priorities.
+*/
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace vulpengine::experimental::jobs {
+	class Counter;
+
+	namespace detail {
+		struct CounterAccess;
+
+		constexpr std::size_t kJobStorage = 48;
+
+		struct Job final {
+			void(*invoke)(Job& job) = nullptr;
+			Counter* counter = nullptr;
+			char const* name = nullptr;
+			Job* next = nullptr; // Continuation list or free list
+			alignas(std::max_align_t) std::byte storage[kJobStorage];
+		};
+
+		Job* allocate_job();
+		void submit(Job* job);
+		void submit_after(Counter& dependency, Job* job);
+
+		// Callables that don't fit inline are moved to the heap
+		template<class F>
+		Job* make_job(F&& function, Counter* counter, char const* name) {
+			using Function = std::decay_t<F>;
+			Job* job = allocate_job();
+			job->counter = counter;
+			job->name = name;
+
+			if constexpr (sizeof(Function) <= kJobStorage && alignof(Function) <= alignof(std::max_align_t)) {
+				new (job->storage) Function(std::forward<F>(function));
+				job->invoke = [](Job& job) {
+					Function& function = *std::launder(reinterpret_cast<Function*>(job.storage));
+					function();
+					function.~Function();
+				};
+			} else {
+				Function* heap = new Function(std::forward<F>(function));
+				new (job->storage) Function*(heap);
+				job->invoke = [](Job& job) {
+					std::unique_ptr<Function> function(*std::launder(reinterpret_cast<Function**>(job.storage)));
+					(*function)();
+				};
+			}
+
+			return job;
+		}
+	}
+
+	// Jobs still to finish, safe to reuse once it reaches zero
+	class Counter final {
+	public:
+		Counter() noexcept = default;
+		Counter(Counter const&) = delete;
+		Counter& operator=(Counter const&) = delete;
+		inline ~Counter() noexcept { assert(done() && "Counter destroyed with jobs pending"); }
+
+		inline bool done() const { return mPending.load(std::memory_order_acquire) == 0 && !mLock.test(std::memory_order_acquire); }
+		inline std::uint32_t pending() const { return mPending.load(std::memory_order_acquire); }
+	private:
+		friend struct detail::CounterAccess;
+
+		std::atomic<std::uint32_t> mPending = 0;
+		std::atomic_flag mLock;
+		detail::Job* mContinuations = nullptr;
+	};
+
+	struct CreateInfo final {
+		// Defaults to one per hardware thread besides the caller's, with 0 jobs only run in `wait` and `run_one`
+		std::optional<std::uint32_t> workerCount;
+		std::uint32_t dequeCapacity = 4096; // Per thread, rounded up to a power of two
+	};
+
+	// The calling thread becomes the main thread, which takes part in `wait` like every other thread
+	void init(CreateInfo const& info = {});
+
+	// Runs whatever is still queued on the calling thread, then joins the workers
+	void shutdown();
+
+	bool initialized();
+	std::uint32_t worker_count();
+
+	// 0 on the main thread, 1 to worker_count() on workers, kForeignThread elsewhere
+	constexpr std::uint32_t kForeignThread = ~0u;
+	std::uint32_t thread_index();
+
+	// `name` must be a string literal, it names the job's profiler zone
+	template<class F>
+	inline void run(Counter& counter, F&& function, char const* name = "job") {
+		detail::submit(detail::make_job(std::forward<F>(function), &counter, name));
+	}
+
+	template<class F>
+	inline void run(F&& function, char const* name = "job") {
+		detail::submit(detail::make_job(std::forward<F>(function), nullptr, name));
+	}
+
+	// Queued once `dependency` reaches zero, `counter` counts it from now
+	template<class F>
+	inline void run_after(Counter& dependency, Counter& counter, F&& function, char const* name = "job") {
+		detail::submit_after(dependency, detail::make_job(std::forward<F>(function), &counter, name));
+	}
+
+	// Runs other jobs on the calling thread until the counter reaches zero
+	void wait(Counter& counter);
+
+	// Runs one queued job on the calling thread, false if there was none
+	bool run_one();
+
+	namespace detail {
+		// Splits off the upper half of its range as a new job until it's within the grain
+		template<class F>
+		struct ParallelRange final {
+			F* body;
+			Counter* counter;
+			std::size_t first, last, grain;
+			char const* name;
+
+			void operator()() const {
+				std::size_t end = last;
+				while (end - first > grain) {
+					std::size_t const middle = first + (end - first) / 2;
+					submit(make_job(ParallelRange{ body, counter, middle, end, grain, name }, counter, name));
+					end = middle;
+				}
+
+				if constexpr (std::is_invocable_v<F&, std::size_t, std::size_t>) {
+					(*body)(first, end);
+				} else {
+					for (std::size_t i = first; i < end; ++i) (*body)(i);
+				}
+			}
+		};
+	}
+
+	// `body` is called with `(first, last)` chunks or with each index, a grain of 0 picks one
+	// that gives every thread a few chunks. Returns once every index has been processed.
+	template<class F>
+	void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& body, char const* name = "parallel_for") {
+		if (first >= last) return;
+		if (!initialized()) init();
+		if (!grain) grain = std::max<std::size_t>(1, (last - first) / ((worker_count() + 1) * 4));
+
+		Counter counter;
+		detail::ParallelRange<std::remove_reference_t<F>> const range{ &body, &counter, first, last, grain, name };
+
+		if (last - first <= grain) {
+			range();
+			return;
+		}
+
+		run(counter, range, name);
+		wait(counter);
+	}
+}
@@ -22,6 +22,10 @@ Type safe OpenGL wrappers.
 #include <optional>
 #include <variant>
 #include <functional>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
 
 #ifdef VP_LIB_STB_INCLUDE
 #	define VP_HAS_SHADER_PROGRAM
@@ -71,10 +75,15 @@ namespace vulpengine::experimental {
 		void bind(GLuint unit) const;
 		void generate_mips() const;
 
+		// Binds a level for image load/store, `format` defaults to the texture's internal format
+		void bind_image(GLuint unit, GLenum access, GLint level = 0, GLenum format = GL_NONE) const;
+
 		inline operator GLuint() const { return mHandle; }
 		inline GLuint handle() const { return mHandle; }
+		inline GLenum internal_format() const { return mInternalFormat; }
 	private:
 		GLuint mHandle = 0;
+		GLenum mInternalFormat = GL_NONE;
 	};
 
 	class Renderbuffer final {
@@ -115,6 +124,7 @@ namespace vulpengine::experimental {
 		~Buffer() noexcept;
 
 		void bind_base(GLenum target, GLuint index) const;
+		void bind_range(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) const;
 
 		void upload(GLintptr offset, std::span<std::byte const> data) const;
 		void upload(GLintptr offset, GLsizeiptr size, void const* data) const;
@@ -193,16 +203,89 @@ namespace vulpengine::experimental {
 		GLuint mHandle = 0;
 	};
 
+	// Typed glMemoryBarrier bits, combine with `|`
+	enum class Barrier : GLbitfield {
+		kVertexAttribArray = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+		kElementArray = GL_ELEMENT_ARRAY_BARRIER_BIT,
+		kUniform = GL_UNIFORM_BARRIER_BIT,
+		kTextureFetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+		kShaderImageAccess = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+		kCommand = GL_COMMAND_BARRIER_BIT,
+		kPixelBuffer = GL_PIXEL_BUFFER_BARRIER_BIT,
+		kTextureUpdate = GL_TEXTURE_UPDATE_BARRIER_BIT,
+		kBufferUpdate = GL_BUFFER_UPDATE_BARRIER_BIT,
+		kClientMappedBuffer = GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT,
+		kQueryBuffer = GL_QUERY_BUFFER_BARRIER_BIT,
+		kFramebuffer = GL_FRAMEBUFFER_BARRIER_BIT,
+		kTransformFeedback = GL_TRANSFORM_FEEDBACK_BARRIER_BIT,
+		kAtomicCounter = GL_ATOMIC_COUNTER_BARRIER_BIT,
+		kShaderStorage = GL_SHADER_STORAGE_BARRIER_BIT,
+		kAll = GL_ALL_BARRIER_BITS
+	};
+
+	constexpr Barrier operator|(Barrier a, Barrier b) {
+		return static_cast<Barrier>(static_cast<GLbitfield>(a) | static_cast<GLbitfield>(b));
+	}
+
+	// Barrier bits describe how the data written before the barrier is read after it
+	// Eg: a compute pass writing vertices read by a draw needs `Barrier::kVertexAttribArray`
+	void memory_barrier(Barrier barriers);
+	void memory_barrier_by_region(Barrier barriers);
+
 #ifdef VP_HAS_SHADER_PROGRAM
+	// A uniform location resolved once from a ShaderProgram, pushing through it skips the name lookup.
+	// Only valid for the program it was resolved from, `T` should match the GLSL type.
+	template<class T>
+	struct Uniform final {
+		GLint location = -1;
+
+		inline explicit operator bool() const { return location != -1; }
+		inline bool valid() const { return location != -1; }
+	};
+
 	class ShaderProgram final {
 	public:
+		// A member of a uniform or shader storage block, values are in bytes.
+		// Array members are named without the trailing `[0]`.
+		struct BlockMember final {
+			GLenum type = GL_NONE;
+			GLint offset = 0;
+			GLint arraySize = 1;
+			GLint arrayStride = 0;
+			GLint matrixStride = 0;
+			GLint topLevelArrayStride = 0; // Storage blocks only
+		};
+
+		struct Block final {
+			GLint binding = 0;
+			GLint size = 0;
+			UnorderedStringMap<BlockMember> members;
+		};
+
 		struct CreateInfo final {
 			char const* file = nullptr;
 			char const* includePath = "./";
+
+			// Injected as `#define` lines after the stage define, each entry is `NAME` or `NAME value`
+			std::span<std::string_view const> defines;
+
+			// Directory linked program binaries are cached in, `nullptr` disables the cache.
+			// Entries are keyed by the preprocessed sources and the driver,
+			// entries the driver rejects are deleted and the program is rebuilt from source.
+			char const* cacheDirectory = nullptr;
+		};
+
+		// Builds from already preprocessed stage sources, these must include the `#version` line
+		struct SourceInfo final {
+			std::string_view vertex;
+			std::string_view fragment;
+			char const* label = nullptr;
+			char const* cacheDirectory = nullptr;
 		};
 
 		ShaderProgram() noexcept = default;
 		ShaderProgram(CreateInfo const& info);
+		ShaderProgram(SourceInfo const& info);
 		ShaderProgram(ShaderProgram const&) = delete;
 		ShaderProgram& operator=(ShaderProgram const&) = delete;
 		inline ShaderProgram(ShaderProgram&& other) noexcept { *this = std::move(other); }
@@ -211,6 +294,40 @@ namespace vulpengine::experimental {
 
 		void bind() const;
 		GLint get_uniform_location(std::string_view name) const;
+		GLint get_uniform_location(StringId id) const;
+
+		// Returns nullptr if the block isn't active
+		Block const* get_uniform_block(std::string_view name) const;
+		Block const* get_storage_block(std::string_view name) const;
+
+		// Resolve handles once, after creation, then push through them every frame
+		// ```cpp
+		// auto model = program.uniform<glm::mat4>("uModel"_sid);
+		// program.push(model, transform.get());
+		// ```
+		template<class T> inline Uniform<T> uniform(std::string_view name) const { return { get_uniform_location(name) }; }
+		template<class T> inline Uniform<T> uniform(StringId id) const { return { get_uniform_location(id) }; }
+
+		void push(Uniform<int> uniform, int v0) const;
+		void push(Uniform<int> uniform, std::span<int const> v0) const;
+		void push(Uniform<float> uniform, float v0) const;
+		void push(Uniform<float> uniform, std::span<float const> v0) const;
+#ifdef VP_HAS_GLM
+		void push(Uniform<glm::ivec2> uniform, glm::ivec2 const& v0) const;
+		void push(Uniform<glm::ivec2> uniform, std::span<glm::ivec2 const> v0) const;
+		void push(Uniform<glm::ivec3> uniform, glm::ivec3 const& v0) const;
+		void push(Uniform<glm::ivec3> uniform, std::span<glm::ivec3 const> v0) const;
+		void push(Uniform<glm::ivec4> uniform, glm::ivec4 const& v0) const;
+		void push(Uniform<glm::ivec4> uniform, std::span<glm::ivec4 const> v0) const;
+		void push(Uniform<glm::vec2> uniform, glm::vec2 const& v0) const;
+		void push(Uniform<glm::vec2> uniform, std::span<glm::vec2 const> v0) const;
+		void push(Uniform<glm::vec3> uniform, glm::vec3 const& v0) const;
+		void push(Uniform<glm::vec3> uniform, std::span<glm::vec3 const> v0) const;
+		void push(Uniform<glm::vec4> uniform, glm::vec4 const& v0) const;
+		void push(Uniform<glm::vec4> uniform, std::span<glm::vec4 const> v0) const;
+		void push(Uniform<glm::mat4> uniform, glm::mat4 const& v0) const;
+		void push(Uniform<glm::mat4> uniform, std::span<glm::mat4 const> v0) const;
+#endif
 
 		void push_1i(std::string_view name, int v0) const;
 		void push_1i(std::string_view name, int const* v0, int count = 1) const;
@@ -266,8 +383,188 @@ namespace vulpengine::experimental {
 		inline bool valid() const { return mHandle; }
 		inline GLuint handle() const { return mHandle; }
 	private:
+		friend class ShaderCompiler;
+		friend class ComputeProgram;
+		ShaderProgram(GLuint handle, UnorderedStringMap<int>&& uniforms, UnorderedStringMap<Block>&& uniformBlocks, UnorderedStringMap<Block>&& storageBlocks);
+
+		void index_uniforms();
+
 		GLuint mHandle = 0;
 		UnorderedStringMap<int> mActiveUniforms;
+		UnorderedStringMap<Block> mUniformBlocks;
+		UnorderedStringMap<Block> mStorageBlocks;
+		std::vector<std::pair<std::uint64_t, GLint>> mUniformIds; // Sorted by StringId hash
+	};
+
+	// A program with a single compute stage, the file is preprocessed with `#define COMP`.
+	// Uniforms and blocks are reached through `program()`.
+	//
+	// Example Usage:
+	// ```cpp
+	// ComputeProgram cull = {{ .file = "shaders/cull.glsl" }};
+	// instances.bind_base(GL_SHADER_STORAGE_BUFFER, 0);
+	// cull.dispatch_threads(instanceCount);
+	// memory_barrier(Barrier::kShaderStorage | Barrier::kCommand);
+	// ```
+	class ComputeProgram final {
+	public:
+		using CreateInfo = ShaderProgram::CreateInfo;
+
+		ComputeProgram() noexcept = default;
+		ComputeProgram(CreateInfo const& info);
+		ComputeProgram(ComputeProgram const&) = delete;
+		ComputeProgram& operator=(ComputeProgram const&) = delete;
+		ComputeProgram(ComputeProgram&&) noexcept = default;
+		ComputeProgram& operator=(ComputeProgram&&) noexcept = default;
+		~ComputeProgram() noexcept = default;
+
+		// Counts are in work groups
+		void dispatch(GLuint x, GLuint y = 1, GLuint z = 1) const;
+
+		// Counts are in invocations, rounded up to whole work groups
+		void dispatch_threads(GLuint x, GLuint y = 1, GLuint z = 1) const;
+
+		// `offset` points at a `DispatchIndirectCommand { GLuint x, y, z; }` in `buffer`
+		void dispatch_indirect(Buffer const& buffer, GLintptr offset = 0) const;
+
+		inline ShaderProgram const& program() const { return mProgram; }
+		inline std::array<GLint, 3> const& work_group_size() const { return mWorkGroupSize; }
+
+		inline explicit operator bool() const { return mProgram.valid(); }
+		inline bool valid() const { return mProgram.valid(); }
+		inline GLuint handle() const { return mProgram.handle(); }
+	private:
+		ShaderProgram mProgram;
+		std::array<GLint, 3> mWorkGroupSize{};
+	};
+
+	// Builds many shader programs at once without blocking the calling thread.
+	// Preprocessing runs as jobs on the job system, compiling and linking are issued on the GL thread
+	// and left to the driver, with KHR_parallel_shader_compile these run on the driver's threads.
+	//
+	// Example Usage:
+	// ```cpp
+	// ShaderCompiler compiler;
+	// auto ticket = compiler.submit({ .file = "shaders/sky.glsl" });
+	//
+	// // Each frame
+	// compiler.poll();
+	// if (compiler.ready(ticket)) sky = compiler.take(ticket);
+	// ```
+	class ShaderCompiler final {
+	public:
+		struct Ticket final {
+			std::uint32_t index = 0;
+			std::uint32_t generation = 0; // Bumped when the program is taken, older tickets are stale
+
+			friend bool operator==(Ticket const&, Ticket const&) = default;
+		};
+
+		ShaderCompiler();
+		ShaderCompiler(ShaderCompiler const&) = delete;
+		ShaderCompiler& operator=(ShaderCompiler const&) = delete;
+		ShaderCompiler(ShaderCompiler&&) noexcept;
+		ShaderCompiler& operator=(ShaderCompiler&&) noexcept;
+		~ShaderCompiler() noexcept;
+
+		// `info` is copied, the strings don't need to outlive this call
+		[[nodiscard]] Ticket submit(ShaderProgram::CreateInfo const& info);
+		[[nodiscard]] Ticket submit(ShaderProgram::SourceInfo const& info);
+
+		// Advances every build as far as possible without waiting, returns true when nothing is pending
+		bool poll();
+
+		// Blocks until every submitted program has finished
+		void wait();
+
+		bool ready(Ticket ticket) const;
+
+		// Takes ownership of a finished program, failed builds produce an invalid program.
+		// The ticket is stale afterwards, its slot is reused by a later submit.
+		ShaderProgram take(Ticket ticket);
+
+		inline std::size_t pending() const { return mPending; }
+	private:
+		struct Job;
+
+		struct Slot final {
+			std::unique_ptr<Job> job; // Null once taken
+			std::uint32_t generation = 1;
+		};
+
+		Ticket add(std::unique_ptr<Job> job);
+		bool advance(Job& job, bool wait);
+
+		std::vector<Slot> mSlots;
+		std::vector<std::uint32_t> mFreeSlots;
+		std::size_t mPending = 0;
+	};
+
+	// A CPU copy of a uniform or storage block laid out from program introspection.
+	// Writes only touch the copy, `flush` uploads everything that changed as one range.
+	// Values are copied as-is, matrices must match the member's `matrixStride` (eg. no packed mat3 in std140).
+	//
+	// Example Usage:
+	// ```cpp
+	// BlockWriter material = {{ .block = *program.get_uniform_block("Material"), .label = "Brick material" }};
+	// material.set("albedo", glm::vec4(1.0f));
+	//
+	// // Once per frame, before drawing
+	// material.flush();
+	// material.bind(GL_UNIFORM_BUFFER);
+	// ```
+	class BlockWriter final {
+	public:
+		struct CreateInfo final {
+			ShaderProgram::Block const& block;
+			std::string_view label;
+		};
+
+		BlockWriter() noexcept = default;
+		BlockWriter(CreateInfo const& info);
+		BlockWriter(BlockWriter const&) = delete;
+		BlockWriter& operator=(BlockWriter const&) = delete;
+		BlockWriter(BlockWriter&&) noexcept = default;
+		BlockWriter& operator=(BlockWriter&&) noexcept = default;
+		~BlockWriter() noexcept = default;
+
+		// Writes element `index` of `member`, returns false if the member isn't in the block
+		bool set(std::string_view member, void const* data, std::size_t size, GLint index = 0);
+
+		template<class T>
+		inline bool set(std::string_view member, T const& value, GLint index = 0) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			return set(member, &value, sizeof(T), index);
+		}
+
+		template<class T>
+		bool set(std::string_view member, std::span<T const> values) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			for (std::size_t i = 0; i < values.size(); ++i)
+				if (!set(member, &values[i], sizeof(T), static_cast<GLint>(i))) return false;
+			return true;
+		}
+
+		// Raw write at a byte offset into the block
+		void write(GLintptr offset, void const* data, std::size_t size);
+
+		// Uploads the changed range, does nothing if nothing changed
+		void flush();
+
+		// Binds to the binding point reported by introspection
+		void bind(GLenum target) const;
+		void bind(GLenum target, GLuint index) const;
+
+		inline bool dirty() const { return mDirtyBegin < mDirtyEnd; }
+		inline std::span<std::byte const> data() const { return mData; }
+		inline Buffer const& buffer() const { return mBuffer; }
+	private:
+		Buffer mBuffer;
+		std::vector<std::byte> mData;
+		UnorderedStringMap<ShaderProgram::BlockMember> mMembers;
+		GLuint mBinding = 0;
+		std::size_t mDirtyBegin = 0;
+		std::size_t mDirtyEnd = 0;
 	};
 #endif // VP_HAS_SHADER_PROGRAM
 }
\ No newline at end of file
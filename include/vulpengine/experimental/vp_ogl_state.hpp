@@ -0,0 +1,59 @@
+#pragma once
+
+/*!
+Tracks the GL state set through vulpengine and skips calls that wouldn't change anything.
+
+The vp_ogl wrappers go through these functions, code calling GL directly should too.
+Code that changes state behind our back (ImGui backends, other libraries) must be followed
+by `invalidate()`, everything is then assumed unknown and the next call of each kind is issued.
+
+State is tracked per thread, which matches one current context per thread.
+`Window::make_context_current` invalidates it, code switching contexts itself must too.
+Deleting an object through the wrappers forgets it, GL reuses names.
+
+Needs Improvment:
+1. Only the state vulpengine uses is tracked, extend as needed.
+*/
+
+#include <glad/gl.h>
+
+#include <cstdint>
+
+namespace vulpengine::experimental::glstate {
+	struct Stats final {
+		std::uint64_t issued = 0;
+		std::uint64_t elided = 0;
+	};
+
+	void use_program(GLuint program);
+	void bind_vertex_array(GLuint vertexArray);
+
+	// GL_FRAMEBUFFER binds both GL_DRAW_FRAMEBUFFER and GL_READ_FRAMEBUFFER
+	void bind_framebuffer(GLenum target, GLuint framebuffer);
+	void bind_texture_unit(GLuint unit, GLuint texture);
+
+	void bind_buffer(GLenum target, GLuint buffer);
+	void bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+	void bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+	// glEnable/glDisable
+	void set_enabled(GLenum capability, bool enabled);
+	void blend_func(GLenum source, GLenum destination);
+	void blend_equation(GLenum mode);
+	void depth_func(GLenum func);
+	void depth_mask(bool enabled);
+	void cull_face(GLenum mode);
+
+	// Called by the wrappers when an object is deleted
+	void forget_program(GLuint program);
+	void forget_vertex_array(GLuint vertexArray);
+	void forget_framebuffer(GLuint framebuffer);
+	void forget_texture(GLuint texture);
+	void forget_buffer(GLuint buffer);
+
+	// Assume nothing about the current state, use after external code touched GL
+	void invalidate();
+
+	Stats stats();
+	void reset_stats();
+}
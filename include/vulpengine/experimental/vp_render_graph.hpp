@@ -0,0 +1,190 @@
+#pragma once
+
+/*!
+A render graph rebuilt every frame.
+
+Passes declare the virtual resources they create, read and write in a setup callback.
+`execute` culls passes that don't contribute to an imported resource or a pass marked
+with `side_effect`, then runs the rest in declaration order, which is always a valid order
+since a resource can only be used after it's declared.
+
+Transient resources come from a pool kept across frames. A resource is acquired just
+before its first pass and released after its last one, so resources with the same
+description and non-overlapping lifetimes alias the same texture or renderbuffer.
+OpenGL can't place different formats in the same memory, only matching descriptions alias.
+Contents are invalidated when a resource is released.
+
+Framebuffers are cached by attachment set, passes writing attachments get theirs bound
+with the viewport set to the attachment size before the execute callback runs.
+Framebuffers with imported attachments only live for the frame, the graph can't tell
+when an import is deleted and its name reused.
+
+```cpp
+graph.add_pass("Bloom", [&](RenderGraph::Builder& builder) {
+	bright = builder.read(hdr);
+	bloom = builder.write(builder.create({ .width = w / 2, .height = h / 2, .internalFormat = GL_RGBA16F }), GL_COLOR_ATTACHMENT0);
+}, [=](RenderGraph::Context const& context) {
+	context.texture(bright).bind(0);
+	draw_fullscreen();
+});
+graph.execute();
+```
+*/
+
+#include "vulpengine/experimental/vp_ogl.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace vulpengine::experimental {
+	class RenderGraph final {
+	public:
+		using Resource = std::uint32_t;
+
+		struct ResourceInfo final {
+			GLsizei width = 0, height = 0;
+			GLenum internalFormat = GL_NONE;
+			GLsizei levels = 1;
+
+			// Renderbuffers can only be attachments, never read as textures
+			bool renderbuffer = false;
+
+			bool operator==(ResourceInfo const&) const = default;
+		};
+
+		class Builder final {
+		public:
+			Resource create(ResourceInfo const& info, std::string_view label = {});
+			Resource read(Resource resource);
+
+			// `attachment` is a framebuffer attachment or GL_NONE for image/storage writes
+			Resource write(Resource resource, GLenum attachment = GL_NONE);
+
+			// Never cull this pass, for passes with effects the graph can't see
+			void side_effect();
+		private:
+			friend class RenderGraph;
+			Builder(RenderGraph& graph, std::uint32_t pass) : mGraph(graph), mPass(pass) {}
+
+			RenderGraph& mGraph;
+			std::uint32_t mPass;
+		};
+
+		class Context final {
+		public:
+			Texture const& texture(Resource resource) const;
+			Renderbuffer const& renderbuffer(Resource resource) const;
+
+			// 0 if the pass has no attachments or writes the default framebuffer
+			inline GLuint framebuffer() const { return mFramebuffer; }
+		private:
+			friend class RenderGraph;
+			Context(RenderGraph const& graph, GLuint framebuffer) : mGraph(graph), mFramebuffer(framebuffer) {}
+
+			RenderGraph const& mGraph;
+			GLuint mFramebuffer;
+		};
+
+		struct Stats final {
+			std::uint32_t passes = 0;
+			std::uint32_t culledPasses = 0;
+			std::uint32_t transientResources = 0;
+
+			// Textures and renderbuffers actually backing the transient resources this frame
+			std::uint32_t physicalResources = 0;
+			std::uint32_t pooledResources = 0;
+			std::uint32_t framebuffers = 0;
+		};
+
+		using SetupCallback = std::function<void(Builder&)>;
+		using ExecuteCallback = std::function<void(Context const&)>;
+
+		RenderGraph() = default;
+		RenderGraph(RenderGraph const&) = delete;
+		RenderGraph& operator=(RenderGraph const&) = delete;
+		RenderGraph(RenderGraph&&) noexcept = default;
+		RenderGraph& operator=(RenderGraph&&) noexcept = default;
+		~RenderGraph() noexcept = default;
+
+		// Imported resources outlive the frame, passes writing them are never culled
+		Resource import(Texture& texture, std::string_view label = {});
+		Resource import(Renderbuffer& renderbuffer, std::string_view label = {});
+		Resource import_default_framebuffer(GLsizei width, GLsizei height);
+
+		void add_pass(std::string_view name, SetupCallback const& setup, ExecuteCallback execute);
+
+		// Runs the frame and clears every pass and resource, the pool is kept
+		void execute();
+
+		// Pooled resources unused for this many frames are deleted
+		inline void set_pool_lifetime(std::uint32_t frames) { mPoolLifetime = frames; }
+		inline Stats const& stats() const { return mStats; }
+	private:
+		struct PooledResource final {
+			ResourceInfo info;
+			std::variant<Texture, Renderbuffer> object;
+			std::uint64_t lastFrame = 0;
+			bool inUse = false;
+
+			GLuint handle() const;
+		};
+
+		struct VirtualResource final {
+			std::string label;
+			ResourceInfo info;
+
+			// Set for imports, transients get theirs from the pool
+			Texture* texture = nullptr;
+			Renderbuffer* renderbuffer = nullptr;
+			bool imported = false;
+			bool defaultFramebuffer = false;
+
+			std::uint32_t lastWriter = 0xFFFFFFFF;
+			std::uint32_t firstUse = 0xFFFFFFFF;
+			std::uint32_t lastUse = 0;
+			PooledResource* pooled = nullptr;
+		};
+
+		struct Pass final {
+			std::string name;
+			ExecuteCallback execute;
+			std::vector<Resource> reads;
+			std::vector<std::pair<Resource, GLenum>> writes;
+			std::vector<std::uint32_t> dependencies;
+			bool sideEffect = false;
+			bool alive = false;
+		};
+
+		// Attachment, object handle, renderbuffer
+		using FramebufferKey = std::vector<std::tuple<GLenum, GLuint, bool>>;
+
+		struct CachedFramebuffer final {
+			Framebuffer framebuffer;
+			std::uint64_t lastFrame = 0;
+			bool imported = false; // Dropped at the end of the frame
+		};
+
+		void cull();
+		PooledResource& acquire(ResourceInfo const& info, std::string_view label);
+		GLuint bind_attachments(Pass const& pass);
+		void evict();
+
+		std::vector<Pass> mPasses;
+		std::vector<VirtualResource> mResources;
+
+		// Pointers into the pool stay valid while resources are in use
+		std::vector<std::unique_ptr<PooledResource>> mPool;
+		std::map<FramebufferKey, CachedFramebuffer> mFramebuffers;
+
+		std::uint64_t mFrame = 0;
+		std::uint32_t mPoolLifetime = 4;
+		Stats mStats;
+	};
+}
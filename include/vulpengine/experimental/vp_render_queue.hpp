@@ -0,0 +1,132 @@
+#pragma once
+
+/*!
+Collects draws for a frame and replays them sorted to minimise state changes.
+
+Every draw gets a 64 bit key, from the most significant bits:
+opaque      | layer 4 | 0 | program 10 | material 12 | mesh 12 | depth 25 (front to back)
+translucent | layer 4 | 1 | depth 25 (back to front) | program 10 | material 12 | mesh 12
+
+Program and mesh ids are assigned per frame in submission order, materials are registered
+once with the queue. Depth is any non-negative float, the view space distance works.
+`flush` radix sorts the keys, replays through the vp_ogl wrappers and glstate, and clears the queue.
+
+Opaque draws are replayed with blending off and depth writes on, translucent draws
+with alpha blending and depth writes off. After a flush blending is off and depth writes on.
+
+Needs Improvment:
+1. Per draw data is only a `drawId`, pushed to `drawIdLocation` for indexing into a buffer.
+*/
+
+#include "vulpengine/experimental/vp_ogl.hpp"
+#include "vulpengine/experimental/vp_mesh.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vulpengine::experimental {
+	class RenderQueue final {
+	public:
+		using MaterialHandle = std::uint16_t;
+
+		static constexpr std::size_t kMaxMaterialTextures = 8;
+		static constexpr std::size_t kMaxMaterials = 1 << 12;
+		static constexpr std::size_t kMaxPrograms = 1 << 10;
+		static constexpr std::size_t kMaxMeshes = 1 << 12;
+		static constexpr std::uint8_t kMaxLayer = 15;
+
+		// Textures are bound to the unit matching their index, `uniforms` to `uniformBinding`
+		struct Material final {
+			std::array<Texture const*, kMaxMaterialTextures> textures{};
+			Buffer const* uniforms = nullptr;
+			GLuint uniformBinding = 0;
+		};
+
+		struct CreateInfo final {
+			// Location of a `uint` uniform receiving DrawInfo::drawId, -1 to disable
+			GLint drawIdLocation = -1;
+		};
+
+		struct DrawInfo final {
+			Mesh const& mesh;
+			ShaderProgram const& program;
+			MaterialHandle material = 0;
+			float depth = 0.0f;
+			std::uint8_t layer = 0;
+			bool translucent = false;
+			std::uint32_t drawId = 0;
+			GLsizei count = 0;
+		};
+
+		// Changes between consecutive draws of the last flush
+		struct Stats final {
+			std::uint32_t draws = 0;
+			std::uint32_t dropped = 0; // Past kMaxPrograms or kMaxMeshes, logged as an error
+			std::uint32_t programChanges = 0;
+			std::uint32_t materialChanges = 0;
+			std::uint32_t meshChanges = 0;
+			std::uint32_t blendChanges = 0;
+
+			// From glstate, the GL calls actually issued and skipped while replaying
+			std::uint64_t issued = 0;
+			std::uint64_t elided = 0;
+		};
+
+		RenderQueue() noexcept = default;
+		RenderQueue(CreateInfo const& info);
+
+		// The default material (handle 0) has nothing bound
+		MaterialHandle add_material(Material const& material);
+		inline Material& material(MaterialHandle handle) { return mMaterials[handle]; }
+
+		// `mesh` and `program` must stay alive until the next flush.
+		// Draws past kMaxPrograms programs or kMaxMeshes meshes in one flush are dropped.
+		void submit(DrawInfo const& info);
+
+		// Sorts and replays every submitted draw, then clears the queue
+		void flush();
+
+		inline std::size_t size() const { return mPackets.size(); }
+		inline Stats const& stats() const { return mStats; }
+	private:
+		// Objects are looked up by id on replay
+		struct Packet final {
+			std::uint16_t program;
+			std::uint16_t material;
+			std::uint16_t mesh;
+			bool translucent;
+			std::uint32_t drawId;
+			GLsizei count;
+		};
+
+		struct SortEntry final {
+			std::uint64_t key;
+			std::uint32_t packet;
+		};
+
+		void sort();
+		void replay();
+
+		GLint mDrawIdLocation = -1;
+
+		std::vector<Material> mMaterials{ Material{} };
+
+		std::vector<Packet> mPackets;
+		std::vector<SortEntry> mSorted;
+		std::vector<SortEntry> mScratch;
+
+		std::vector<ShaderProgram const*> mPrograms;
+		std::vector<Mesh const*> mMeshes;
+		std::unordered_map<ShaderProgram const*, std::uint16_t> mProgramIds;
+		std::unordered_map<Mesh const*, std::uint16_t> mMeshIds;
+		std::uint32_t mDropped = 0;
+
+		Stats mStats;
+	};
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
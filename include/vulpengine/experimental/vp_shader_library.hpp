@@ -0,0 +1,68 @@
+#pragma once
+
+/*!
+A collection of shader programs that rebuild themselves when their sources change.
+
+Sources are preprocessed like stb_include (`#include "file"` and `#inject`) but every file
+is read once into an in-memory cache shared by all stages and programs.
+The include graph of every program is recorded, when a file changes on disk only
+the programs depending on it are preprocessed again, on a background thread.
+These are compiled with a ShaderCompiler and swapped in by `update` once linked,
+a program that fails to rebuild keeps its previous version.
+
+Linux watches files with inotify, other platforms poll modification times.
+
+Needs Improvment:
+1. Programs can't be removed from a library once loaded.
+*/
+
+#include "vulpengine/experimental/vp_ogl.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+
+namespace vulpengine::experimental {
+	class ShaderLibrary final {
+	public:
+		using Handle = std::size_t;
+
+		struct CreateInfo final {
+			char const* includePath = "./";
+			char const* cacheDirectory = nullptr;
+			bool watch = true;
+		};
+
+		ShaderLibrary() noexcept = default;
+		ShaderLibrary(CreateInfo const& info);
+		ShaderLibrary(ShaderLibrary const&) = delete;
+		ShaderLibrary& operator=(ShaderLibrary const&) = delete;
+		ShaderLibrary(ShaderLibrary&&) noexcept;
+		ShaderLibrary& operator=(ShaderLibrary&&) noexcept;
+		~ShaderLibrary() noexcept;
+
+		// Builds the program right away, the handle stays valid for the lifetime of the library
+		Handle load(char const* file);
+
+		// The reference stays valid across reloads, it always refers to the latest version
+		ShaderProgram const& get(Handle handle) const;
+
+		// Every file `handle` was built from, the program file first
+		std::vector<std::filesystem::path> dependencies(Handle handle) const;
+
+		// Call on the GL thread once per frame, returns how many programs were swapped in
+		std::size_t update();
+
+		inline explicit operator bool() const { return mImpl != nullptr; }
+		inline bool valid() const { return mImpl != nullptr; }
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> mImpl;
+	};
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
@@ -0,0 +1,97 @@
+#pragma once
+
+/*!
+Shader permutations built from a single source file.
+
+A ShaderVariantKey is a set of defines, its id is a hash of the sorted set so the order
+defines are added in doesn't matter. ShaderVariants compiles a variant the first time it's
+requested and keeps it in memory, give it a `cacheDirectory` to keep the binaries on disk too.
+
+In background mode a missing variant is submitted to a ShaderCompiler and the fallback
+variant is returned until it's ready, call `update` once per frame to finish them.
+*/
+
+#include "vulpengine/experimental/vp_ogl.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace vulpengine::experimental {
+	class ShaderVariantKey final {
+	public:
+		ShaderVariantKey() noexcept = default;
+		ShaderVariantKey(std::initializer_list<std::string_view> defines);
+
+		// `define` is `NAME` or `NAME value`, adding a define twice has no effect
+		ShaderVariantKey& define(std::string_view define);
+
+		inline std::uint64_t id() const { return mId; }
+		inline std::span<std::string const> defines() const { return mDefines; }
+		inline bool empty() const { return mDefines.empty(); }
+
+		inline bool operator==(ShaderVariantKey const& other) const { return mId == other.mId && mDefines == other.mDefines; }
+	private:
+		std::vector<std::string> mDefines; // Sorted
+		std::uint64_t mId = hash_fnv1a("");
+	};
+
+	class ShaderVariants final {
+	public:
+		struct CreateInfo final {
+			char const* file = nullptr;
+			char const* includePath = "./";
+			char const* cacheDirectory = nullptr;
+
+			// Compile missing variants with a ShaderCompiler instead of blocking in `get`
+			bool background = false;
+
+			// Returned while a background variant is compiling, always built synchronously
+			ShaderVariantKey fallback;
+		};
+
+		ShaderVariants() noexcept = default;
+		ShaderVariants(CreateInfo const& info);
+		ShaderVariants(ShaderVariants const&) = delete;
+		ShaderVariants& operator=(ShaderVariants const&) = delete;
+		ShaderVariants(ShaderVariants&&) noexcept = default;
+		ShaderVariants& operator=(ShaderVariants&&) noexcept = default;
+		~ShaderVariants() noexcept = default;
+
+		// References stay valid for the lifetime of this object, failed variants are invalid programs
+		ShaderProgram const& get(ShaderVariantKey const& key);
+
+		// True if `key` is built, `get` won't return the fallback for it
+		bool ready(ShaderVariantKey const& key) const;
+
+		// Finishes background compiles, returns true when none are pending
+		bool update();
+
+		inline std::size_t size() const { return mVariants.size(); }
+	private:
+		struct Variant final {
+			ShaderProgram program;
+			std::optional<ShaderCompiler::Ticket> ticket;
+		};
+
+		ShaderProgram::CreateInfo create_info(ShaderVariantKey const& key, std::vector<std::string_view>& defines) const;
+
+		std::string mFile;
+		std::string mIncludePath;
+		std::optional<std::string> mCacheDirectory;
+		bool mBackground = false;
+		ShaderVariantKey mFallback;
+
+		std::unordered_map<std::uint64_t, Variant> mVariants;
+		std::optional<ShaderCompiler> mCompiler;
+	};
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
@@ -4,20 +4,52 @@
 State and StateManagers are used to segment large sections of code in a game
 Eg: Main Menu, Credits, Splash Screeens
 
+A state's resources are loaded by its `load` task, which can read files on the I/O thread,
+decode on job workers and create GL objects with `tasks::resume_on_gl_thread`. `preload`
+starts that in the background while the current state keeps updating, the manager switches
+at the start of the first `update` after it finished. `on_detach` runs on the outgoing state
+and `on_attach` on the incoming one right at the switch.
+
+```cpp
+class Level final : public State {
+public:
+	Task<> load() override {
+		std::vector<Task<Image>> images;
+		for (auto const& path : mPaths) images.push_back(load_image(path));
+		mImages = co_await tasks::when_all(std::move(images));
+		report_progress(0.9f);
+		co_await tasks::resume_on_gl_thread();
+		... // Create textures
+	}
+
+	void update() override { ... }
+};
+
+states.preload<Level>();
+
+// Every frame, on the GL thread
+tasks::poll();
+states.update(); // Still the loading screen until Level is ready
+float const progress = states.progress();
+```
+
 Needs Improvment:
 1. Its common to want to pass data through the paramters of update
 This can be achieved by making these template classes instead or
 by using a more c style approach with a void userdata pointer.
 
-2. Should have on_attach and on_detach functions
-Generally the constructor and destructor may be forced to be given
-responsibilities it shouldn't handle depending on the state.
-Idealy subclasses of State should use the implicit constructor and destructors.
+2. A superseded preload can't be cancelled, it's kept alive until its load finishes.
+
+3. GL work in `load` waits for `tasks::poll` on the main context, a shared context
+would let big uploads run without taking frame time.
 */
 
-#include <utility>
+#include "vulpengine/experimental/vp_task.hpp"
+
+#include <atomic>
 #include <memory>
-#include <cassert>
+#include <utility>
+#include <vector>
 
 namespace vulpengine::experimental {
 	class State {
@@ -29,25 +61,85 @@ namespace vulpengine::experimental {
 		State& operator=(State&&) noexcept = delete;
 		virtual ~State() noexcept = default;
 
+		// Loads what the state needs before it becomes current, the previous state keeps updating meanwhile
+		inline virtual Task<> load() { co_return; }
+
+		// Called on the thread calling `StateManager::update`, when the state becomes current and when it stops being current
+		inline virtual void on_attach() {}
+		inline virtual void on_detach() {}
+
 		virtual void update() = 0;
+
+		// How far along `load` is, from 0 to 1
+		inline float progress() const { return mProgress.load(std::memory_order_relaxed); }
+	protected:
+		// Can be called from any thread while loading
+		inline void report_progress(float progress) { mProgress.store(progress, std::memory_order_relaxed); }
+	private:
+		friend class StateManager;
+		std::atomic<float> mProgress = 0.0f;
 	};
 
 	class StateManager final {
 	public:
+		StateManager() noexcept = default;
+		StateManager(StateManager const&) = delete;
+		StateManager& operator=(StateManager const&) = delete;
+		inline StateManager(StateManager&& other) noexcept { *this = std::move(other); }
+
+		inline StateManager& operator=(StateManager&& other) noexcept {
+			std::swap(mState, other.mState);
+			std::swap(mNext, other.mNext);
+			std::swap(mAbandoned, other.mAbandoned);
+			return *this;
+		}
+
+		// Waits for loads in flight
+		~StateManager() noexcept;
+
+		// Loads the state right away, blocking until it's done, and switches to it
 		template<class T, class... Args>
 		void set(Args&&... args) {
-			mState = std::make_unique<T>(std::forward<Args>(args)...);
+			Loading loading;
+			loading.state = std::make_unique<T>(std::forward<Args>(args)...);
+			loading.task = loading.state->load();
+			tasks::sync_wait(std::move(loading.task));
+			abandon();
+			attach(std::move(loading.state));
 		}
 
-		inline void update() {
-			assert(mState);
-			mState->update();
+		// Starts loading the state in the background, `update` switches to it once it's loaded.
+		// Replaces a preload that hasn't finished yet.
+		template<class T, class... Args>
+		void preload(Args&&... args) {
+			abandon();
+			mNext.state = std::make_unique<T>(std::forward<Args>(args)...);
+			mNext.task = mNext.state->load();
+			mNext.task.start();
 		}
 
-		inline void reset() {
-			mState = nullptr;
-		}
+		// Switches to a preloaded state if it's ready, then updates the current state if there is one
+		void update();
+
+		// Detaches and destroys the current state, and drops a preload
+		void reset();
+
+		// A preload hasn't been switched to yet
+		inline bool loading() const { return mNext.state != nullptr; }
+
+		// Progress of the preload, 1 if there's none
+		inline float progress() const { return mNext.state ? mNext.state->progress() : 1.0f; }
 	private:
+		struct Loading final {
+			std::unique_ptr<State> state;
+			Task<> task;
+		};
+
+		void attach(std::unique_ptr<State> state);
+		void abandon();
+
 		std::unique_ptr<State> mState;
+		Loading mNext;
+		std::vector<Loading> mAbandoned; // Superseded preloads, kept until their load finishes
 	};
-}
\ No newline at end of file
+}
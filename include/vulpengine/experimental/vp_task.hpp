@@ -0,0 +1,276 @@
+#pragma once
+
+/*!
+Coroutine tasks for loading assets without blocking.
+
+A `Task` starts when it's awaited or `start`ed and resumes its awaiter when it finishes. Inside
+a task, `tasks::read_file` reads through the virtual filesystem on the I/O thread and resumes on
+a job worker, `tasks::resume_on_worker` moves to a job worker and `tasks::resume_on_gl_thread`
+waits for the next `tasks::poll` on the thread owning the GL context. Loose files requested
+together are read in one batch by an `aio::Reader`.
+
+```cpp
+Task<Texture> load_texture(std::filesystem::path path) {
+	Image image = co_await load_image(path); // Read on the I/O thread, decoded on a worker
+	co_await tasks::resume_on_gl_thread();
+	co_return Texture(Texture::CreateInfo{ ... }.with_image(image));
+}
+
+std::vector<Task<Texture>> loads;
+for (auto const& path : paths) loads.push_back(load_texture(path));
+std::vector<Texture> textures = tasks::sync_wait(tasks::when_all(std::move(loads)));
+```
+
+The GL thread is the first thread that calls `poll` or `sync_wait`, call `poll` once a frame
+from it. Tasks must not throw.
+
+Needs Improvment:
+1. `poll` resumes everything queued, a frame budget would keep big uploads from hitching.
+2. No cancellation.
+*/
+
+#include "vulpengine/experimental/vp_jobs.hpp"
+#include "vulpengine/experimental/vp_vfs.hpp"
+
+#include <cstddef>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vulpengine::experimental {
+	template<class T = void>
+	class Task;
+
+	namespace detail {
+		struct TaskPromiseBase {
+			// Null while running, then the awaiting coroutine, then finished
+			std::atomic<void*> state = nullptr;
+
+			// Its address marks a finished task
+			static inline char finishedTag = 0;
+			static inline void* finished() noexcept { return &finishedTag; }
+
+			struct FinalAwaiter final {
+				inline bool await_ready() const noexcept { return false; }
+
+				template<class Promise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+					void* const awaiter = handle.promise().state.exchange(finished(), std::memory_order_acq_rel);
+					if (awaiter) return std::coroutine_handle<>::from_address(awaiter);
+					return std::noop_coroutine();
+				}
+
+				inline void await_resume() const noexcept {}
+			};
+
+			inline std::suspend_always initial_suspend() const noexcept { return {}; }
+			inline FinalAwaiter final_suspend() const noexcept { return {}; }
+			inline void unhandled_exception() const noexcept { std::terminate(); }
+		};
+
+		template<class T>
+		struct TaskPromise final : TaskPromiseBase {
+			std::optional<T> value;
+
+			Task<T> get_return_object() noexcept;
+
+			template<class U>
+			void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+		};
+
+		template<>
+		struct TaskPromise<void> final : TaskPromiseBase {
+			Task<void> get_return_object() noexcept;
+			inline void return_void() const noexcept {}
+		};
+	}
+
+	template<class T>
+	class [[nodiscard]] Task final {
+		static_assert(!std::is_reference_v<T>, "Tasks return values");
+	public:
+		using promise_type = detail::TaskPromise<T>;
+
+		Task() noexcept = default;
+		inline explicit Task(std::coroutine_handle<promise_type> handle) noexcept : mHandle(handle) {}
+		Task(Task const&) = delete;
+		Task& operator=(Task const&) = delete;
+		inline Task(Task&& other) noexcept { *this = std::move(other); }
+
+		inline Task& operator=(Task&& other) noexcept {
+			std::swap(mHandle, other.mHandle);
+			std::swap(mStarted, other.mStarted);
+			return *this;
+		}
+
+		// A started task must finish before it's destroyed
+		inline ~Task() noexcept {
+			if (mHandle) mHandle.destroy();
+		}
+
+		inline explicit operator bool() const { return static_cast<bool>(mHandle); }
+		inline bool valid() const { return static_cast<bool>(mHandle); }
+
+		inline bool done() const {
+			return mHandle && mHandle.promise().state.load(std::memory_order_acquire) == detail::TaskPromiseBase::finished();
+		}
+
+		// Runs the task on the calling thread up to its first suspension, it can be awaited later
+		inline void start() {
+			if (mStarted) return;
+			mStarted = true;
+			mHandle.resume();
+		}
+
+		// The result of a finished task
+		inline T result() && requires (!std::is_void_v<T>) {
+			return std::move(*mHandle.promise().value);
+		}
+
+		inline auto operator co_await() && noexcept {
+			struct Awaiter final {
+				Task& task;
+
+				inline bool await_ready() const noexcept { return task.done(); }
+
+				inline std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+					auto& state = task.mHandle.promise().state;
+
+					if (!task.mStarted) {
+						task.mStarted = true;
+						state.store(awaiter.address(), std::memory_order_relaxed);
+						return task.mHandle;
+					}
+
+					void* expected = nullptr;
+					if (state.compare_exchange_strong(expected, awaiter.address(), std::memory_order_acq_rel, std::memory_order_acquire))
+						return std::noop_coroutine();
+					return awaiter; // Finished in the meantime
+				}
+
+				inline T await_resume() {
+					if constexpr (!std::is_void_v<T>) return std::move(*task.mHandle.promise().value);
+				}
+			};
+
+			return Awaiter{ *this };
+		}
+	private:
+		std::coroutine_handle<promise_type> mHandle;
+		bool mStarted = false;
+	};
+
+	template<class T>
+	Task<T> detail::TaskPromise<T>::get_return_object() noexcept {
+		return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+	}
+
+	inline Task<void> detail::TaskPromise<void>::get_return_object() noexcept {
+		return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+	}
+
+	namespace tasks {
+		namespace detail {
+			struct ReadRequest final {
+				std::filesystem::path path;
+				vfs::File file;
+				std::coroutine_handle<> handle;
+				std::vector<std::byte> buffer; // Loose files are read into this first
+			};
+
+			void queue_read(ReadRequest& request);
+			void queue_gl(std::coroutine_handle<> handle);
+
+			// Makes the calling thread the GL thread if there's none yet
+			bool claim_gl_thread();
+		}
+
+		bool on_gl_thread();
+
+		// Resumes every coroutine waiting for the GL thread, returns how many ran
+		std::size_t poll();
+
+		// Finishes queued reads and stops the I/O thread
+		void shutdown();
+
+		class ReadFile final {
+		public:
+			inline explicit ReadFile(std::filesystem::path path) { mRequest.path = std::move(path); }
+
+			inline bool await_ready() const noexcept { return false; }
+
+			inline void await_suspend(std::coroutine_handle<> handle) {
+				mRequest.handle = handle;
+				detail::queue_read(mRequest);
+			}
+
+			inline vfs::File await_resume() { return std::move(mRequest.file); }
+		private:
+			detail::ReadRequest mRequest;
+		};
+
+		// Reads on the I/O thread, resumes on a job worker. An invalid file if it couldn't be read.
+		inline ReadFile read_file(std::filesystem::path path) {
+			return ReadFile(std::move(path));
+		}
+
+		// `name` must be a string literal, it names the job's profiler zone
+		inline auto resume_on_worker(char const* name = "task") {
+			struct Awaiter final {
+				char const* name;
+
+				inline bool await_ready() const noexcept { return false; }
+				inline void await_suspend(std::coroutine_handle<> handle) const { jobs::run([handle] { handle.resume(); }, name); }
+				inline void await_resume() const noexcept {}
+			};
+
+			return Awaiter{ name };
+		}
+
+		// Continues right away when already on the GL thread
+		inline auto resume_on_gl_thread() {
+			struct Awaiter final {
+				inline bool await_ready() const noexcept { return on_gl_thread(); }
+				inline void await_suspend(std::coroutine_handle<> handle) const { detail::queue_gl(handle); }
+				inline void await_resume() const noexcept {}
+			};
+
+			return Awaiter{};
+		}
+
+		// Starts every task before awaiting any, so they overlap
+		template<class T>
+		Task<std::vector<T>> when_all(std::vector<Task<T>> pending) {
+			for (Task<T>& task : pending) task.start();
+
+			std::vector<T> results;
+			results.reserve(pending.size());
+			for (Task<T>& task : pending) results.push_back(co_await std::move(task));
+			co_return results;
+		}
+
+		inline Task<> when_all(std::vector<Task<>> pending) {
+			for (Task<>& task : pending) task.start();
+			for (Task<>& task : pending) co_await std::move(task);
+		}
+
+		// Blocks until the task finished, running jobs meanwhile and GL continuations on the GL thread
+		template<class T>
+		T sync_wait(Task<T> task) {
+			task.start();
+
+			while (!task.done()) {
+				bool const ranGl = detail::claim_gl_thread() && poll();
+				if (!ranGl && !jobs::run_one()) std::this_thread::yield();
+			}
+
+			if constexpr (!std::is_void_v<T>) return std::move(task).result();
+		}
+	}
+}
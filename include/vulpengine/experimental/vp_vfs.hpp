@@ -0,0 +1,76 @@
+#pragma once
+
+/*!
+Reads asset files from mounted archives, falling back to loose files on disk.
+
+Archives mounted later take priority. Paths are looked up normalized (see `archive_path`),
+so `"./textures/../textures/a.png"` and an absolute path under the working directory both
+find `textures/a.png`. Loose files are read from the path as given.
+
+A `File` from an archive is a view into the mapping when the entry is stored uncompressed,
+otherwise it owns the decompressed bytes. Either way it keeps its archive mapped after
+`unmount`. All functions are thread safe.
+
+Needs Improvment:
+1. Loose files are read whole, they could be mapped too.
+*/
+
+#include "vulpengine/experimental/vp_archive.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace vulpengine::experimental::vfs {
+	class File final {
+	public:
+		File() noexcept = default;
+		// Owns bytes read some other way, eg. by `aio::Reader`
+		inline explicit File(std::vector<std::byte> buffer) noexcept : mBuffer(std::move(buffer)), mBytes(mBuffer), mValid(true) {}
+		File(File const&) = delete;
+		File& operator=(File const&) = delete;
+		inline File(File&& other) noexcept { *this = std::move(other); }
+		File& operator=(File&& other) noexcept;
+
+		// Bytes stay valid for the lifetime of the file
+		inline std::span<std::byte const> bytes() const { return mBytes; }
+		inline std::string_view text() const { return { reinterpret_cast<char const*>(mBytes.data()), mBytes.size() }; }
+		inline std::size_t size() const { return mBytes.size(); }
+
+		// True when the bytes point into a mapped archive rather than a copy
+		inline bool mapped() const { return mArchive && mBuffer.empty(); }
+
+		inline explicit operator bool() const { return mValid; }
+		inline bool valid() const { return mValid; }
+	private:
+		friend File open(std::filesystem::path const& path);
+
+		std::shared_ptr<Archive const> mArchive;
+		std::vector<std::byte> mBuffer;
+		std::span<std::byte const> mBytes;
+		bool mValid = false;
+	};
+
+	bool mount(std::filesystem::path const& archive);
+	bool unmount(std::filesystem::path const& archive);
+	void unmount_all();
+
+	// On by default, dist builds shipping everything in archives can turn it off
+	void set_loose_files(bool enabled);
+	bool loose_files();
+
+	bool exists(std::filesystem::path const& path);
+	// True if a mounted archive has the file, whether or not it's on disk too
+	bool archived(std::filesystem::path const& path);
+	std::optional<std::size_t> size(std::filesystem::path const& path);
+
+	// Invalid if the file isn't found in any archive or on disk
+	File open(std::filesystem::path const& path);
+
+	// Decompresses or copies straight into `output`, which must be exactly `size(path)` bytes
+	bool read(std::filesystem::path const& path, std::span<std::byte> output);
+}
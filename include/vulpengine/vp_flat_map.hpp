@@ -0,0 +1,420 @@
+#pragma once
+
+/*!
+An open addressing hash map in the style of Swiss tables.
+
+Entries are stored inline in one array with a parallel array of control bytes, one per slot:
+empty, deleted, or the low 7 bits of the entry's hash. A lookup compares a group of 16 control
+bytes at once (SSE2 where available) and only compares keys whose byte matched, a miss usually
+touches a single cache line of control bytes and no entries at all.
+Capacity is a power of two kept at most 7/8 full, erased slots are reused on insert.
+
+Mostly a drop in for std::unordered_map:
+- Lookups are heterogeneous when both `Hash` and `KeyEqual` define `is_transparent`
+- `value_type` is `std::pair<K, V>`, keys must not be modified through iterators
+- Inserting can rehash, which moves entries and invalidates iterators and references
+
+Needs Improvment:
+1. Only x86 has a vectorized group match, other platforms match bytes in a loop.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VP_FLAT_MAP_SSE2
+#	include <emmintrin.h>
+#endif
+
+namespace vulpengine {
+	namespace detail {
+		constexpr std::size_t kFlatMapGroupWidth = 16;
+		constexpr std::size_t kFlatMapMinCapacity = kFlatMapGroupWidth;
+
+		// Full slots hold the 7 bit hash, so only empty and deleted have the sign bit set
+		constexpr std::int8_t kFlatMapEmpty = -128;
+		constexpr std::int8_t kFlatMapDeleted = -2;
+
+		// Bit `i` of a match is set when control byte `i` of the group matches
+		class FlatMapGroup final {
+		public:
+#ifdef VP_FLAT_MAP_SSE2
+			inline explicit FlatMapGroup(std::int8_t const* control) : mControl(_mm_loadu_si128(reinterpret_cast<__m128i const*>(control))) {}
+
+			inline std::uint32_t match(std::int8_t h2) const { return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(mControl, _mm_set1_epi8(h2)))); }
+			inline std::uint32_t match_empty() const { return match(kFlatMapEmpty); }
+			inline std::uint32_t match_free() const { return static_cast<std::uint32_t>(_mm_movemask_epi8(mControl)); }
+		private:
+			__m128i mControl;
+#else
+			inline explicit FlatMapGroup(std::int8_t const* control) { std::memcpy(mControl.data(), control, kFlatMapGroupWidth); }
+
+			inline std::uint32_t match(std::int8_t h2) const {
+				std::uint32_t bits = 0;
+				for (std::size_t i = 0; i < kFlatMapGroupWidth; ++i) bits |= static_cast<std::uint32_t>(mControl[i] == h2) << i;
+				return bits;
+			}
+
+			inline std::uint32_t match_empty() const { return match(kFlatMapEmpty); }
+
+			inline std::uint32_t match_free() const {
+				std::uint32_t bits = 0;
+				for (std::size_t i = 0; i < kFlatMapGroupWidth; ++i) bits |= static_cast<std::uint32_t>(mControl[i] < 0) << i;
+				return bits;
+			}
+		private:
+			std::array<std::int8_t, kFlatMapGroupWidth> mControl;
+#endif
+		};
+
+		// Spreads weak hashes (identity for integers) over both the probe position and the 7 bit tag
+		inline std::uint64_t flat_map_mix(std::uint64_t hash) {
+			hash *= 0x9E3779B97F4A7C15ull;
+			return hash ^ (hash >> 32);
+		}
+
+		constexpr std::size_t flat_map_growth(std::size_t capacity) {
+			return capacity - capacity / 8;
+		}
+	}
+
+	template<class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+	class FlatMap final {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K, V>;
+		using size_type = std::size_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+
+		template<bool Const>
+		class Iterator final {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = FlatMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+			using reference = std::conditional_t<Const, value_type const&, value_type&>;
+
+			Iterator() noexcept = default;
+
+			inline operator Iterator<true>() const requires (!Const) { return { mMap, mIndex }; }
+
+			inline reference operator*() const { return mMap->mSlots[mIndex]; }
+			inline pointer operator->() const { return mMap->mSlots + mIndex; }
+
+			inline Iterator& operator++() {
+				++mIndex;
+				skip_free();
+				return *this;
+			}
+
+			inline Iterator operator++(int) {
+				Iterator previous = *this;
+				++*this;
+				return previous;
+			}
+
+			inline bool operator==(Iterator const& other) const { return mIndex == other.mIndex; }
+		private:
+			friend class FlatMap;
+			friend class Iterator<!Const>;
+
+			using Map = std::conditional_t<Const, FlatMap const, FlatMap>;
+
+			inline Iterator(Map* map, std::size_t index) noexcept : mMap(map), mIndex(index) {}
+
+			inline void skip_free() {
+				while (mIndex < mMap->mCapacity && mMap->mControl[mIndex] < 0) ++mIndex;
+			}
+
+			Map* mMap = nullptr;
+			std::size_t mIndex = 0;
+		};
+
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		FlatMap() noexcept = default;
+
+		FlatMap(FlatMap const& other) : mHash(other.mHash), mEqual(other.mEqual) {
+			if (other.empty()) return;
+			reserve(other.mSize);
+			for (value_type const& entry : other) emplace_new(hash_of(entry.first), entry.first, entry.second);
+		}
+
+		FlatMap& operator=(FlatMap const& other) {
+			if (this != &other) {
+				FlatMap copy(other);
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+
+		inline FlatMap(FlatMap&& other) noexcept { *this = std::move(other); }
+
+		FlatMap& operator=(FlatMap&& other) noexcept {
+			std::swap(mControl, other.mControl);
+			std::swap(mSlots, other.mSlots);
+			std::swap(mCapacity, other.mCapacity);
+			std::swap(mSize, other.mSize);
+			std::swap(mGrowthLeft, other.mGrowthLeft);
+			std::swap(mHash, other.mHash);
+			std::swap(mEqual, other.mEqual);
+			return *this;
+		}
+
+		FlatMap(std::initializer_list<value_type> entries) {
+			reserve(entries.size());
+			for (value_type const& entry : entries) try_emplace(entry.first, entry.second);
+		}
+
+		~FlatMap() noexcept {
+			destroy_entries();
+			deallocate(mControl, mSlots, mCapacity);
+		}
+
+		inline iterator begin() { iterator it(this, 0); it.skip_free(); return it; }
+		inline const_iterator begin() const { const_iterator it(this, 0); it.skip_free(); return it; }
+		inline iterator end() { return { this, mCapacity }; }
+		inline const_iterator end() const { return { this, mCapacity }; }
+
+		inline std::size_t size() const { return mSize; }
+		inline bool empty() const { return mSize == 0; }
+		inline std::size_t capacity() const { return mCapacity; }
+
+		template<class Key>
+		inline iterator find(Key const& key) {
+			decltype(auto) lookup = lookup_key(key);
+			return { this, find_index(lookup, hash_of(lookup)) };
+		}
+
+		template<class Key>
+		inline const_iterator find(Key const& key) const {
+			decltype(auto) lookup = lookup_key(key);
+			return { this, find_index(lookup, hash_of(lookup)) };
+		}
+
+		template<class Key>
+		inline bool contains(Key const& key) const { return find(key) != end(); }
+
+		template<class Key>
+		inline std::size_t count(Key const& key) const { return contains(key) ? 1 : 0; }
+
+		template<class... Args>
+		std::pair<iterator, bool> try_emplace(K const& key, Args&&... args) {
+			return try_emplace_impl(key, std::forward<Args>(args)...);
+		}
+
+		template<class... Args>
+		std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+			return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+		}
+
+		// Constructs the entry up front, prefer try_emplace when the key may already be present
+		template<class... Args>
+		std::pair<iterator, bool> emplace(Args&&... args) {
+			value_type entry(std::forward<Args>(args)...);
+			return try_emplace_impl(std::move(entry.first), std::move(entry.second));
+		}
+
+		inline std::pair<iterator, bool> insert(value_type const& entry) { return try_emplace_impl(entry.first, entry.second); }
+		inline std::pair<iterator, bool> insert(value_type&& entry) { return try_emplace_impl(std::move(entry.first), std::move(entry.second)); }
+
+		template<class T>
+		std::pair<iterator, bool> insert_or_assign(K key, T&& value) {
+			auto result = try_emplace_impl(std::move(key), std::forward<T>(value));
+			if (!result.second) result.first->second = std::forward<T>(value);
+			return result;
+		}
+
+		inline V& operator[](K const& key) { return try_emplace_impl(key).first->second; }
+		inline V& operator[](K&& key) { return try_emplace_impl(std::move(key)).first->second; }
+
+		iterator erase(const_iterator position) {
+			erase_index(position.mIndex);
+			iterator next(this, position.mIndex + 1);
+			next.skip_free();
+			return next;
+		}
+
+		inline iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+		template<class Key> requires (!std::is_convertible_v<Key const&, const_iterator>)
+		std::size_t erase(Key const& key) {
+			decltype(auto) lookup = lookup_key(key);
+			std::size_t const index = find_index(lookup, hash_of(lookup));
+			if (index == mCapacity) return 0;
+			erase_index(index);
+			return 1;
+		}
+
+		// Keeps the allocation
+		void clear() {
+			destroy_entries();
+			if (mControl) reset_control();
+			mSize = 0;
+		}
+
+		// Rehashes so `count` entries fit without growing again
+		void reserve(std::size_t count) {
+			std::size_t capacity = detail::kFlatMapMinCapacity;
+			while (detail::flat_map_growth(capacity) < count) capacity *= 2;
+			if (capacity > mCapacity) rehash(capacity);
+		}
+	private:
+		static constexpr bool kTransparent = requires {
+			typename Hash::is_transparent;
+			typename KeyEqual::is_transparent;
+		};
+
+		// Keys of another type are converted unless the map is transparent
+		template<class Key>
+		inline decltype(auto) lookup_key(Key const& key) const {
+			if constexpr (kTransparent || std::is_same_v<Key, K>) return (key);
+			else return K(key);
+		}
+
+		template<class Key>
+		inline std::uint64_t hash_of(Key const& key) const {
+			return detail::flat_map_mix(static_cast<std::uint64_t>(mHash(key)));
+		}
+
+		static inline std::int8_t tag(std::uint64_t hash) { return static_cast<std::int8_t>(hash & 0x7F); }
+
+		// Groups are visited in triangular steps, with a power of two capacity that reaches every group
+		template<class Key>
+		std::size_t find_index(Key const& key, std::uint64_t hash) const {
+			if (!mCapacity) return mCapacity;
+
+			std::size_t const mask = mCapacity - 1;
+			std::size_t position = static_cast<std::size_t>(hash >> 7) & mask;
+			std::int8_t const h2 = tag(hash);
+
+			for (std::size_t step = detail::kFlatMapGroupWidth;; step += detail::kFlatMapGroupWidth) {
+				detail::FlatMapGroup const group(mControl + position);
+
+				for (std::uint32_t bits = group.match(h2); bits; bits &= bits - 1) {
+					std::size_t const index = (position + std::countr_zero(bits)) & mask;
+					if (mEqual(mSlots[index].first, key)) return index;
+				}
+
+				// Inserts fill the first free slot, an empty one means the key was never further along
+				if (group.match_empty()) return mCapacity;
+				position = (position + step) & mask;
+			}
+		}
+
+		std::size_t find_free(std::uint64_t hash) const {
+			std::size_t const mask = mCapacity - 1;
+			std::size_t position = static_cast<std::size_t>(hash >> 7) & mask;
+
+			for (std::size_t step = detail::kFlatMapGroupWidth;; step += detail::kFlatMapGroupWidth) {
+				if (std::uint32_t const bits = detail::FlatMapGroup(mControl + position).match_free())
+					return (position + std::countr_zero(bits)) & mask;
+				position = (position + step) & mask;
+			}
+		}
+
+		// The first group's bytes are mirrored after the end so a group load never wraps
+		inline void set_control(std::size_t index, std::int8_t value) {
+			mControl[index] = value;
+			if (index < detail::kFlatMapGroupWidth) mControl[mCapacity + index] = value;
+		}
+
+		template<class Key, class... Args>
+		std::pair<iterator, bool> try_emplace_impl(Key&& key, Args&&... args) {
+			std::uint64_t const hash = hash_of(key);
+			std::size_t const index = find_index(key, hash);
+			if (index != mCapacity) return { iterator(this, index), false };
+			return { iterator(this, emplace_new(hash, std::forward<Key>(key), std::forward<Args>(args)...)), true };
+		}
+
+		// Expects the key to be absent
+		template<class Key, class... Args>
+		std::size_t emplace_new(std::uint64_t hash, Key&& key, Args&&... args) {
+			if (!mGrowthLeft) {
+				// Mostly deleted slots are reclaimed at the same capacity rather than growing
+				std::size_t const capacity = mCapacity && mSize < detail::flat_map_growth(mCapacity) / 2 ? mCapacity : std::max(mCapacity * 2, detail::kFlatMapMinCapacity);
+				rehash(capacity);
+			}
+
+			std::size_t const index = find_free(hash);
+			std::construct_at(mSlots + index, std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+
+			// Reusing a deleted slot doesn't shorten any probe sequence, so it doesn't count against growth
+			if (mControl[index] == detail::kFlatMapEmpty) --mGrowthLeft;
+			set_control(index, tag(hash));
+			++mSize;
+			return index;
+		}
+
+		void erase_index(std::size_t index) {
+			std::destroy_at(mSlots + index);
+			set_control(index, detail::kFlatMapDeleted);
+			--mSize;
+		}
+
+		void rehash(std::size_t capacity) {
+			std::int8_t* const oldControl = mControl;
+			value_type* const oldSlots = mSlots;
+			std::size_t const oldCapacity = mCapacity;
+
+			mControl = new std::int8_t[capacity + detail::kFlatMapGroupWidth];
+			mSlots = std::allocator<value_type>{}.allocate(capacity);
+			mCapacity = capacity;
+			reset_control();
+
+			for (std::size_t i = 0; i < oldCapacity; ++i) {
+				if (oldControl[i] < 0) continue;
+
+				std::uint64_t const hash = hash_of(oldSlots[i].first);
+				std::size_t const index = find_free(hash);
+				std::construct_at(mSlots + index, std::move(oldSlots[i]));
+				std::destroy_at(oldSlots + i);
+				set_control(index, tag(hash));
+			}
+
+			mGrowthLeft -= mSize;
+			deallocate(oldControl, oldSlots, oldCapacity);
+		}
+
+		void reset_control() {
+			std::memset(mControl, static_cast<unsigned char>(detail::kFlatMapEmpty), mCapacity + detail::kFlatMapGroupWidth);
+			mGrowthLeft = detail::flat_map_growth(mCapacity);
+		}
+
+		void destroy_entries() {
+			if constexpr (!std::is_trivially_destructible_v<value_type>) {
+				for (std::size_t i = 0; i < mCapacity; ++i)
+					if (mControl[i] >= 0) std::destroy_at(mSlots + i);
+			}
+		}
+
+		static void deallocate(std::int8_t* control, value_type* slots, std::size_t capacity) {
+			if (!control) return;
+			delete[] control;
+			std::allocator<value_type>{}.deallocate(slots, capacity);
+		}
+
+		std::int8_t* mControl = nullptr;
+		value_type* mSlots = nullptr;
+		std::size_t mCapacity = 0;
+		std::size_t mSize = 0;
+		std::size_t mGrowthLeft = 0;
+		[[no_unique_address]] Hash mHash;
+		[[no_unique_address]] KeyEqual mEqual;
+	};
+}
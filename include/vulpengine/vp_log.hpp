@@ -1,28 +1,83 @@
 #pragma once
 
 /*!
-Simple log macros, will default expand into standard compliant logs
+Simple log macros, will default expand into the asynchronous logger in vp_logger.hpp
 
 If spdlog is detected then will prefer to expand using spdlog
+
+Levels below VP_LOG_LEVEL are compiled out, their arguments aren't evaluated.
+Define VP_LOG_LEVEL to one of the VP_LOG_LEVEL_* values to override the default,
+which keeps everything except in dist builds where trace and debug are removed.
 */
 
 #include "vulpengine/vp_features.hpp"
 
+#define VP_LOG_LEVEL_TRACE 0
+#define VP_LOG_LEVEL_DEBUG 1
+#define VP_LOG_LEVEL_INFO 2
+#define VP_LOG_LEVEL_WARN 3
+#define VP_LOG_LEVEL_ERROR 4
+#define VP_LOG_LEVEL_CRITICAL 5
+#define VP_LOG_LEVEL_OFF 6
+
+#ifndef VP_LOG_LEVEL
+#	ifdef VP_DIST
+#		define VP_LOG_LEVEL VP_LOG_LEVEL_INFO
+#	else
+#		define VP_LOG_LEVEL VP_LOG_LEVEL_TRACE
+#	endif
+#endif
+
 #ifdef VP_HAS_SPDLOG
 #	include <spdlog/spdlog.h>
-#	define VP_LOG_TRACE(...) spdlog::trace(__VA_ARGS__)
-#	define VP_LOG_DEBUG(...) spdlog::debug(__VA_ARGS__)
-#	define VP_LOG_INFO(...) spdlog::info(__VA_ARGS__)
-#	define VP_LOG_WARN(...) spdlog::warn(__VA_ARGS__)
-#	define VP_LOG_ERROR(...) spdlog::error(__VA_ARGS__)
-#	define VP_LOG_CRITICAL(...) spdlog::critical(__VA_ARGS__)
+#	define VP_LOG_IMPL_TRACE(...) spdlog::trace(__VA_ARGS__)
+#	define VP_LOG_IMPL_DEBUG(...) spdlog::debug(__VA_ARGS__)
+#	define VP_LOG_IMPL_INFO(...) spdlog::info(__VA_ARGS__)
+#	define VP_LOG_IMPL_WARN(...) spdlog::warn(__VA_ARGS__)
+#	define VP_LOG_IMPL_ERROR(...) spdlog::error(__VA_ARGS__)
+#	define VP_LOG_IMPL_CRITICAL(...) spdlog::critical(__VA_ARGS__)
+#else
+#	include "vulpengine/vp_logger.hpp"
+#	define VP_LOG_IMPL_TRACE(...) ::vulpengine::logger::write(::vulpengine::logger::Level::kTrace, __VA_ARGS__)
+#	define VP_LOG_IMPL_DEBUG(...) ::vulpengine::logger::write(::vulpengine::logger::Level::kDebug, __VA_ARGS__)
+#	define VP_LOG_IMPL_INFO(...) ::vulpengine::logger::write(::vulpengine::logger::Level::kInfo, __VA_ARGS__)
+#	define VP_LOG_IMPL_WARN(...) ::vulpengine::logger::write(::vulpengine::logger::Level::kWarn, __VA_ARGS__)
+#	define VP_LOG_IMPL_ERROR(...) ::vulpengine::logger::write(::vulpengine::logger::Level::kError, __VA_ARGS__)
+#	define VP_LOG_IMPL_CRITICAL(...) ::vulpengine::logger::write(::vulpengine::logger::Level::kCritical, __VA_ARGS__)
+#endif
+
+#if VP_LOG_LEVEL <= VP_LOG_LEVEL_TRACE
+#	define VP_LOG_TRACE(...) VP_LOG_IMPL_TRACE(__VA_ARGS__)
+#else
+#	define VP_LOG_TRACE(...) ((void)0)
+#endif
+
+#if VP_LOG_LEVEL <= VP_LOG_LEVEL_DEBUG
+#	define VP_LOG_DEBUG(...) VP_LOG_IMPL_DEBUG(__VA_ARGS__)
+#else
+#	define VP_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if VP_LOG_LEVEL <= VP_LOG_LEVEL_INFO
+#	define VP_LOG_INFO(...) VP_LOG_IMPL_INFO(__VA_ARGS__)
+#else
+#	define VP_LOG_INFO(...) ((void)0)
+#endif
+
+#if VP_LOG_LEVEL <= VP_LOG_LEVEL_WARN
+#	define VP_LOG_WARN(...) VP_LOG_IMPL_WARN(__VA_ARGS__)
+#else
+#	define VP_LOG_WARN(...) ((void)0)
+#endif
+
+#if VP_LOG_LEVEL <= VP_LOG_LEVEL_ERROR
+#	define VP_LOG_ERROR(...) VP_LOG_IMPL_ERROR(__VA_ARGS__)
+#else
+#	define VP_LOG_ERROR(...) ((void)0)
+#endif
+
+#if VP_LOG_LEVEL <= VP_LOG_LEVEL_CRITICAL
+#	define VP_LOG_CRITICAL(...) VP_LOG_IMPL_CRITICAL(__VA_ARGS__)
 #else
-#	include <iostream>
-#	include <format>
-#	define VP_LOG_TRACE(...) std::cout << std::format(__VA_ARGS__) << '\n'
-#	define VP_LOG_DEBUG(...) std::cout << std::format(__VA_ARGS__) << '\n'
-#	define VP_LOG_INFO(...) std::cout << std::format(__VA_ARGS__) << '\n'
-#	define VP_LOG_WARN(...) std::cout << std::format(__VA_ARGS__) << '\n'
-#	define VP_LOG_ERROR(...) std::cerr << std::format(__VA_ARGS__) << '\n'
-#	define VP_LOG_CRITICAL(...) std::cerr << std::format(__VA_ARGS__) << '\n'
-#endif
\ No newline at end of file
+#	define VP_LOG_CRITICAL(...) ((void)0)
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+/*!
+Asynchronous logger used by the `VP_LOG_*` macros when spdlog isn't available.
+
+A message is formatted on the calling thread only if its level passes the runtime check,
+then copied into that thread's lock free ring. A writer thread started by `entry_init`
+drains every ring, orders the lines by time and writes them in batches, warnings and below
+to stdout, errors and above to stderr. Critical messages are written before the call returns.
+stderr is flushed on every write, stdout when the writer goes idle, every 100 ms and on `flush`.
+When a ring fills up the caller drains it itself, nothing is dropped.
+
+Before `start` and after `stop` messages are written synchronously.
+
+Needs Improvment:
+- Arguments are still formatted on the calling thread, only the write is deferred
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace vulpengine::logger {
+	enum class Level : std::uint8_t {
+		kTrace,
+		kDebug,
+		kInfo,
+		kWarn,
+		kError,
+		kCritical,
+		kOff
+	};
+
+	namespace detail {
+		extern std::atomic<Level> gLevel;
+
+		inline constexpr std::size_t kLineBufferSize = 512;
+
+		char* line_buffer(); // kLineBufferSize chars
+		std::string& format_buffer(); // For lines that don't fit the line buffer
+		void submit(Level level, std::string_view message);
+	}
+
+	inline bool should_log(Level level) {
+		return level >= detail::gLevel.load(std::memory_order_relaxed);
+	}
+
+	template<class... Args>
+	inline void write(Level level, std::format_string<Args...> format, Args&&... args) {
+		if (!should_log(level)) return;
+
+		// A fixed buffer avoids std::string's growth checks, formatting doesn't move from the arguments
+		char* const line = detail::line_buffer();
+		auto const result = std::format_to_n(line, detail::kLineBufferSize, format, std::forward<Args>(args)...);
+
+		if (static_cast<std::size_t>(result.size) <= detail::kLineBufferSize) {
+			detail::submit(level, std::string_view(line, static_cast<std::size_t>(result.size)));
+			return;
+		}
+
+		std::string& buffer = detail::format_buffer();
+		buffer.clear();
+		std::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+		detail::submit(level, buffer);
+	}
+
+	// Runtime threshold, everything compiled in is logged by default
+	inline void set_level(Level level) { detail::gLevel.store(level, std::memory_order_relaxed); }
+	inline Level level() { return detail::gLevel.load(std::memory_order_relaxed); }
+
+	// Called by entry_init and entry_uninit, stop writes everything still queued
+	void start();
+	void stop();
+	bool running();
+
+	// Writes everything queued so far before returning
+	void flush();
+
+	// Where lines go, stdout and stderr by default
+	void set_files(std::FILE* out, std::FILE* err);
+
+	char const* to_string(Level level);
+}
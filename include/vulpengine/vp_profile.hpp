@@ -2,7 +2,10 @@
 
 /*!
 Profiling. If tracy is supported these macros can be used to instument your code.
-Otherwise these do nothing.
+Without tracy CPU zones go to the built in profiler (vp_cpu_profiler.hpp) and
+GPU zones to the active `GpuProfiler`.
+
+The `_N` variants name the zone, the name must be a string literal.
 */
 
 #include "vulpengine/vp_features.hpp"
@@ -13,11 +16,25 @@ Otherwise these do nothing.
 #	include <tracy/TracyOpenGL.hpp>
 #	define VP_PROFILE_GPU_CONTEXT TracyGpuContext
 #	define VP_PROFILE_CPU ZoneScoped
+#	define VP_PROFILE_CPU_N(name) ZoneScopedN(name)
 #	define VP_PROFILE_GPU TracyGpuZone(TracyFunction)
+#	define VP_PROFILE_GPU_N(name) TracyGpuZone(name)
 #	define VP_PROFILE_FRAME TracyGpuCollect; FrameMark
 #else
+#	include "vulpengine/experimental/vp_cpu_profiler.hpp"
+#	define VP_PROFILE_IMPL_CONCAT2(a, b) a##b
+#	define VP_PROFILE_IMPL_CONCAT(a, b) VP_PROFILE_IMPL_CONCAT2(a, b)
 #	define VP_PROFILE_GPU_CONTEXT
-#	define VP_PROFILE_CPU
-#	define VP_PROFILE_GPU
-#	define VP_PROFILE_FRAME
-#endif
\ No newline at end of file
+#	define VP_PROFILE_CPU VP_PROFILE_CPU_N(__func__)
+#	define VP_PROFILE_CPU_N(name) vulpengine::experimental::profiler::Zone VP_PROFILE_IMPL_CONCAT(vpCpuZone, __LINE__)(name)
+#	ifdef VP_LIB_GLAD
+#		include "vulpengine/experimental/vp_gpu_profiler.hpp"
+#		define VP_PROFILE_GPU VP_PROFILE_GPU_N(__func__)
+#		define VP_PROFILE_GPU_N(name) vulpengine::experimental::GpuProfiler::Zone VP_PROFILE_IMPL_CONCAT(vpGpuZone, __LINE__)(vulpengine::experimental::GpuProfiler::active(), name)
+#		define VP_PROFILE_FRAME do { vulpengine::experimental::profiler::frame(); if (auto* vpGpuProfiler = vulpengine::experimental::GpuProfiler::active()) vpGpuProfiler->frame(); } while (false)
+#	else
+#		define VP_PROFILE_GPU
+#		define VP_PROFILE_GPU_N(name)
+#		define VP_PROFILE_FRAME vulpengine::experimental::profiler::frame()
+#	endif
+#endif
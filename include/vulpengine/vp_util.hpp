@@ -1,12 +1,16 @@
 #pragma once
 
 #include "vulpengine/vp_transform.hpp"
+#include "vulpengine/vp_flat_map.hpp"
 
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <filesystem>
 
@@ -40,15 +44,140 @@ namespace vulpengine::helpers {
 }
 
 namespace vulpengine {
+	// 64 bit FNV-1a, usable at compile time, not suitable for cryptographic use
+	constexpr std::uint64_t hash_fnv1a(std::string_view str, std::uint64_t hash = 14695981039346656037ull) {
+		for (char c : str) {
+			hash ^= static_cast<std::uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Hashes 8 bytes a step, for hash tables rather than persisted ids which use hash_fnv1a.
+	// Runtime loads are native endian, so compile time results only match on little endian targets
+	constexpr std::uint64_t hash_string(std::string_view str) {
+		constexpr std::uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+
+		auto load = [&](std::size_t offset, std::size_t count) -> std::uint64_t {
+			std::uint64_t word = 0;
+			if (std::is_constant_evaluated()) {
+				for (std::size_t i = 0; i < count; ++i) word |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(str[offset + i])) << (i * 8);
+			} else if (count == 8) {
+				std::memcpy(&word, str.data() + offset, 8);
+			} else {
+				std::uint32_t half;
+				std::memcpy(&half, str.data() + offset, 4);
+				word = half;
+			}
+			return word;
+		};
+
+		auto step = [&](std::uint64_t hash, std::uint64_t word) {
+			hash = (hash ^ word) * kMultiplier;
+			return hash ^ (hash >> 29);
+		};
+
+		std::size_t const size = str.size();
+		std::uint64_t hash = 0x243F6A8885A308D3ull ^ size;
+
+		if (size >= 8) {
+			std::size_t i = 0;
+			for (; i + 8 < size; i += 8) hash = step(hash, load(i, 8));
+			return step(hash, load(size - 8, 8)); // Overlaps the previous word when the size isn't a multiple of 8
+		}
+
+		if (size >= 4) return step(hash, load(0, 4) | load(size - 4, 4) << 32);
+
+		if (size > 0) {
+			std::uint64_t const word = static_cast<std::uint8_t>(str[0]) | static_cast<std::uint64_t>(static_cast<std::uint8_t>(str[size / 2])) << 8 | static_cast<std::uint64_t>(static_cast<std::uint8_t>(str[size - 1])) << 16;
+			return step(hash, word);
+		}
+
+		return hash;
+	}
+
+	// A string hashed at compile time, lookups keyed by these never hash at runtime.
+	// Only the hash is kept, so construct these from literals: `"uModel"_sid`
+	struct StringId final {
+		std::uint64_t hash = 0;
+
+		constexpr StringId() noexcept = default;
+		consteval explicit StringId(std::string_view str) noexcept : hash(hash_fnv1a(str)) {}
+
+		// For names only known at runtime
+		static constexpr StringId from_runtime(std::string_view str) noexcept {
+			StringId id;
+			id.hash = hash_fnv1a(str);
+			return id;
+		}
+
+		constexpr bool operator==(StringId const&) const noexcept = default;
+	};
+
+	inline namespace literals {
+		consteval StringId operator""_sid(char const* str, std::size_t length) noexcept {
+			return StringId(std::string_view(str, length));
+		}
+	}
+
+	namespace detail {
+		struct InternEntry final {
+			std::uint64_t hash;
+			std::size_t length;
+			char const* text; // Null terminated
+		};
+
+		inline constexpr InternEntry kEmptyInternEntry = { hash_string(""), 0, "" };
+	}
+
+	// A string stored once in a global table that lives until exit, see `intern`.
+	// Equal strings share an entry, so comparing is a pointer compare and the hash was computed when interning.
+	// Hashes match `StringMultiHash`.
+	class InternedString final {
+	public:
+		constexpr InternedString() noexcept = default;
+
+		inline std::string_view view() const { return { mEntry->text, mEntry->length }; }
+		inline char const* c_str() const { return mEntry->text; }
+		inline std::uint64_t hash() const { return mEntry->hash; }
+		inline std::size_t size() const { return mEntry->length; }
+		inline bool empty() const { return mEntry->length == 0; }
+
+		inline operator std::string_view() const { return view(); }
+
+		constexpr bool operator==(InternedString const&) const noexcept = default;
+	private:
+		friend InternedString intern(std::string_view str);
+
+		constexpr explicit InternedString(detail::InternEntry const* entry) noexcept : mEntry(entry) {}
+
+		detail::InternEntry const* mEntry = &detail::kEmptyInternEntry;
+	};
+
+	// Thread safe, takes a lock so intern names when loading rather than for every lookup
+	InternedString intern(std::string_view str);
+
+	// Interned strings reuse their hash, everything else hashes its characters
 	struct StringMultiHash final {
-		using hash_type = std::hash<std::string_view>;
 		using is_transparent = void;
-		std::size_t operator()(char const* str) const { return hash_type{}(str); }
-		std::size_t operator()(std::string_view str) const { return hash_type{}(str); }
-		std::size_t operator()(std::string const& str) const { return hash_type{}(str); }
+		std::size_t operator()(char const* str) const { return hash_string(str); }
+		std::size_t operator()(std::string_view str) const { return hash_string(str); }
+		std::size_t operator()(std::string const& str) const { return hash_string(str); }
+		std::size_t operator()(InternedString str) const { return str.hash(); }
 	};
 
-	template<class V> using UnorderedStringMap = std::unordered_map<std::string, V, StringMultiHash, std::equal_to<>>;
+	struct StringEqual final {
+		using is_transparent = void;
+		bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+		bool operator()(InternedString a, InternedString b) const { return a == b; }
+	};
+
+	// Looked up by `std::string`, `std::string_view`, `char const*` or `InternedString` without a copy,
+	// an InternedString isn't hashed again
+	template<class V> using UnorderedStringMap = FlatMap<std::string, V, StringMultiHash, StringEqual>;
+
+	// Keyed by interned strings, lookups by interned string compare pointers
+	template<class V> using InternedStringMap = FlatMap<InternedString, V, StringMultiHash, StringEqual>;
 
 	template<class... Callable>
 	struct Visitor : Callable... {
@@ -3,6 +3,16 @@
 /*!
 Wrapper for a GLFW window.
 Automatically handles glfwInit and glfwTerminate
+
+A headless window has no visible surface and renders into `Framebuffer`s only.
+On Linux it is an EGL context without a surface (surfaceless, pbuffer if unsupported),
+which works on display-less machines under Mesa llvmpipe or a GPU's EGL device.
+When EGL is unavailable it falls back to a hidden GLFW window, on the GLFW null platform
+if GLFW wasn't already initialized.
+
+Needs Improvment:
+- The null platform is chosen at glfwInit, visible windows created after a headless
+  fallback window (while it's still alive) won't be visible
 */
 
 #include "vulpengine/vp_features.hpp"
@@ -15,6 +25,10 @@ Automatically handles glfwInit and glfwTerminate
 // Avoid including entire GLFW header
 extern "C" typedef struct GLFWwindow GLFWwindow;
 
+namespace vulpengine::detail {
+	struct HeadlessContext;
+}
+
 namespace vulpengine {
 	class Window final {
 	public:
@@ -22,6 +36,7 @@ namespace vulpengine {
 			int width = 0, height = 0;
 			char const* title = nullptr;
 			bool maximized = false;
+			bool headless = false;
 		};
 
 		constexpr Window() noexcept = default;
@@ -32,10 +47,12 @@ namespace vulpengine {
 		Window& operator=(Window&& other) noexcept;
 		~Window() noexcept;
 
+		// Null for headless EGL windows, there is no GLFW window behind them
 		inline operator GLFWwindow*() const { return mHandle; }
-		inline explicit operator bool() const { return mHandle != nullptr; }
-		inline bool valid() const { return mHandle != nullptr; }
+		inline explicit operator bool() const { return valid(); }
+		inline bool valid() const { return mHandle != nullptr || mHeadless != nullptr; }
 		inline GLFWwindow* handle() const { return mHandle; }
+		inline bool headless() const { return mHeadless != nullptr || mHidden; }
 
 		bool should_close() const;
 		void swap_buffers() const;
@@ -45,6 +62,8 @@ namespace vulpengine {
 		static bool load_gl();
 	private:
 		GLFWwindow* mHandle = nullptr;
+		detail::HeadlessContext* mHeadless = nullptr;
+		bool mHidden = false; // Headless GLFW fallback
 	};
 }
 #endif // VP_HAS_GLFW
\ No newline at end of file
@@ -0,0 +1,479 @@
+#include "vulpengine/experimental/vp_archive.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_util.hpp"
+#include "vulpengine/vp_profile.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <fstream>
+
+// These platform files should define `class MappedFile` with
+// `bool open(std::filesystem::path const& path)` and `std::span<std::byte const> bytes() const`
+// the mapping lives until the MappedFile is destroyed
+
+#ifdef VP_WINDOWS
+#	include "vp_archive_win.inl"
+#endif
+
+#ifdef VP_LINUX
+#	include "vp_archive_linux.inl"
+#endif
+
+static_assert(std::endian::native == std::endian::little, "Archives are read in place and stored little endian");
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr std::uint32_t kArchiveMagic = 0x4B415056; // "VPAK"
+		constexpr std::uint32_t kArchiveVersion = 1;
+		constexpr std::uint64_t kEntryAlignment = 64;
+
+		constexpr std::uint32_t kEntryCompressed = 1 << 0;
+
+		struct Header final {
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t entryCount;
+			std::uint64_t indexOffset;
+			std::uint64_t pathsOffset;
+			std::uint64_t pathsSize;
+		};
+
+		// Sorted by hash then path
+		struct IndexEntry final {
+			std::uint64_t hash;
+			std::uint64_t offset;
+			std::uint64_t size;
+			std::uint64_t storedSize;
+			std::uint32_t pathOffset;
+			std::uint32_t pathLength;
+			std::uint32_t flags;
+			std::uint32_t reserved;
+		};
+
+		static_assert(sizeof(Header) == 40 && sizeof(IndexEntry) == 48);
+
+		constexpr std::uint64_t align_up(std::uint64_t value, std::uint64_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		// Everything is checked once on open so lookups and reads never have to, returns why the archive is invalid
+		char const* validate(std::span<std::byte const> bytes, Header& header) {
+			if (bytes.size() < sizeof(Header)) return "truncated header";
+			std::memcpy(&header, bytes.data(), sizeof(Header));
+
+			if (header.magic != kArchiveMagic) return "not an archive";
+			if (header.version != kArchiveVersion) return "unsupported version";
+
+			if (header.indexOffset % alignof(IndexEntry) != 0 || header.indexOffset > bytes.size()
+				|| header.entryCount > (bytes.size() - header.indexOffset) / sizeof(IndexEntry))
+				return "index out of range";
+
+			if (header.pathsOffset > bytes.size() || header.pathsSize > bytes.size() - header.pathsOffset)
+				return "paths out of range";
+
+			std::span const index(reinterpret_cast<IndexEntry const*>(bytes.data() + header.indexOffset), static_cast<std::size_t>(header.entryCount));
+
+			for (IndexEntry const& entry : index) {
+				if (entry.offset > bytes.size() || entry.storedSize > bytes.size() - entry.offset) return "entry out of range";
+				if (entry.pathOffset > header.pathsSize || entry.pathLength > header.pathsSize - entry.pathOffset) return "path out of range";
+				if (!(entry.flags & kEntryCompressed) && entry.storedSize != entry.size) return "entry size mismatch";
+			}
+
+			return nullptr;
+		}
+	}
+
+	// Greedy LZ77 with 4 byte minimum matches and a single probe hash table,
+	// written in the LZ4 block format: [token][literal length...][literals][offset][match length...]
+	namespace lz {
+		namespace {
+			constexpr std::size_t kMinMatch = 4;
+			constexpr std::size_t kLastLiterals = 5; // The block ends with at least this many literals
+			constexpr std::size_t kMatchSearchEnd = 12; // No match starts this close to the end
+			constexpr std::size_t kMaxOffset = 65535;
+			constexpr int kHashBits = 12;
+
+			inline std::uint32_t read_u32(std::byte const* bytes) {
+				std::uint32_t value;
+				std::memcpy(&value, bytes, sizeof(value));
+				return value;
+			}
+
+			inline std::uint32_t hash_sequence(std::uint32_t sequence) {
+				return (sequence * 2654435761u) >> (32 - kHashBits);
+			}
+
+			class BlockWriter final {
+			public:
+				BlockWriter(std::span<std::byte> output) : mOutput(output) {}
+
+				// Lengths of 15 and above spill into following bytes of 255 until one is smaller
+				bool length(std::size_t value) {
+					for (; value >= 255; value -= 255)
+						if (!byte(255)) return false;
+					return byte(static_cast<std::uint8_t>(value));
+				}
+
+				bool byte(std::uint8_t value) {
+					if (mPosition == mOutput.size()) return false;
+					mOutput[mPosition++] = std::byte{ value };
+					return true;
+				}
+
+				bool bytes(std::byte const* data, std::size_t size) {
+					if (mOutput.size() - mPosition < size) return false;
+					if (size) std::memcpy(mOutput.data() + mPosition, data, size);
+					mPosition += size;
+					return true;
+				}
+
+				bool sequence(std::byte const* literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength) {
+					std::size_t const matchCode = matchLength ? matchLength - kMinMatch : 0;
+					std::uint8_t const token = static_cast<std::uint8_t>((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15));
+
+					if (!byte(token)) return false;
+					if (literalCount >= 15 && !length(literalCount - 15)) return false;
+					if (!bytes(literals, literalCount)) return false;
+					if (!matchLength) return true; // Last sequence
+
+					if (!byte(static_cast<std::uint8_t>(offset)) || !byte(static_cast<std::uint8_t>(offset >> 8))) return false;
+					return matchCode < 15 || length(matchCode - 15);
+				}
+
+				inline std::size_t size() const { return mPosition; }
+			private:
+				std::span<std::byte> mOutput;
+				std::size_t mPosition = 0;
+			};
+		}
+
+		std::size_t compress(std::span<std::byte const> input, std::span<std::byte> output) {
+			std::byte const* const source = input.data();
+			std::size_t const size = input.size();
+
+			BlockWriter writer(output);
+			std::size_t anchor = 0;
+
+			if (size > kMatchSearchEnd) {
+				std::array<std::uint32_t, 1 << kHashBits> table{};
+				std::size_t const searchEnd = size - kMatchSearchEnd;
+				std::size_t const matchEnd = size - kLastLiterals;
+				std::size_t position = 0;
+
+				while (position < searchEnd) {
+					std::uint32_t const sequence = read_u32(source + position);
+					std::uint32_t& slot = table[hash_sequence(sequence)];
+					std::size_t candidate = slot;
+					slot = static_cast<std::uint32_t>(position);
+
+					if (candidate >= position || position - candidate > kMaxOffset || read_u32(source + candidate) != sequence) {
+						// Incompressible data is skipped through faster the longer it goes without a match
+						position += 1 + ((position - anchor) >> 6);
+						continue;
+					}
+
+					std::size_t length = kMinMatch;
+					while (position + length < matchEnd && source[candidate + length] == source[position + length])
+						++length;
+
+					while (position > anchor && candidate > 0 && source[position - 1] == source[candidate - 1]) {
+						--position;
+						--candidate;
+						++length;
+					}
+
+					if (!writer.sequence(source + anchor, position - anchor, position - candidate, length)) return 0;
+
+					position += length;
+					anchor = position;
+				}
+			}
+
+			if (!writer.sequence(source + anchor, size - anchor, 0, 0)) return 0;
+			return writer.size();
+		}
+
+		bool decompress(std::span<std::byte const> input, std::span<std::byte> output) {
+			std::size_t in = 0, out = 0;
+
+			auto read_length = [&](std::size_t& length) {
+				std::uint8_t value;
+				do {
+					if (in == input.size()) return false;
+					value = std::to_integer<std::uint8_t>(input[in++]);
+					length += value;
+				} while (value == 255);
+				return true;
+			};
+
+			while (true) {
+				if (in == input.size()) return false;
+				std::uint8_t const token = std::to_integer<std::uint8_t>(input[in++]);
+
+				std::size_t literals = token >> 4;
+				if (literals == 15 && !read_length(literals)) return false;
+				if (literals > input.size() - in || literals > output.size() - out) return false;
+
+				if (literals) std::memcpy(output.data() + out, input.data() + in, literals);
+				in += literals;
+				out += literals;
+
+				if (in == input.size()) return out == output.size();
+
+				if (input.size() - in < 2) return false;
+				std::size_t const offset = std::to_integer<std::size_t>(input[in]) | std::to_integer<std::size_t>(input[in + 1]) << 8;
+				in += 2;
+				if (offset == 0 || offset > out) return false;
+
+				std::size_t length = token & 15;
+				if (length == 15 && !read_length(length)) return false;
+				length += kMinMatch;
+				if (length > output.size() - out) return false;
+
+				std::byte* destination = output.data() + out;
+				std::byte const* match = destination - offset;
+
+				// Overlapping matches repeat the last `offset` bytes, they have to be copied forwards one at a time
+				if (offset >= length) {
+					std::memcpy(destination, match, length);
+				} else {
+					for (std::size_t i = 0; i < length; ++i)
+						destination[i] = match[i];
+				}
+
+				out += length;
+			}
+		}
+	}
+
+	std::string archive_path(std::filesystem::path const& path) {
+		std::filesystem::path normal = path.lexically_normal();
+
+		if (normal.is_absolute()) {
+			std::error_code ec;
+			std::filesystem::path const current = std::filesystem::current_path(ec);
+			if (!ec) normal = normal.lexically_relative(current);
+		}
+
+		std::string result = normal.generic_string();
+		if (result == ".") result.clear();
+		if (result.starts_with("./")) result.erase(0, 2);
+		return result;
+	}
+
+	struct Archive::Impl final {
+		MappedFile file;
+		std::span<IndexEntry const> index;
+		char const* paths = nullptr;
+
+		std::string_view path(IndexEntry const& entry) const {
+			return { paths + entry.pathOffset, entry.pathLength };
+		}
+
+		std::span<std::byte const> stored(IndexEntry const& entry) const {
+			return file.bytes().subspan(entry.offset, entry.storedSize);
+		}
+	};
+
+	Archive::Archive() noexcept = default;
+
+	Archive::Archive(std::filesystem::path const& path) {
+		VP_PROFILE_CPU;
+
+		auto impl = std::make_unique<Impl>();
+		if (!impl->file.open(path)) {
+			VP_LOG_ERROR("Unable to map archive {}", path.string());
+			return;
+		}
+
+		std::span<std::byte const> const bytes = impl->file.bytes();
+
+		Header header;
+		if (char const* error = validate(bytes, header)) {
+			VP_LOG_ERROR("Invalid archive {}: {}", path.string(), error);
+			return;
+		}
+
+		impl->index = { reinterpret_cast<IndexEntry const*>(bytes.data() + header.indexOffset), static_cast<std::size_t>(header.entryCount) };
+		impl->paths = reinterpret_cast<char const*>(bytes.data() + header.pathsOffset);
+
+		mImpl = std::move(impl);
+	}
+
+	Archive::Archive(Archive&&) noexcept = default;
+	Archive& Archive::operator=(Archive&&) noexcept = default;
+	Archive::~Archive() noexcept = default;
+
+	std::optional<std::size_t> Archive::find(std::string_view path) const {
+		assert(valid());
+
+		std::uint64_t const hash = hash_fnv1a(path);
+		auto it = std::lower_bound(mImpl->index.begin(), mImpl->index.end(), hash, [](IndexEntry const& entry, std::uint64_t hash) { return entry.hash < hash; });
+
+		for (; it != mImpl->index.end() && it->hash == hash; ++it)
+			if (mImpl->path(*it) == path) return static_cast<std::size_t>(it - mImpl->index.begin());
+
+		return std::nullopt;
+	}
+
+	std::size_t Archive::entry_count() const {
+		assert(valid());
+		return mImpl->index.size();
+	}
+
+	Archive::Entry Archive::entry(std::size_t index) const {
+		assert(valid() && index < mImpl->index.size());
+		IndexEntry const& entry = mImpl->index[index];
+		return { mImpl->path(entry), entry.size, (entry.flags & kEntryCompressed) != 0 };
+	}
+
+	std::span<std::byte const> Archive::view(std::size_t index) const {
+		assert(valid() && index < mImpl->index.size());
+		IndexEntry const& entry = mImpl->index[index];
+		if (entry.flags & kEntryCompressed) return {};
+		return mImpl->stored(entry);
+	}
+
+	bool Archive::read(std::size_t index, std::span<std::byte> output) const {
+		assert(valid() && index < mImpl->index.size());
+		IndexEntry const& entry = mImpl->index[index];
+
+		if (output.size() != entry.size) {
+			VP_LOG_ERROR("Archive read of {} expects {} bytes, got {}", mImpl->path(entry), entry.size, output.size());
+			return false;
+		}
+
+		std::span<std::byte const> const stored = mImpl->stored(entry);
+
+		if (!(entry.flags & kEntryCompressed)) {
+			if (!stored.empty()) std::memcpy(output.data(), stored.data(), stored.size());
+			return true;
+		}
+
+		VP_PROFILE_CPU;
+
+		if (!lz::decompress(stored, output)) {
+			VP_LOG_ERROR("Archive entry {} is corrupt", mImpl->path(entry));
+			return false;
+		}
+
+		return true;
+	}
+
+	void ArchiveBuilder::add(std::filesystem::path const& path, std::span<std::byte const> data, bool compress) {
+		Pending pending;
+		pending.path = archive_path(path);
+		pending.size = data.size();
+
+		// Only worth decompressing if it saves at least an eighth
+		if (compress && data.size() >= 64) {
+			pending.stored.resize(lz::compress_bound(data.size()));
+			std::size_t const size = lz::compress(data, pending.stored);
+
+			if (size && size <= data.size() - data.size() / 8) {
+				pending.stored.resize(size);
+				pending.compressed = true;
+			}
+		}
+
+		if (!pending.compressed)
+			pending.stored.assign(data.begin(), data.end());
+
+		auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](Pending const& entry) { return entry.path == pending.path; });
+		if (it != mEntries.end()) {
+			VP_LOG_WARN("Archive entry {} added twice, keeping the last", pending.path);
+			*it = std::move(pending);
+			return;
+		}
+
+		mEntries.push_back(std::move(pending));
+	}
+
+	bool ArchiveBuilder::add_file(std::filesystem::path const& file, bool compress) {
+		std::optional<std::vector<char>> contents = read_file(file);
+		if (!contents) {
+			VP_LOG_ERROR("Unable to read {}", file.string());
+			return false;
+		}
+
+		add(file, std::as_bytes(std::span(*contents)), compress);
+		return true;
+	}
+
+	bool ArchiveBuilder::write(std::filesystem::path const& path) const {
+		VP_PROFILE_CPU;
+
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file) {
+			VP_LOG_ERROR("Unable to write archive {}", path.string());
+			return false;
+		}
+
+		std::uint64_t position = 0;
+		auto write = [&](void const* data, std::size_t size) {
+			file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+			position += size;
+		};
+
+		auto pad = [&](std::uint64_t alignment) {
+			static constexpr std::array<char, kEntryAlignment> kZeros{};
+			write(kZeros.data(), align_up(position, alignment) - position);
+		};
+
+		std::vector<IndexEntry> index;
+		index.reserve(mEntries.size());
+
+		std::string paths;
+
+		Header header = {};
+		write(&header, sizeof(Header)); // Rewritten once the offsets are known
+
+		for (Pending const& entry : mEntries) {
+			pad(kEntryAlignment);
+
+			index.push_back({
+				.hash = hash_fnv1a(entry.path),
+				.offset = position,
+				.size = entry.size,
+				.storedSize = entry.stored.size(),
+				.pathOffset = static_cast<std::uint32_t>(paths.size()),
+				.pathLength = static_cast<std::uint32_t>(entry.path.size()),
+				.flags = entry.compressed ? kEntryCompressed : 0u,
+				.reserved = 0,
+			});
+
+			paths += entry.path;
+			write(entry.stored.data(), entry.stored.size());
+		}
+
+		std::sort(index.begin(), index.end(), [&](IndexEntry const& a, IndexEntry const& b) {
+			if (a.hash != b.hash) return a.hash < b.hash;
+			return std::string_view(paths).substr(a.pathOffset, a.pathLength) < std::string_view(paths).substr(b.pathOffset, b.pathLength);
+		});
+
+		pad(kEntryAlignment);
+		header.indexOffset = position;
+		write(index.data(), index.size() * sizeof(IndexEntry));
+
+		header.pathsOffset = position;
+		header.pathsSize = paths.size();
+		write(paths.data(), paths.size());
+
+		header.magic = kArchiveMagic;
+		header.version = kArchiveVersion;
+		header.entryCount = index.size();
+		file.seekp(0);
+		file.write(reinterpret_cast<char const*>(&header), sizeof(Header));
+
+		if (!file) {
+			VP_LOG_ERROR("Failed writing archive {}", path.string());
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,42 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	class MappedFile final {
+	public:
+		MappedFile() noexcept = default;
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		~MappedFile() noexcept {
+			if (mData) munmap(mData, mSize);
+		}
+
+		bool open(std::filesystem::path const& path) {
+			int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd == -1) return false;
+
+			struct stat info;
+			if (fstat(fd, &info) == -1 || info.st_size <= 0) {
+				close(fd);
+				return false;
+			}
+
+			void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd); // The mapping keeps the file alive
+
+			if (data == MAP_FAILED) return false;
+
+			mData = data;
+			mSize = static_cast<std::size_t>(info.st_size);
+			return true;
+		}
+
+		inline std::span<std::byte const> bytes() const { return { static_cast<std::byte const*>(mData), mSize }; }
+	private:
+		void* mData = nullptr;
+		std::size_t mSize = 0;
+	};
+}
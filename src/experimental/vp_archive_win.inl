@@ -0,0 +1,45 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+namespace {
+	class MappedFile final {
+	public:
+		MappedFile() noexcept = default;
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		~MappedFile() noexcept {
+			if (mData) UnmapViewOfFile(mData);
+		}
+
+		bool open(std::filesystem::path const& path) {
+			HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+				CloseHandle(file);
+				return false;
+			}
+
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+			if (!mapping) return false;
+
+			void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping); // The view keeps the mapping alive
+
+			if (!data) return false;
+
+			mData = data;
+			mSize = static_cast<std::size_t>(size.QuadPart);
+			return true;
+		}
+
+		inline std::span<std::byte const> bytes() const { return { static_cast<std::byte const*>(mData), mSize }; }
+	private:
+		void* mData = nullptr;
+		std::size_t mSize = 0;
+	};
+}
@@ -0,0 +1,386 @@
+#include "vulpengine/experimental/vp_assets.hpp"
+
+#if defined(VP_HAS_SHADER_PROGRAM) && defined(VP_HAS_STB_IMAGE)
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+#include "vulpengine/experimental/vp_archive.hpp"
+#include "vulpengine/experimental/vp_task.hpp"
+#include "vulpengine/experimental/vp_vfs.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vulpengine::experimental {
+	namespace {
+		using State = AssetCache::State;
+
+		struct TextureData final {
+			AssetCache::TextureInfo info;
+			Task<Image> pending; // The first load or a reload
+		};
+
+		struct ShaderData final {
+			std::vector<std::string> defines;
+		};
+
+		template<class T, class Data>
+		struct Slot final {
+			std::uint32_t generation = 1;
+			std::uint32_t refs = 0;
+			State state = State::kReleased;
+			T asset;
+			std::string key;
+			std::filesystem::path path;
+			std::filesystem::file_time_type writeTime;
+			Data data;
+		};
+
+		// Retired GL objects, destroyed once the GPU is done with them
+		template<class T>
+		struct Retired final {
+			std::uint64_t frame;
+			T asset;
+		};
+
+		template<class T, class Data>
+		struct Pool final {
+			std::deque<Slot<T, Data>> slots; // Stable addresses, `get` hands out pointers into them
+			std::vector<std::uint32_t> free;
+			UnorderedStringMap<std::uint32_t> keys;
+			std::vector<Retired<T>> retired;
+
+			Slot<T, Data>* find(AssetHandle<T> handle) {
+				if (handle.index >= slots.size()) return nullptr;
+				Slot<T, Data>& slot = slots[handle.index];
+				if (slot.generation != handle.generation || slot.state == State::kReleased) return nullptr;
+				return &slot;
+			}
+
+			Slot<T, Data> const* find(AssetHandle<T> handle) const {
+				return const_cast<Pool*>(this)->find(handle);
+			}
+
+			// The slot already keyed `key` with a new reference, or a new slot
+			std::pair<AssetHandle<T>, bool> acquire(std::string key) {
+				if (auto it = keys.find(key); it != keys.end()) {
+					Slot<T, Data>& slot = slots[it->second];
+					++slot.refs;
+					return { { it->second, slot.generation }, false };
+				}
+
+				std::uint32_t index;
+				if (free.empty()) {
+					index = static_cast<std::uint32_t>(slots.size());
+					slots.emplace_back();
+				} else {
+					index = free.back();
+					free.pop_back();
+				}
+
+				Slot<T, Data>& slot = slots[index];
+				slot.refs = 1;
+				slot.state = State::kLoading;
+				slot.key = key;
+				keys.emplace(std::move(key), index);
+				return { { index, slot.generation }, true };
+			}
+
+			void retire(T&& asset, std::uint64_t frame) {
+				if (asset) retired.push_back({ frame, std::move(asset) });
+			}
+
+			// Bumping the generation makes every handle to the slot stale
+			void clear(std::uint32_t index, std::uint64_t frame) {
+				Slot<T, Data>& slot = slots[index];
+				keys.erase(slot.key);
+				retire(std::move(slot.asset), frame);
+				slot.asset = T();
+				slot.state = State::kReleased;
+				slot.refs = 0;
+				slot.key.clear();
+				slot.path.clear();
+				slot.data = Data();
+				if (++slot.generation == 0) slot.generation = 1;
+				free.push_back(index);
+			}
+
+			void collect(std::uint64_t frame) {
+				std::erase_if(retired, [&](Retired<T> const& entry) { return entry.frame <= frame; });
+			}
+		};
+
+		// Archive entries are looked up by their lexical path. Loose files are keyed by where they
+		// really are, so `..` through a symlink or a detour out of the working directory finds them.
+		std::string key_path(std::filesystem::path const& path, std::string const& name) {
+			if (vfs::archived(name)) return name;
+
+			std::error_code ec;
+			std::filesystem::path const canonical = std::filesystem::weakly_canonical(path, ec);
+			return ec ? name : canonical.generic_string();
+		}
+
+		std::filesystem::file_time_type write_time(std::filesystem::path const& path) {
+			std::error_code ec;
+			return std::filesystem::last_write_time(path, ec);
+		}
+
+		void wait(Task<Image>& task) {
+			while (!task.done())
+				if (!jobs::run_one()) std::this_thread::yield();
+		}
+
+		Texture make_texture(Image const& image, AssetCache::TextureInfo const& info, std::string_view label) {
+			GLsizei const levels = info.mipmaps ? static_cast<GLsizei>(std::bit_width(static_cast<unsigned>(std::max(image.width(), image.height())))) : 1;
+
+			GLint minFilter = info.minFilter;
+			if (levels == 1 && minFilter != GL_NEAREST && minFilter != GL_LINEAR) minFilter = GL_LINEAR;
+
+			Texture texture({
+				.target = GL_TEXTURE_2D,
+				.width = image.width(),
+				.height = image.height(),
+				.internalFormat = static_cast<GLenum>(info.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8),
+				.minFilter = minFilter,
+				.magFilter = info.magFilter,
+				.wrap = info.wrap,
+				.label = label,
+				.levels = levels,
+				.anisotropy = info.anisotropy,
+			});
+
+			texture.upload(Texture::UploadInfo{}.with_image(image));
+			if (levels > 1) texture.generate_mips();
+			return texture;
+		}
+
+		std::string texture_key(std::string const& path, AssetCache::TextureInfo const& info) {
+			return std::format("{}|{}{}{}|{}|{}|{}|{}", path, int(info.flip), int(info.srgb), int(info.mipmaps), info.minFilter, info.magFilter, info.wrap, info.anisotropy);
+		}
+
+		std::string shader_key(std::string const& path, std::span<std::string_view const> defines) {
+			std::string key = path;
+			for (std::string_view define : defines) {
+				key += '|';
+				key += define;
+			}
+			return key;
+		}
+	}
+
+	struct AssetCache::Impl final {
+		CreateInfo info;
+		std::uint64_t frame = 0;
+		std::chrono::steady_clock::time_point nextWatch;
+
+		Pool<Texture, TextureData> textures;
+		Pool<ShaderProgram, ShaderData> shaders;
+		std::vector<Task<Image>> orphans; // Loads of textures released before they finished
+
+		// Tasks have to finish before they're destroyed
+		~Impl() noexcept {
+			for (Slot<Texture, TextureData>& slot : textures.slots)
+				if (slot.data.pending) wait(slot.data.pending);
+
+			for (Task<Image>& orphan : orphans) wait(orphan);
+		}
+
+		ShaderProgram build(Slot<ShaderProgram, ShaderData> const& slot) const {
+			std::vector<std::string_view> const defines(slot.data.defines.begin(), slot.data.defines.end());
+			std::string const file = slot.path.string();
+
+			return ShaderProgram({
+				.file = file.c_str(),
+				.includePath = info.includePath,
+				.defines = defines,
+				.cacheDirectory = info.cacheDirectory,
+			});
+		}
+
+		void start(Slot<Texture, TextureData>& slot) {
+			slot.writeTime = write_time(slot.path);
+			slot.data.pending = load_image(slot.path, slot.data.info.flip);
+			slot.data.pending.start();
+		}
+
+		std::size_t finish_textures() {
+			std::size_t finished = 0;
+
+			for (Slot<Texture, TextureData>& slot : textures.slots) {
+				Task<Image>& pending = slot.data.pending;
+				if (!pending || !pending.done()) continue;
+
+				Image const image = std::move(pending).result();
+				pending = Task<Image>();
+				++finished;
+
+				if (!image) {
+					// A failed reload keeps the version already loaded
+					if (slot.state == State::kLoading) slot.state = State::kFailed;
+					continue;
+				}
+
+				textures.retire(std::move(slot.asset), frame + info.deletionDelay);
+				slot.asset = make_texture(image, slot.data.info, slot.key);
+				slot.state = State::kReady;
+			}
+
+			return finished;
+		}
+
+		void watch() {
+			auto const now = std::chrono::steady_clock::now();
+			if (now < nextWatch) return;
+			nextWatch = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(info.watchInterval));
+
+			VP_PROFILE_CPU_N("AssetCache::watch");
+
+			for (Slot<Texture, TextureData>& slot : textures.slots) {
+				if (slot.state != State::kReady && slot.state != State::kFailed) continue;
+				if (slot.data.pending) continue;
+
+				std::filesystem::file_time_type const time = write_time(slot.path);
+				if (time == std::filesystem::file_time_type() || time == slot.writeTime) continue;
+
+				VP_LOG_INFO("Reloading {}", slot.path.string());
+				start(slot);
+			}
+
+			for (Slot<ShaderProgram, ShaderData>& slot : shaders.slots) {
+				if (slot.state != State::kReady && slot.state != State::kFailed) continue;
+
+				std::filesystem::file_time_type const time = write_time(slot.path);
+				if (time == std::filesystem::file_time_type() || time == slot.writeTime) continue;
+
+				VP_LOG_INFO("Reloading {}", slot.path.string());
+				reload(slot);
+			}
+		}
+
+		void reload(Slot<ShaderProgram, ShaderData>& slot) {
+			slot.writeTime = write_time(slot.path);
+			ShaderProgram program = build(slot);
+			if (!program) return; // Keeps the version already loaded, the error was logged
+
+			shaders.retire(std::move(slot.asset), frame + info.deletionDelay);
+			slot.asset = std::move(program);
+			slot.state = State::kReady;
+		}
+	};
+
+	AssetCache::AssetCache() : AssetCache(CreateInfo{}) {}
+
+	AssetCache::AssetCache(CreateInfo const& info) : mImpl(std::make_unique<Impl>()) {
+		mImpl->info = info;
+	}
+
+	AssetCache::AssetCache(AssetCache&&) noexcept = default;
+	AssetCache& AssetCache::operator=(AssetCache&&) noexcept = default;
+
+	AssetCache::~AssetCache() noexcept = default;
+
+	AssetHandle<Texture> AssetCache::texture(std::filesystem::path const& path, TextureInfo const& info) {
+		std::string const name = archive_path(path);
+		auto [handle, created] = mImpl->textures.acquire(texture_key(key_path(path, name), info));
+		if (!created) return handle;
+
+		Slot<Texture, TextureData>& slot = mImpl->textures.slots[handle.index];
+		slot.path = name;
+		slot.data.info = info;
+		mImpl->start(slot);
+		return handle;
+	}
+
+	AssetHandle<ShaderProgram> AssetCache::shader(std::filesystem::path const& path, std::span<std::string_view const> defines) {
+		std::string const name = archive_path(path);
+		auto [handle, created] = mImpl->shaders.acquire(shader_key(key_path(path, name), defines));
+		if (!created) return handle;
+
+		Slot<ShaderProgram, ShaderData>& slot = mImpl->shaders.slots[handle.index];
+		slot.path = name;
+		slot.data.defines.assign(defines.begin(), defines.end());
+		slot.state = State::kFailed;
+		mImpl->reload(slot);
+		return handle;
+	}
+
+	void AssetCache::retain(AssetHandle<Texture> handle) {
+		if (auto* slot = mImpl->textures.find(handle)) ++slot->refs;
+	}
+
+	void AssetCache::retain(AssetHandle<ShaderProgram> handle) {
+		if (auto* slot = mImpl->shaders.find(handle)) ++slot->refs;
+	}
+
+	void AssetCache::release(AssetHandle<Texture> handle) {
+		auto* slot = mImpl->textures.find(handle);
+		if (!slot || --slot->refs) return;
+
+		if (slot->data.pending) mImpl->orphans.push_back(std::move(slot->data.pending));
+		mImpl->textures.clear(handle.index, mImpl->frame + mImpl->info.deletionDelay);
+	}
+
+	void AssetCache::release(AssetHandle<ShaderProgram> handle) {
+		auto* slot = mImpl->shaders.find(handle);
+		if (!slot || --slot->refs) return;
+
+		mImpl->shaders.clear(handle.index, mImpl->frame + mImpl->info.deletionDelay);
+	}
+
+	Texture const* AssetCache::get(AssetHandle<Texture> handle) const {
+		auto const* slot = mImpl->textures.find(handle);
+		return slot && slot->asset ? &slot->asset : nullptr;
+	}
+
+	ShaderProgram const* AssetCache::get(AssetHandle<ShaderProgram> handle) const {
+		auto const* slot = mImpl->shaders.find(handle);
+		return slot && slot->asset ? &slot->asset : nullptr;
+	}
+
+	AssetCache::State AssetCache::state(AssetHandle<Texture> handle) const {
+		auto const* slot = mImpl->textures.find(handle);
+		return slot ? slot->state : State::kReleased;
+	}
+
+	AssetCache::State AssetCache::state(AssetHandle<ShaderProgram> handle) const {
+		auto const* slot = mImpl->shaders.find(handle);
+		return slot ? slot->state : State::kReleased;
+	}
+
+	void AssetCache::reload(AssetHandle<Texture> handle) {
+		auto* slot = mImpl->textures.find(handle);
+		if (!slot || slot->data.pending) return;
+		mImpl->start(*slot);
+	}
+
+	void AssetCache::reload(AssetHandle<ShaderProgram> handle) {
+		if (auto* slot = mImpl->shaders.find(handle)) mImpl->reload(*slot);
+	}
+
+	std::size_t AssetCache::update() {
+		VP_PROFILE_CPU;
+		Impl& impl = *mImpl;
+		++impl.frame;
+
+		std::size_t const finished = impl.finish_textures();
+
+		std::erase_if(impl.orphans, [](Task<Image> const& task) { return task.done(); });
+		impl.textures.collect(impl.frame);
+		impl.shaders.collect(impl.frame);
+
+		if (impl.info.watch) impl.watch();
+		return finished;
+	}
+
+	std::size_t AssetCache::loading() const {
+		return std::count_if(mImpl->textures.slots.begin(), mImpl->textures.slots.end(), [](auto const& slot) { return static_cast<bool>(slot.data.pending); });
+	}
+}
+
+#endif // VP_HAS_SHADER_PROGRAM && VP_HAS_STB_IMAGE
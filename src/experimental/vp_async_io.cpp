@@ -0,0 +1,374 @@
+#include "vulpengine/experimental/vp_async_io.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace {
+	struct IoResult final {
+		std::uint64_t tag = 0;
+		std::int64_t value = 0; // Bytes read, a negated platform error code on failure
+	};
+
+	class FileHandle;
+
+	// Where reads are issued, the platform's own queue or the fallback thread pool
+	class Backend {
+	public:
+		virtual ~Backend() noexcept = default;
+
+		virtual void push(FileHandle const& file, std::span<std::byte> output, std::uint64_t offset, std::uint64_t tag) = 0;
+		virtual void submit() = 0;
+
+		// Appends finished reads, blocking until at least `min` finished. Returns 0, or the
+		// platform error code if the queue itself failed and nothing more will complete.
+		virtual int wait(std::size_t min, std::vector<IoResult>& results) = 0;
+	};
+}
+
+// These platform files should define `class FileHandle`, movable, with
+// `bool open(std::filesystem::path const& path)`, `void close()` and
+// `std::int64_t read_at(std::span<std::byte> output, std::uint64_t offset) const` returning the
+// bytes read or a negated error code, and `std::unique_ptr<Backend> make_native_backend(std::uint32_t depth)`
+// returning null when the platform has no usable asynchronous queue
+
+#ifdef VP_WINDOWS
+#	include "vp_async_io_win.inl"
+#endif
+
+#ifdef VP_LINUX
+#	include "vp_async_io_linux.inl"
+#endif
+
+namespace {
+	class ThreadBackend final : public Backend {
+	public:
+		ThreadBackend(std::uint32_t threadCount) {
+			for (std::uint32_t i = 0; i < std::max(threadCount, 1u); ++i)
+				mThreads.emplace_back([this] { work(); });
+		}
+
+		ThreadBackend(ThreadBackend const&) = delete;
+		ThreadBackend& operator=(ThreadBackend const&) = delete;
+
+		~ThreadBackend() noexcept override {
+			{
+				std::lock_guard lock(mMutex);
+				mStop = true;
+			}
+
+			mWake.notify_all();
+			for (std::thread& thread : mThreads) thread.join();
+		}
+
+		void push(FileHandle const& file, std::span<std::byte> output, std::uint64_t offset, std::uint64_t tag) override {
+			mStaged.push_back({ &file, output, offset, tag });
+		}
+
+		void submit() override {
+			if (mStaged.empty()) return;
+
+			{
+				std::lock_guard lock(mMutex);
+				mQueue.insert(mQueue.end(), mStaged.begin(), mStaged.end());
+			}
+
+			mStaged.clear();
+			mWake.notify_all();
+		}
+
+		int wait(std::size_t min, std::vector<IoResult>& results) override {
+			std::unique_lock lock(mMutex);
+			mDone.wait(lock, [&] { return mResults.size() >= min; });
+			results.insert(results.end(), mResults.begin(), mResults.end());
+			mResults.clear();
+			return 0;
+		}
+	private:
+		struct Read final {
+			FileHandle const* file;
+			std::span<std::byte> output;
+			std::uint64_t offset;
+			std::uint64_t tag;
+		};
+
+		void work() {
+#ifdef VP_HAS_TRACY
+			tracy::SetThreadName("Async I/O");
+#else
+			vulpengine::experimental::profiler::set_thread_name("Async I/O");
+#endif
+
+			std::unique_lock lock(mMutex);
+
+			while (true) {
+				mWake.wait(lock, [&] { return mStop || !mQueue.empty(); });
+				if (mQueue.empty()) return;
+
+				Read const read = mQueue.front();
+				mQueue.pop_front();
+				lock.unlock();
+
+				std::int64_t const value = read.file->read_at(read.output, read.offset);
+
+				lock.lock();
+				mResults.push_back({ read.tag, value });
+				mDone.notify_one();
+			}
+		}
+
+		std::vector<Read> mStaged; // Submitting thread only
+
+		std::mutex mMutex;
+		std::condition_variable mWake;
+		std::condition_variable mDone;
+		std::deque<Read> mQueue;
+		std::vector<IoResult> mResults;
+		bool mStop = false;
+
+		std::vector<std::thread> mThreads;
+	};
+}
+
+namespace vulpengine::experimental::aio {
+	struct Reader::Impl final {
+		struct Request final {
+			std::filesystem::path path;
+			FileHandle file;
+			std::span<std::byte> output;
+			std::uint64_t offset = 0;
+			std::uint64_t user = 0;
+			std::size_t bytes = 0;
+			std::uint32_t chunks = 0; // Not finished yet
+			bool failed = false;
+		};
+
+		struct Chunk final {
+			std::uint32_t request = 0;
+			std::size_t offset = 0; // Into the request's output
+			std::size_t size = 0;
+			bool inFlight = false;
+		};
+
+		std::unique_ptr<Backend> backend;
+		std::unique_ptr<Backend> failedBackend; // Kept until the reader is destroyed, see `fail`
+		bool uring = false;
+		std::uint32_t depth = 0;
+		std::size_t chunkSize = 0;
+		std::uint32_t fallbackThreads = 0;
+
+		std::deque<Request> requests; // Stable addresses, the thread pool reads through them
+		std::vector<std::uint32_t> freeRequests;
+		std::vector<std::uint32_t> unopened;
+
+		std::vector<Chunk> chunks; // Indexed by tag
+		std::vector<std::uint32_t> freeChunks;
+		std::deque<Chunk> queued;
+		std::uint32_t inFlight = 0;
+
+		std::vector<Completion> finished;
+		std::vector<IoResult> results;
+		std::size_t pending = 0;
+
+		~Impl() noexcept {
+			while (inFlight) {
+				results.clear();
+				if (backend->wait(1, results)) break;
+				inFlight -= static_cast<std::uint32_t>(results.size());
+			}
+		}
+
+		void finish(std::uint32_t index) {
+			Request& request = requests[index];
+			finished.push_back({ request.user, request.bytes, !request.failed });
+			request.file.close();
+			freeRequests.push_back(index);
+		}
+
+		void open() {
+			for (std::uint32_t const index : unopened) {
+				Request& request = requests[index];
+
+				if (!request.file.open(request.path)) {
+					request.failed = true;
+					finish(index);
+					continue;
+				}
+
+				std::size_t const size = request.output.size();
+				if (!size) {
+					finish(index);
+					continue;
+				}
+
+				for (std::size_t offset = 0; offset < size; offset += chunkSize) {
+					queued.push_back({ index, offset, std::min(chunkSize, size - offset) });
+					++request.chunks;
+				}
+			}
+
+			unopened.clear();
+		}
+
+		void issue() {
+			while (inFlight < depth && !queued.empty()) {
+				Chunk const chunk = queued.front();
+				queued.pop_front();
+
+				std::uint32_t tag;
+				if (freeChunks.empty()) {
+					tag = static_cast<std::uint32_t>(chunks.size());
+					chunks.push_back(chunk);
+				} else {
+					tag = freeChunks.back();
+					freeChunks.pop_back();
+					chunks[tag] = chunk;
+				}
+
+				chunks[tag].inFlight = true;
+
+				Request const& request = requests[chunk.request];
+				backend->push(request.file, request.output.subspan(chunk.offset, chunk.size), request.offset + chunk.offset, tag);
+				++inFlight;
+			}
+
+			backend->submit();
+		}
+
+		void complete(IoResult const& result) {
+			std::uint32_t const tag = static_cast<std::uint32_t>(result.tag);
+			Chunk const chunk = chunks[tag];
+			chunks[tag].inFlight = false;
+			freeChunks.push_back(tag);
+			--inFlight;
+
+			Request& request = requests[chunk.request];
+
+			if (result.value < 0) {
+				if (!request.failed) VP_LOG_ERROR("Read of {} failed: {}", request.path.string(), std::system_category().message(static_cast<int>(-result.value)));
+				request.failed = true;
+			} else {
+				std::size_t const bytes = static_cast<std::size_t>(result.value);
+				request.bytes += bytes;
+
+				// A short read before the end of the file, the rest goes out again
+				if (bytes && bytes < chunk.size) {
+					queued.push_front({ chunk.request, chunk.offset + bytes, chunk.size - bytes });
+					return;
+				}
+			}
+
+			if (--request.chunks == 0) finish(chunk.request);
+		}
+
+		// The queue broke, reads in flight will never complete through it. They fail here, and
+		// the rest go through the thread pool. The kernel may still finish them into their buffers.
+		void fail(int error) {
+			VP_LOG_ERROR("Async read queue failed, falling back to a thread pool: {}", std::system_category().message(error));
+
+			for (std::uint32_t tag = 0; tag < chunks.size(); ++tag) {
+				if (chunks[tag].inFlight) complete({ tag, -static_cast<std::int64_t>(error) });
+			}
+
+			failedBackend = std::move(backend);
+			backend = std::make_unique<ThreadBackend>(fallbackThreads);
+			uring = false;
+		}
+
+		void reap(bool block) {
+			results.clear();
+			int const error = backend->wait(block ? 1 : 0, results);
+			for (IoResult const& result : results) complete(result);
+			if (error) fail(error);
+			issue();
+		}
+	};
+
+	Reader::Reader() : Reader(CreateInfo{}) {}
+
+	Reader::Reader(CreateInfo const& info) : mImpl(std::make_unique<Impl>()) {
+		mImpl->depth = std::max(info.queueDepth, 1u);
+		mImpl->chunkSize = std::max(info.chunkSize, 4096u);
+		mImpl->fallbackThreads = info.fallbackThreads;
+
+		if (!info.forceFallback) {
+			mImpl->backend = make_native_backend(mImpl->depth);
+			if (!mImpl->backend) VP_LOG_DEBUG("No io_uring, async reads fall back to a thread pool");
+		}
+
+		mImpl->uring = mImpl->backend != nullptr;
+		if (!mImpl->backend) mImpl->backend = std::make_unique<ThreadBackend>(mImpl->fallbackThreads);
+	}
+
+	Reader::Reader(Reader&&) noexcept = default;
+	Reader& Reader::operator=(Reader&&) noexcept = default;
+	Reader::~Reader() noexcept = default;
+
+	void Reader::read(std::filesystem::path const& path, std::span<std::byte> output, std::uint64_t user, std::uint64_t offset) {
+		Impl& impl = *mImpl;
+
+		std::uint32_t index;
+		if (impl.freeRequests.empty()) {
+			index = static_cast<std::uint32_t>(impl.requests.size());
+			impl.requests.emplace_back();
+		} else {
+			index = impl.freeRequests.back();
+			impl.freeRequests.pop_back();
+		}
+
+		Impl::Request& request = impl.requests[index];
+		request.path = path;
+		request.output = output;
+		request.offset = offset;
+		request.user = user;
+		request.bytes = 0;
+		request.chunks = 0;
+		request.failed = false;
+
+		impl.unopened.push_back(index);
+		++impl.pending;
+	}
+
+	void Reader::submit() {
+		VP_PROFILE_CPU;
+		mImpl->open();
+		mImpl->issue();
+	}
+
+	std::size_t Reader::wait(std::vector<Completion>& completions, std::size_t min) {
+		VP_PROFILE_CPU;
+		Impl& impl = *mImpl;
+		std::size_t appended = 0;
+
+		while (true) {
+			appended += impl.finished.size();
+			impl.pending -= impl.finished.size();
+			completions.insert(completions.end(), impl.finished.begin(), impl.finished.end());
+			impl.finished.clear();
+
+			if (!impl.inFlight) break;
+
+			bool const block = appended < min;
+			impl.reap(block);
+			if (!block && impl.finished.empty()) break;
+		}
+
+		return appended;
+	}
+
+	std::size_t Reader::pending() const {
+		return mImpl->pending;
+	}
+
+	bool Reader::uses_io_uring() const {
+		return mImpl->uring;
+	}
+}
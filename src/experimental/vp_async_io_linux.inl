@@ -0,0 +1,198 @@
+#include <cerrno>
+#include <atomic>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+	class FileHandle final {
+	public:
+		FileHandle() noexcept = default;
+		FileHandle(FileHandle const&) = delete;
+		FileHandle& operator=(FileHandle const&) = delete;
+		inline FileHandle(FileHandle&& other) noexcept { *this = std::move(other); }
+
+		inline FileHandle& operator=(FileHandle&& other) noexcept {
+			std::swap(mFd, other.mFd);
+			return *this;
+		}
+
+		inline ~FileHandle() noexcept { close(); }
+
+		bool open(std::filesystem::path const& path) {
+			close();
+			mFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			return mFd != -1;
+		}
+
+		void close() {
+			if (mFd != -1) ::close(mFd);
+			mFd = -1;
+		}
+
+		std::int64_t read_at(std::span<std::byte> output, std::uint64_t offset) const {
+			while (true) {
+				ssize_t const bytes = pread(mFd, output.data(), output.size(), static_cast<off_t>(offset));
+				if (bytes >= 0) return bytes;
+				if (errno != EINTR) return -errno;
+			}
+		}
+
+		inline int native() const { return mFd; }
+	private:
+		int mFd = -1;
+	};
+
+	// io_uring through its syscalls, a submission and a completion ring shared with the kernel
+	class UringBackend final : public Backend {
+	public:
+		UringBackend() noexcept = default;
+		UringBackend(UringBackend const&) = delete;
+		UringBackend& operator=(UringBackend const&) = delete;
+
+		~UringBackend() noexcept override {
+			if (mSqes) munmap(mSqes, mSqesSize);
+			if (mCq && mCq != mSq) munmap(mCq, mCqSize);
+			if (mSq) munmap(mSq, mSqSize);
+			if (mRing != -1) close(mRing);
+		}
+
+		bool init(std::uint32_t depth) {
+			io_uring_params params{};
+			int const ring = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+			if (ring < 0) return false;
+			mRing = ring;
+
+			// IORING_OP_READ needs 5.6, the same release that added probing
+			alignas(io_uring_probe) std::byte probeStorage[sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op)]{};
+			auto* probe = reinterpret_cast<io_uring_probe*>(probeStorage);
+			if (syscall(__NR_io_uring_register, mRing, IORING_REGISTER_PROBE, probe, 256) < 0) return false;
+			if (probe->last_op < IORING_OP_READ || !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)) return false;
+
+			mSqSize = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+			mCqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			if (params.features & IORING_FEAT_SINGLE_MMAP) mSqSize = mCqSize = std::max(mSqSize, mCqSize);
+
+			mSq = map(mSqSize, IORING_OFF_SQ_RING);
+			if (!mSq) return false;
+
+			mCq = params.features & IORING_FEAT_SINGLE_MMAP ? mSq : map(mCqSize, IORING_OFF_CQ_RING);
+			if (!mCq) return false;
+
+			mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+			mSqes = static_cast<io_uring_sqe*>(map(mSqesSize, IORING_OFF_SQES));
+			if (!mSqes) return false;
+
+			auto* sq = static_cast<std::byte*>(mSq);
+			mSqTail = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+			mSqMask = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+			mSqArray = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+
+			auto* cq = static_cast<std::byte*>(mCq);
+			mCqHead = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+			mCqTail = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+			mCqMask = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+			mCqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+			return true;
+		}
+
+		void push(FileHandle const& file, std::span<std::byte> output, std::uint64_t offset, std::uint64_t tag) override {
+			std::uint32_t const tail = *mSqTail; // Only this thread moves the tail
+			std::uint32_t const index = tail & mSqMask;
+
+			io_uring_sqe& sqe = mSqes[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			sqe.opcode = IORING_OP_READ;
+			sqe.fd = file.native();
+			sqe.addr = reinterpret_cast<std::uintptr_t>(output.data());
+			sqe.len = static_cast<std::uint32_t>(output.size());
+			sqe.off = offset;
+			sqe.user_data = tag;
+
+			mSqArray[index] = index;
+			std::atomic_ref(*mSqTail).store(tail + 1, std::memory_order_release);
+			++mUnsubmitted;
+		}
+
+		// A failure is kept for the next `wait`, which reports it
+		void submit() override {
+			mError = enter(0);
+		}
+
+		int wait(std::size_t min, std::vector<IoResult>& results) override {
+			std::size_t finished = reap(results);
+			if (mError) return mError;
+
+			while (finished < min) {
+				mError = enter(static_cast<std::uint32_t>(min - finished));
+				if (mError) return mError;
+				finished += reap(results);
+			}
+
+			return 0;
+		}
+	private:
+		void* map(std::size_t size, std::uint64_t offset) const {
+			void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, static_cast<off_t>(offset));
+			return data == MAP_FAILED ? nullptr : data;
+		}
+
+		// Submits what was pushed and optionally waits for completions in the same syscall.
+		// Returns 0 or errno.
+		int enter(std::uint32_t waitFor) {
+			while (mUnsubmitted || waitFor) {
+				long const submitted = syscall(__NR_io_uring_enter, mRing, mUnsubmitted, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+
+				if (submitted < 0) {
+					if (errno == EINTR) continue;
+					return errno;
+				}
+
+				mUnsubmitted -= static_cast<std::uint32_t>(submitted);
+				if (waitFor) return 0;
+			}
+
+			return 0;
+		}
+
+		std::size_t reap(std::vector<IoResult>& results) {
+			std::uint32_t head = *mCqHead; // Only this thread moves the head
+			std::uint32_t const tail = std::atomic_ref(*mCqTail).load(std::memory_order_acquire);
+			std::size_t const count = tail - head;
+
+			for (; head != tail; ++head) {
+				io_uring_cqe const& cqe = mCqes[head & mCqMask];
+				results.push_back({ cqe.user_data, cqe.res });
+			}
+
+			std::atomic_ref(*mCqHead).store(head, std::memory_order_release);
+			return count;
+		}
+
+		int mRing = -1;
+		void* mSq = nullptr;
+		void* mCq = nullptr;
+		io_uring_sqe* mSqes = nullptr;
+		std::size_t mSqSize = 0, mCqSize = 0, mSqesSize = 0;
+
+		std::uint32_t* mSqTail = nullptr;
+		std::uint32_t* mSqArray = nullptr;
+		std::uint32_t mSqMask = 0;
+		std::uint32_t* mCqHead = nullptr;
+		std::uint32_t* mCqTail = nullptr;
+		std::uint32_t mCqMask = 0;
+		io_uring_cqe* mCqes = nullptr;
+
+		std::uint32_t mUnsubmitted = 0;
+		int mError = 0;
+	};
+
+	std::unique_ptr<Backend> make_native_backend(std::uint32_t depth) {
+		auto backend = std::make_unique<UringBackend>();
+		if (!backend->init(depth)) return nullptr;
+		return backend;
+	}
+}
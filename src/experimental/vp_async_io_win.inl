@@ -0,0 +1,53 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+namespace {
+	class FileHandle final {
+	public:
+		FileHandle() noexcept = default;
+		FileHandle(FileHandle const&) = delete;
+		FileHandle& operator=(FileHandle const&) = delete;
+		inline FileHandle(FileHandle&& other) noexcept { *this = std::move(other); }
+
+		inline FileHandle& operator=(FileHandle&& other) noexcept {
+			std::swap(mHandle, other.mHandle);
+			return *this;
+		}
+
+		inline ~FileHandle() noexcept { close(); }
+
+		bool open(std::filesystem::path const& path) {
+			close();
+			mHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			return mHandle != INVALID_HANDLE_VALUE;
+		}
+
+		void close() {
+			if (mHandle != INVALID_HANDLE_VALUE) CloseHandle(mHandle);
+			mHandle = INVALID_HANDLE_VALUE;
+		}
+
+		// The offset in the OVERLAPPED makes this a positioned read on a synchronous handle
+		std::int64_t read_at(std::span<std::byte> output, std::uint64_t offset) const {
+			OVERLAPPED overlapped{};
+			overlapped.Offset = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+			DWORD bytes = 0;
+			if (!ReadFile(mHandle, output.data(), static_cast<DWORD>(output.size()), &bytes, &overlapped)) {
+				DWORD const error = GetLastError();
+				if (error == ERROR_HANDLE_EOF) return 0;
+				return -static_cast<std::int64_t>(error);
+			}
+
+			return bytes;
+		}
+	private:
+		HANDLE mHandle = INVALID_HANDLE_VALUE;
+	};
+
+	std::unique_ptr<Backend> make_native_backend(std::uint32_t) {
+		return nullptr;
+	}
+}
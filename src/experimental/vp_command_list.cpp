@@ -0,0 +1,257 @@
+#include "vulpengine/experimental/vp_command_list.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include "vulpengine/vp_profile.hpp"
+
+#include <cassert>
+#include <array>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr std::size_t kBlockSize = 16 * 1024;
+		constexpr std::size_t kCommandAlignment = 8;
+		constexpr std::size_t kMaxUniformFloats = 16;
+
+		struct UseProgram final { std::uint32_t program; };
+		struct BindTexture final { GLuint unit; std::uint32_t texture; };
+		struct BindBufferBase final { GLenum target; GLuint index; std::uint32_t buffer; };
+		struct UniformUint final { GLint location; std::uint32_t value; };
+		struct Draw final { std::uint32_t mesh; GLsizei count; };
+		struct Dispatch final { std::uint32_t program; GLuint x, y, z; };
+		struct MemoryBarriers final { GLbitfield barriers; };
+
+		// Followed by `count` floats
+		struct UniformFloats final { GLint location; std::int32_t components; std::uint32_t count; };
+
+		constexpr std::size_t align_command(std::size_t size) {
+			return (size + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+		}
+
+		template<class T>
+		T read(std::byte const* data) {
+			T value;
+			std::memcpy(&value, data, sizeof(T));
+			return value;
+		}
+
+		template<class T>
+		CommandHandle<T> add_object(std::vector<T const*>& objects, T const& object) {
+			objects.push_back(&object);
+			return { static_cast<std::uint32_t>(objects.size() - 1) };
+		}
+	}
+
+	MeshHandle CommandRegistry::add(Mesh const& mesh) { return add_object(mMeshes, mesh); }
+	ProgramHandle CommandRegistry::add(ShaderProgram const& program) { return add_object(mPrograms, program); }
+	ComputeHandle CommandRegistry::add(ComputeProgram const& program) { return add_object(mComputePrograms, program); }
+	TextureHandle CommandRegistry::add(Texture const& texture) { return add_object(mTextures, texture); }
+	BufferHandle CommandRegistry::add(Buffer const& buffer) { return add_object(mBuffers, buffer); }
+
+	void CommandRegistry::clear() {
+		mMeshes.clear();
+		mPrograms.clear();
+		mComputePrograms.clear();
+		mTextures.clear();
+		mBuffers.clear();
+	}
+
+	template<class T>
+	void CommandList::record(Type type, T const& command) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		static_assert(alignof(T) <= kCommandAlignment);
+
+		record(type, &command, sizeof(T), nullptr, 0);
+	}
+
+	void CommandList::record(Type type, void const* command, std::size_t size, void const* extra, std::size_t extraSize) {
+		std::size_t const total = align_command(sizeof(Header) + size + extraSize);
+		assert(total <= kBlockSize);
+
+		while (mCurrent < mBlocks.size() && mBlocks[mCurrent].used + total > kBlockSize) ++mCurrent;
+
+		if (mCurrent == mBlocks.size())
+			mBlocks.push_back({ std::make_unique<std::byte[]>(kBlockSize), 0 });
+
+		Block& block = mBlocks[mCurrent];
+		std::byte* data = block.data.get() + block.used;
+
+		Header const header = { type, static_cast<std::uint16_t>(total) };
+		std::memcpy(data, &header, sizeof(header));
+		std::memcpy(data + sizeof(Header), command, size);
+		if (extraSize) std::memcpy(data + sizeof(Header) + size, extra, extraSize);
+
+		block.used += total;
+		++mCount;
+	}
+
+	void CommandList::use_program(ProgramHandle program) {
+		assert(program.valid());
+		record(Type::kUseProgram, UseProgram{ program.index });
+		mHasProgram = true;
+	}
+
+	void CommandList::bind_texture(GLuint unit, TextureHandle texture) {
+		assert(texture.valid());
+		record(Type::kBindTexture, BindTexture{ unit, texture.index });
+	}
+
+	void CommandList::bind_buffer_base(GLenum target, GLuint index, BufferHandle buffer) {
+		assert(buffer.valid());
+		record(Type::kBindBufferBase, BindBufferBase{ target, index, buffer.index });
+	}
+
+	void CommandList::uniform(GLint location, std::uint32_t value) {
+		assert(mHasProgram);
+		record(Type::kUniformUint, UniformUint{ location, value });
+	}
+
+	void CommandList::uniform(GLint location, std::span<float const> values, int components) {
+		assert(mHasProgram);
+		assert((components >= 1 && components <= 4) || components == 16);
+		assert(values.size() <= kMaxUniformFloats);
+		assert(values.size() % components == 0);
+
+		UniformFloats const command = { location, components, static_cast<std::uint32_t>(values.size()) };
+		record(Type::kUniformFloats, &command, sizeof(command), values.data(), values.size_bytes());
+	}
+
+	void CommandList::draw(MeshHandle mesh, GLsizei count) {
+		assert(mesh.valid());
+		record(Type::kDraw, Draw{ mesh.index, count });
+	}
+
+	void CommandList::queue_draw(QueueDrawInfo const& info) {
+		assert(info.mesh.valid());
+		assert(info.program.valid());
+		record(Type::kQueueDraw, info);
+	}
+
+	void CommandList::dispatch(ComputeHandle program, GLuint x, GLuint y, GLuint z) {
+		assert(program.valid());
+		record(Type::kDispatch, Dispatch{ program.index, x, y, z });
+		mHasProgram = false;
+	}
+
+	void CommandList::memory_barrier(Barrier barriers) {
+		record(Type::kMemoryBarrier, MemoryBarriers{ static_cast<GLbitfield>(barriers) });
+	}
+
+	void CommandList::reset() {
+		for (auto& block : mBlocks) block.used = 0;
+		mCurrent = 0;
+		mCount = 0;
+		mHasProgram = false;
+	}
+
+	struct CommandListExecutor final {
+		CommandExecuteInfo const& info;
+		ShaderProgram const* program = nullptr;
+
+		void execute(CommandList const& list) {
+			// Program state doesn't carry over between lists
+			program = nullptr;
+
+			for (auto const& block : list.mBlocks) {
+				std::size_t offset = 0;
+
+				while (offset < block.used) {
+					std::byte const* data = block.data.get() + offset;
+					auto const header = read<CommandList::Header>(data);
+					execute(header.type, data + sizeof(CommandList::Header));
+					offset += header.size;
+				}
+			}
+		}
+
+		void execute(CommandList::Type type, std::byte const* data) {
+			CommandRegistry const& registry = info.registry;
+
+			switch (type) {
+				case CommandList::Type::kUseProgram: {
+					auto const command = read<UseProgram>(data);
+					program = &registry.get(ProgramHandle{ command.program });
+					program->bind();
+					break;
+				}
+				case CommandList::Type::kBindTexture: {
+					auto const command = read<BindTexture>(data);
+					registry.get(TextureHandle{ command.texture }).bind(command.unit);
+					break;
+				}
+				case CommandList::Type::kBindBufferBase: {
+					auto const command = read<BindBufferBase>(data);
+					registry.get(BufferHandle{ command.buffer }).bind_base(command.target, command.index);
+					break;
+				}
+				case CommandList::Type::kUniformUint: {
+					auto const command = read<UniformUint>(data);
+					glProgramUniform1ui(program->handle(), command.location, command.value);
+					break;
+				}
+				case CommandList::Type::kUniformFloats: {
+					auto const command = read<UniformFloats>(data);
+					std::array<float, kMaxUniformFloats> values;
+					std::memcpy(values.data(), data + sizeof(UniformFloats), command.count * sizeof(float));
+
+					GLsizei const count = static_cast<GLsizei>(command.count / command.components);
+					GLuint const handle = program->handle();
+
+					switch (command.components) {
+						case 1: glProgramUniform1fv(handle, command.location, count, values.data()); break;
+						case 2: glProgramUniform2fv(handle, command.location, count, values.data()); break;
+						case 3: glProgramUniform3fv(handle, command.location, count, values.data()); break;
+						case 4: glProgramUniform4fv(handle, command.location, count, values.data()); break;
+						case 16: glProgramUniformMatrix4fv(handle, command.location, count, GL_FALSE, values.data()); break;
+					}
+					break;
+				}
+				case CommandList::Type::kDraw: {
+					auto const command = read<Draw>(data);
+					registry.get(MeshHandle{ command.mesh }).draw(command.count);
+					break;
+				}
+				case CommandList::Type::kQueueDraw: {
+					assert(info.queue != nullptr);
+					auto const command = read<CommandList::QueueDrawInfo>(data);
+					info.queue->submit({
+						.mesh = registry.get(command.mesh),
+						.program = registry.get(command.program),
+						.material = command.material,
+						.depth = command.depth,
+						.layer = command.layer,
+						.translucent = command.translucent,
+						.drawId = command.drawId,
+						.count = command.count
+					});
+					break;
+				}
+				case CommandList::Type::kDispatch: {
+					auto const command = read<Dispatch>(data);
+					registry.get(ComputeHandle{ command.program }).dispatch(command.x, command.y, command.z);
+
+					// Dispatching binds the compute program
+					program = nullptr;
+					break;
+				}
+				case CommandList::Type::kMemoryBarrier: {
+					auto const command = read<MemoryBarriers>(data);
+					experimental::memory_barrier(static_cast<Barrier>(command.barriers));
+					break;
+				}
+			}
+		}
+	};
+
+	void execute_command_lists(CommandExecuteInfo const& info) {
+		VP_PROFILE_CPU;
+
+		CommandListExecutor executor{ info };
+		for (CommandList const& list : info.lists) executor.execute(list);
+	}
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
@@ -0,0 +1,226 @@
+#include "vulpengine/experimental/vp_cpu_profiler.hpp"
+
+#include "vulpengine/vp_log.hpp"
+
+#include <array>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vulpengine::experimental::profiler {
+	namespace {
+		constexpr std::size_t kRingSize = 1 << 14;
+
+		// Keeps memory bounded if nobody ever writes a trace
+		constexpr std::size_t kMaxCollected = 1 << 22;
+
+		// An end of 0 marks an instant event
+		struct Event final {
+			char const* name;
+			std::int64_t begin;
+			std::int64_t end;
+		};
+
+		std::atomic<std::uint64_t> gDropped = 0;
+
+		// Single producer (the owning thread), single consumer (the collector)
+		struct ThreadBuffer final {
+			std::array<Event, kRingSize> events;
+			std::atomic<std::uint64_t> head = 0;
+			std::atomic<std::uint64_t> tail = 0;
+			std::atomic_bool alive = true;
+			std::uint32_t id = 0;
+
+			void push(Event const& event) {
+				std::uint64_t const h = head.load(std::memory_order_relaxed);
+
+				if (h - tail.load(std::memory_order_acquire) == kRingSize) {
+					gDropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+
+				events[h & (kRingSize - 1)] = event;
+				head.store(h + 1, std::memory_order_release);
+			}
+		};
+
+		struct CollectedEvent final {
+			Event event;
+			std::uint32_t thread;
+		};
+
+		struct Collector final {
+			std::mutex mutex;
+			std::vector<std::shared_ptr<ThreadBuffer>> threads;
+			std::vector<CollectedEvent> events;
+			std::vector<std::pair<std::uint32_t, std::string>> threadNames;
+			std::uint32_t nextId = 1;
+		};
+
+		Collector& collector() {
+			static Collector instance;
+			return instance;
+		}
+
+		// Flags the buffer so the collector can drop it once drained
+		struct ThreadHandle final {
+			std::shared_ptr<ThreadBuffer> buffer;
+
+			~ThreadHandle() noexcept {
+				if (buffer) buffer->alive = false;
+			}
+		};
+
+		thread_local ThreadHandle tThread;
+
+		ThreadBuffer& thread_buffer() {
+			if (!tThread.buffer) {
+				auto buffer = std::make_shared<ThreadBuffer>();
+
+				Collector& instance = collector();
+				std::lock_guard lock(instance.mutex);
+				buffer->id = instance.nextId++;
+				instance.threads.push_back(buffer);
+				tThread.buffer = std::move(buffer);
+			}
+
+			return *tThread.buffer;
+		}
+
+		// Pairs a tick count with a steady_clock time, a second pair gives the tick rate
+		struct ClockSample final {
+			std::int64_t ticks;
+			std::int64_t nanoseconds;
+		};
+
+		ClockSample const gOrigin = { detail::now(), detail::steady_now() };
+
+		void write_escaped(std::string& json, std::string_view string) {
+			for (char c : string) {
+				if (c == '"' || c == '\\') json += '\\';
+				json += c;
+			}
+		}
+	}
+
+	std::atomic_bool detail::gEnabled = false;
+
+	void detail::record(char const* name, std::int64_t begin, std::int64_t end) {
+		thread_buffer().push({ name, begin, end });
+	}
+
+	void set_enabled(bool enabled) {
+		detail::gEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void set_thread_name(char const* name) {
+		ThreadBuffer& buffer = thread_buffer();
+
+		Collector& instance = collector();
+		std::lock_guard lock(instance.mutex);
+		instance.threadNames.emplace_back(buffer.id, name);
+	}
+
+	void frame() {
+		if (!enabled()) return;
+		thread_buffer().push({ "Frame", detail::now(), 0 });
+	}
+
+	std::size_t collect() {
+		Collector& instance = collector();
+		std::lock_guard lock(instance.mutex);
+
+		std::size_t drained = 0;
+
+		for (auto const& buffer : instance.threads) {
+			std::uint64_t const tail = buffer->tail.load(std::memory_order_relaxed);
+			std::uint64_t const head = buffer->head.load(std::memory_order_acquire);
+
+			for (std::uint64_t i = tail; i < head; ++i) {
+				if (instance.events.size() < kMaxCollected)
+					instance.events.push_back({ buffer->events[i & (kRingSize - 1)], buffer->id });
+				else
+					gDropped.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			buffer->tail.store(head, std::memory_order_release);
+			drained += head - tail;
+		}
+
+		// Threads that exited have nothing left to write
+		std::erase_if(instance.threads, [](auto const& buffer) {
+			return !buffer->alive && buffer->head.load(std::memory_order_acquire) == buffer->tail.load(std::memory_order_relaxed);
+		});
+
+		return drained;
+	}
+
+	bool write_chrome_trace(char const* path) {
+		collect();
+
+		std::vector<CollectedEvent> events;
+		std::vector<std::pair<std::uint32_t, std::string>> threadNames;
+
+		{
+			Collector& instance = collector();
+			std::lock_guard lock(instance.mutex);
+			events.swap(instance.events);
+			threadNames = instance.threadNames;
+		}
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file) {
+			VP_LOG_ERROR("CPU profiler: unable to write {}", path);
+			return false;
+		}
+
+		ClockSample const current = { detail::now(), detail::steady_now() };
+		double const ticksToMicroseconds = current.ticks == gOrigin.ticks ? 1.0e-3
+			: static_cast<double>(current.nanoseconds - gOrigin.nanoseconds) / static_cast<double>(current.ticks - gOrigin.ticks) * 1.0e-3;
+
+		auto timestamp = [&](std::int64_t ticks) {
+			return gOrigin.nanoseconds * 1.0e-3 + static_cast<double>(ticks - gOrigin.ticks) * ticksToMicroseconds;
+		};
+
+		std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		bool first = true;
+
+		for (auto const& [id, name] : threadNames) {
+			if (!first) json += ',';
+			json += std::format("{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"", id);
+			write_escaped(json, name);
+			json += "\"}}";
+			first = false;
+		}
+
+		for (auto const& [event, thread] : events) {
+			if (!first) json += ',';
+			json += "{\"name\":\"";
+			write_escaped(json, event.name);
+
+			// Timestamps are in microseconds
+			if (event.end == 0)
+				json += std::format("\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", timestamp(event.begin), thread);
+			else
+				json += std::format("\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}", timestamp(event.begin), (event.end - event.begin) * ticksToMicroseconds, thread);
+
+			first = false;
+
+			if (json.size() > (1 << 20)) {
+				file << json;
+				json.clear();
+			}
+		}
+
+		json += "]}";
+		file << json;
+		return static_cast<bool>(file);
+	}
+
+	std::uint64_t dropped() {
+		return gDropped.load(std::memory_order_relaxed);
+	}
+}
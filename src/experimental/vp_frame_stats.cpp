@@ -0,0 +1,160 @@
+#include "vulpengine/experimental/vp_frame_stats.hpp"
+#include "vulpengine/experimental/vp_gpu_profiler.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr std::size_t kMaxHitches = 256;
+
+		FrameStats* gActive = nullptr;
+
+		double elapsed_ms(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+			return std::chrono::duration<double, std::milli>(end - begin).count();
+		}
+	}
+
+	FrameStats::FrameStats(CreateInfo const& info)
+		: mCapacity(info.capacity), mHitchThresholdMs(info.hitchThresholdMs), mHitchMedianFactor(info.hitchMedianFactor), mGpu(info.gpu) {
+		assert(info.capacity > 0);
+		mSamples.resize(info.capacity);
+		mLastFrame = Clock::now();
+	}
+
+	FrameStats::~FrameStats() noexcept {
+		if (gActive == this) gActive = nullptr;
+	}
+
+	std::size_t FrameStats::bin(double ms) {
+		if (!(ms >= kHistogramMinMs)) return 0;
+		if (ms >= kHistogramMaxMs) return kHistogramBins - 1;
+
+		std::size_t const index = 1 + static_cast<std::size_t>(std::log2(ms / kHistogramMinMs) * kHistogramBinsPerOctave);
+		return std::min(index, kHistogramBins - 2);
+	}
+
+	double FrameStats::bin_lower_ms(std::size_t bin) {
+		if (bin == 0) return 0.0;
+		return kHistogramMinMs * std::exp2(static_cast<double>(bin - 1) / kHistogramBinsPerOctave);
+	}
+
+	void FrameStats::begin_swap() {
+		mSwapBegin = Clock::now();
+	}
+
+	void FrameStats::end_swap() {
+		mSwapMs += elapsed_ms(mSwapBegin, Clock::now());
+	}
+
+	void FrameStats::frame() {
+		assert(mCapacity > 0);
+
+		Clock::time_point const now = Clock::now();
+
+		Sample sample;
+		sample[std::size_t(Metric::kFrame)] = elapsed_ms(mLastFrame, now);
+		sample[std::size_t(Metric::kSwap)] = mSwapMs;
+		sample[std::size_t(Metric::kCpu)] = std::max(sample[std::size_t(Metric::kFrame)] - mSwapMs, 0.0);
+		sample[std::size_t(Metric::kGpu)] = mGpu ? mGpu->frame_ms() : 0.0;
+
+		mLastFrame = now;
+		mSwapMs = 0.0;
+
+		// The oldest sample leaves the histograms as the new one enters
+		if (mCount == mCapacity) {
+			Sample const& oldest = mSamples[mNext];
+			for (std::size_t metric = 0; metric < oldest.size(); ++metric) {
+				--mHistograms[metric][bin(oldest[metric])];
+				mSums[metric] -= oldest[metric];
+			}
+		} else {
+			++mCount;
+		}
+
+		for (std::size_t metric = 0; metric < sample.size(); ++metric) {
+			++mHistograms[metric][bin(sample[metric])];
+			mSums[metric] += sample[metric];
+		}
+
+		mSamples[mNext] = sample;
+		mNext = (mNext + 1) % mCapacity;
+		++mTotalFrames;
+
+		double const frameMs = sample[std::size_t(Metric::kFrame)];
+		bool hitch = frameMs > mHitchThresholdMs;
+		if (mHitchMedianFactor > 0.0 && mCount > 1)
+			hitch = hitch || frameMs > percentiles(Metric::kFrame).p50 * mHitchMedianFactor;
+
+		if (hitch) {
+			++mTotalHitches;
+			if (mHitches.size() == kMaxHitches) mHitches.erase(mHitches.begin());
+
+			mHitches.push_back({
+				.frame = mTotalFrames,
+				.frameMs = frameMs,
+				.cpuMs = sample[std::size_t(Metric::kCpu)],
+				.swapMs = sample[std::size_t(Metric::kSwap)],
+				.gpuMs = sample[std::size_t(Metric::kGpu)]
+			});
+		}
+	}
+
+	// Interpolates inside the bin, accurate to a fraction of its width. Nothing is reported
+	// above the true max, which is also the answer for anything landing in the overflow bin.
+	FrameStats::Percentiles FrameStats::percentiles(Metric metric) const {
+		Percentiles result;
+		if (mCount == 0) return result;
+
+		for (std::uint32_t i = 0; i < mCount; ++i)
+			result.max = std::max(result.max, mSamples[i][std::size_t(metric)]);
+
+		auto const& histogram = mHistograms[std::size_t(metric)];
+
+		auto percentile = [&](double fraction) {
+			double const target = fraction * mCount;
+			double seen = 0.0;
+
+			for (std::size_t i = 0; i < histogram.size() - 1; ++i) {
+				if (histogram[i] == 0) continue;
+
+				if (seen + histogram[i] >= target) {
+					double const lower = bin_lower_ms(i);
+					double const upper = bin_lower_ms(i + 1);
+					return std::min(lower + (upper - lower) * (target - seen) / histogram[i], result.max);
+				}
+
+				seen += histogram[i];
+			}
+
+			return result.max;
+		};
+
+		result.p50 = percentile(0.50);
+		result.p95 = percentile(0.95);
+		result.p99 = percentile(0.99);
+		result.average = mSums[std::size_t(metric)] / mCount;
+		return result;
+	}
+
+	FrameStats::Snapshot FrameStats::snapshot() const {
+		return {
+			.frame = percentiles(Metric::kFrame),
+			.cpu = percentiles(Metric::kCpu),
+			.swap = percentiles(Metric::kSwap),
+			.gpu = percentiles(Metric::kGpu),
+			.frames = mCount,
+			.totalFrames = mTotalFrames,
+			.hitches = mTotalHitches
+		};
+	}
+
+	void FrameStats::make_active() {
+		gActive = this;
+	}
+
+	FrameStats* FrameStats::active() {
+		return gActive;
+	}
+}
@@ -0,0 +1,246 @@
+#include "vulpengine/experimental/vp_gpu_memory.hpp"
+
+#include "vulpengine/vp_log.hpp"
+
+#include <array>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace vulpengine::experimental::gpumemory {
+	namespace {
+		struct Allocation final {
+			std::uint64_t bytes;
+			std::string label;
+		};
+
+		struct Tracker final {
+			std::mutex mutex;
+			std::array<std::unordered_map<GLuint, Allocation>, std::size_t(Category::kCount)> allocations;
+			std::array<Totals, std::size_t(Category::kCount)> categories;
+			std::array<std::unordered_map<std::string, Totals>, std::size_t(Category::kCount)> labels;
+			Totals total;
+			std::uint64_t budget = 0;
+		};
+
+		Tracker& tracker() {
+			static Tracker instance;
+			return instance;
+		}
+
+		void add(Totals& totals, std::uint64_t bytes) {
+			totals.bytes += bytes;
+			totals.peakBytes = std::max(totals.peakBytes, totals.bytes);
+			++totals.objects;
+		}
+
+		void remove(Totals& totals, std::uint64_t bytes) {
+			totals.bytes -= bytes;
+			--totals.objects;
+		}
+
+		// 0 for formats that aren't in the table, compressed ones included
+		std::uint32_t bytes_per_texel(GLenum internalFormat) {
+			switch (internalFormat) {
+				case GL_R8: case GL_R8I: case GL_R8UI: case GL_R8_SNORM: case GL_STENCIL_INDEX8:
+					return 1;
+				case GL_RG8: case GL_RG8I: case GL_RG8UI: case GL_RG8_SNORM:
+				case GL_R16: case GL_R16F: case GL_R16I: case GL_R16UI: case GL_R16_SNORM:
+				case GL_DEPTH_COMPONENT16: case GL_RGB565: case GL_RGBA4: case GL_RGB5_A1:
+					return 2;
+				case GL_RGB8: case GL_SRGB8: case GL_RGB8I: case GL_RGB8UI: case GL_RGB8_SNORM:
+				case GL_DEPTH_COMPONENT24:
+					return 3;
+				case GL_RGBA8: case GL_SRGB8_ALPHA8: case GL_RGBA8I: case GL_RGBA8UI: case GL_RGBA8_SNORM:
+				case GL_RG16: case GL_RG16F: case GL_RG16I: case GL_RG16UI: case GL_RG16_SNORM:
+				case GL_R32F: case GL_R32I: case GL_R32UI:
+				case GL_R11F_G11F_B10F: case GL_RGB10_A2: case GL_RGB10_A2UI: case GL_RGB9_E5:
+				case GL_DEPTH_COMPONENT32: case GL_DEPTH_COMPONENT32F: case GL_DEPTH24_STENCIL8:
+					return 4;
+				case GL_RGB16: case GL_RGB16F: case GL_RGB16I: case GL_RGB16UI: case GL_RGB16_SNORM:
+					return 6;
+				case GL_RGBA16: case GL_RGBA16F: case GL_RGBA16I: case GL_RGBA16UI: case GL_RGBA16_SNORM:
+				case GL_RG32F: case GL_RG32I: case GL_RG32UI:
+				case GL_DEPTH32F_STENCIL8:
+					return 8;
+				case GL_RGB32F: case GL_RGB32I: case GL_RGB32UI:
+					return 12;
+				case GL_RGBA32F: case GL_RGBA32I: case GL_RGBA32UI:
+					return 16;
+				default:
+					return 0;
+			}
+		}
+
+		std::uint64_t level_extent(GLsizei size, GLsizei level) {
+			return static_cast<std::uint64_t>(std::max(size >> level, 1));
+		}
+	}
+
+	void track(Category category, GLuint handle, std::uint64_t bytes, std::string_view label) {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+
+		std::size_t const index = std::size_t(category);
+		auto [it, inserted] = instance.allocations[index].try_emplace(handle, Allocation{ bytes, std::string(label) });
+		if (!inserted) return;
+
+		add(instance.categories[index], bytes);
+		add(instance.labels[index][it->second.label], bytes);
+
+		bool const wasOver = instance.budget && instance.total.bytes > instance.budget;
+		add(instance.total, bytes);
+
+		if (instance.budget && !wasOver && instance.total.bytes > instance.budget)
+			VP_LOG_WARN("GPU memory over budget: {} / {} bytes after allocating {} ({})", instance.total.bytes, instance.budget, label.empty() ? "unlabeled" : label, to_string(category));
+	}
+
+	void untrack(Category category, GLuint handle) {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+
+		std::size_t const index = std::size_t(category);
+		auto it = instance.allocations[index].find(handle);
+		if (it == instance.allocations[index].end()) return;
+
+		std::uint64_t const bytes = it->second.bytes;
+		remove(instance.categories[index], bytes);
+		remove(instance.labels[index][it->second.label], bytes);
+		remove(instance.total, bytes);
+
+		instance.allocations[index].erase(it);
+	}
+
+	std::uint64_t texture_size(GLuint texture, GLenum target, GLenum internalFormat, GLsizei levels, GLsizei width, GLsizei height, GLsizei depth) {
+		// Array layers and cube faces don't shrink with mip levels
+		std::uint64_t layers = 1;
+		bool depthMips = false;
+
+		switch (target) {
+			case GL_TEXTURE_CUBE_MAP: layers = 6; break;
+			case GL_TEXTURE_1D_ARRAY: layers = static_cast<std::uint64_t>(height); height = 1; break;
+			case GL_TEXTURE_2D_ARRAY: case GL_TEXTURE_CUBE_MAP_ARRAY: layers = static_cast<std::uint64_t>(depth); break;
+			case GL_TEXTURE_3D: depthMips = true; break;
+		}
+
+		std::uint32_t const texelSize = bytes_per_texel(internalFormat);
+		std::uint64_t bytes = 0;
+
+		if (texelSize == 0) {
+			GLint compressed = GL_FALSE;
+			glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_COMPRESSED, &compressed);
+
+			for (GLsizei level = 0; level < levels; ++level) {
+				GLint levelSize = 0;
+
+				if (compressed) {
+					glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &levelSize);
+				} else {
+					GLint bits = 0;
+					for (GLenum component : { GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE, GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE }) {
+						GLint size = 0;
+						glGetTextureLevelParameteriv(texture, level, component, &size);
+						bits += size;
+					}
+
+					levelSize = static_cast<GLint>((bits + 7) / 8 * level_extent(width, level) * level_extent(height, level) * (depthMips ? level_extent(depth, level) : 1));
+				}
+
+				bytes += static_cast<std::uint64_t>(levelSize);
+			}
+
+			// Queries cover every array layer but only one cube face
+			return target == GL_TEXTURE_CUBE_MAP ? bytes * 6 : bytes;
+		}
+
+		for (GLsizei level = 0; level < levels; ++level)
+			bytes += level_extent(width, level) * level_extent(height, level) * (depthMips ? level_extent(depth, level) : 1) * texelSize;
+
+		return bytes * layers;
+	}
+
+	std::uint64_t renderbuffer_size(GLuint renderbuffer, GLenum internalFormat, GLsizei width, GLsizei height) {
+		std::uint64_t texelSize = bytes_per_texel(internalFormat);
+
+		if (texelSize == 0) {
+			GLint bits = 0;
+			for (GLenum component : { GL_RENDERBUFFER_RED_SIZE, GL_RENDERBUFFER_GREEN_SIZE, GL_RENDERBUFFER_BLUE_SIZE, GL_RENDERBUFFER_ALPHA_SIZE, GL_RENDERBUFFER_DEPTH_SIZE, GL_RENDERBUFFER_STENCIL_SIZE }) {
+				GLint size = 0;
+				glGetNamedRenderbufferParameteriv(renderbuffer, component, &size);
+				bits += size;
+			}
+			texelSize = static_cast<std::uint64_t>((bits + 7) / 8);
+		}
+
+		return static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height) * texelSize;
+	}
+
+	Totals totals(Category category) {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+		return instance.categories[std::size_t(category)];
+	}
+
+	Totals total() {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+		return instance.total;
+	}
+
+	std::vector<LabelTotals> by_label() {
+		std::vector<LabelTotals> result;
+
+		{
+			Tracker& instance = tracker();
+			std::lock_guard lock(instance.mutex);
+
+			for (std::size_t category = 0; category < instance.labels.size(); ++category) {
+				for (auto const& [label, totals] : instance.labels[category])
+					result.push_back({ label, static_cast<Category>(category), totals });
+			}
+		}
+
+		std::sort(result.begin(), result.end(), [](LabelTotals const& a, LabelTotals const& b) { return a.totals.bytes > b.totals.bytes; });
+		return result;
+	}
+
+	void set_budget(std::uint64_t bytes) {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+		instance.budget = bytes;
+	}
+
+	bool over_budget() {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+		return instance.budget && instance.total.bytes > instance.budget;
+	}
+
+	std::size_t report_leaks() {
+		Tracker& instance = tracker();
+		std::lock_guard lock(instance.mutex);
+
+		std::size_t leaks = 0;
+
+		for (std::size_t category = 0; category < instance.allocations.size(); ++category) {
+			for (auto const& [handle, allocation] : instance.allocations[category]) {
+				VP_LOG_WARN("Leaked {} {}: {} bytes ({})", to_string(static_cast<Category>(category)), handle, allocation.bytes, allocation.label.empty() ? "unlabeled" : allocation.label);
+				++leaks;
+			}
+		}
+
+		if (leaks)
+			VP_LOG_WARN("{} GPU objects leaked, {} bytes, peak usage was {} bytes", leaks, instance.total.bytes, instance.total.peakBytes);
+
+		return leaks;
+	}
+
+	char const* to_string(Category category) {
+		switch (category) {
+			case Category::kBuffer: return "buffer";
+			case Category::kTexture: return "texture";
+			case Category::kRenderbuffer: return "renderbuffer";
+			default: return "unknown";
+		}
+	}
+}
@@ -0,0 +1,242 @@
+#include "vulpengine/experimental/vp_gpu_profiler.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_util.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr std::uint32_t kSkipped = 0xFFFFFFFF;
+		constexpr std::uint32_t kNoParent = 0xFFFFFFFF;
+
+		// Queries 0 and 1 are the frame begin and end
+		constexpr std::uint32_t kFrameQueries = 2;
+
+		GpuProfiler* gActive = nullptr;
+
+		void write_zone(std::string& json, std::span<GpuProfiler::ZoneStats const> zones, std::uint32_t index) {
+			GpuProfiler::ZoneStats const& zone = zones[index];
+
+			json += "{\"name\":\"";
+			for (char const* c = zone.name; *c; ++c) {
+				if (*c == '"' || *c == '\\') json += '\\';
+				json += *c;
+			}
+
+			json += std::format("\",\"lastMs\":{:.4f},\"averageMs\":{:.4f},\"minMs\":{:.4f},\"maxMs\":{:.4f},\"children\":[", zone.lastMs, zone.averageMs, zone.minMs, zone.maxMs);
+
+			bool first = true;
+			for (std::uint32_t child = index + 1; child < zones.size() && zones[child].depth > zone.depth; ++child) {
+				if (zones[child].parent != index) continue;
+				if (!first) json += ',';
+				write_zone(json, zones, child);
+				first = false;
+			}
+
+			json += "]}";
+		}
+	}
+
+	GpuProfiler::GpuProfiler(CreateInfo const& info) : mMaxZones(info.maxZones), mSmoothing(info.smoothing) {
+		assert(info.latency > 0);
+		assert(info.smoothing > 0.0 && info.smoothing <= 1.0);
+
+		mFrames.resize(info.latency);
+
+		for (auto& frame : mFrames) {
+			frame.queries.resize(kFrameQueries + info.maxZones * 2);
+			glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+			frame.zones.reserve(info.maxZones);
+		}
+
+		glQueryCounter(mFrames[mCurrent].queries[0], GL_TIMESTAMP);
+	}
+
+	GpuProfiler& GpuProfiler::operator=(GpuProfiler&& other) noexcept {
+		std::swap(mFrames, other.mFrames);
+		std::swap(mCurrent, other.mCurrent);
+		std::swap(mMaxZones, other.mMaxZones);
+		std::swap(mSmoothing, other.mSmoothing);
+		std::swap(mStack, other.mStack);
+		std::swap(mResolved, other.mResolved);
+		std::swap(mAccumulators, other.mAccumulators);
+		std::swap(mFrameAccumulator, other.mFrameAccumulator);
+		std::swap(mFrameMs, other.mFrameMs);
+		std::swap(mAverageFrameMs, other.mAverageFrameMs);
+		std::swap(mDroppedFrames, other.mDroppedFrames);
+
+		if (gActive == &other) gActive = this;
+		else if (gActive == this) gActive = &other;
+
+		return *this;
+	}
+
+	GpuProfiler::~GpuProfiler() noexcept {
+		if (gActive == this) gActive = nullptr;
+
+		for (auto& frame : mFrames)
+			glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+	}
+
+	void GpuProfiler::begin_zone(char const* name) {
+		assert(valid());
+
+		Frame& frame = mFrames[mCurrent];
+		bool const parentSkipped = !mStack.empty() && mStack.back() == kSkipped;
+
+		if (parentSkipped || frame.zones.size() >= mMaxZones) {
+			mStack.push_back(kSkipped);
+			return;
+		}
+
+		std::uint32_t const index = static_cast<std::uint32_t>(frame.zones.size());
+
+		frame.zones.push_back({
+			.name = name,
+			.parent = mStack.empty() ? kNoParent : mStack.back(),
+			.depth = static_cast<std::uint32_t>(mStack.size()),
+			.begin = kFrameQueries + index * 2,
+			.end = kFrameQueries + index * 2 + 1
+		});
+
+		glQueryCounter(frame.queries[frame.zones.back().begin], GL_TIMESTAMP);
+		mStack.push_back(index);
+	}
+
+	void GpuProfiler::end_zone() {
+		assert(!mStack.empty());
+
+		std::uint32_t const index = mStack.back();
+		mStack.pop_back();
+		if (index == kSkipped) return;
+
+		Frame& frame = mFrames[mCurrent];
+		glQueryCounter(frame.queries[frame.zones[index].end], GL_TIMESTAMP);
+	}
+
+	double GpuProfiler::accumulate(Accumulator& accumulator, double ms) const {
+		if (!accumulator.initialized) {
+			accumulator = { ms, ms, ms, true };
+			return ms;
+		}
+
+		accumulator.averageMs += (ms - accumulator.averageMs) * mSmoothing;
+		accumulator.minMs = std::min(accumulator.minMs, ms);
+		accumulator.maxMs = std::max(accumulator.maxMs, ms);
+		return accumulator.averageMs;
+	}
+
+	// Queries finish in order, if the frame end is available everything is
+	bool GpuProfiler::resolve(Frame& frame) {
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(frame.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) return false;
+
+		auto result = [&](std::uint32_t query) {
+			GLuint64 value = 0;
+			glGetQueryObjectui64v(frame.queries[query], GL_QUERY_RESULT, &value);
+			return value;
+		};
+
+		auto elapsed_ms = [&](std::uint32_t begin, std::uint32_t end) {
+			return static_cast<double>(result(end) - result(begin)) / 1.0e6;
+		};
+
+		mFrameMs = elapsed_ms(0, 1);
+		mAverageFrameMs = accumulate(mFrameAccumulator, mFrameMs);
+
+		mResolved.clear();
+		std::vector<std::uint64_t> ids;
+		ids.reserve(frame.zones.size());
+
+		for (RecordedZone const& zone : frame.zones) {
+			// Same name under the same parent is the same zone across frames
+			std::uint64_t const id = hash_fnv1a(zone.name, zone.parent == kNoParent ? hash_fnv1a("") : ids[zone.parent]);
+			ids.push_back(id);
+
+			double const ms = elapsed_ms(zone.begin, zone.end);
+			Accumulator& accumulator = mAccumulators[id];
+			accumulate(accumulator, ms);
+
+			mResolved.push_back({
+				.name = zone.name,
+				.depth = zone.depth,
+				.parent = zone.parent,
+				.lastMs = ms,
+				.averageMs = accumulator.averageMs,
+				.minMs = accumulator.minMs,
+				.maxMs = accumulator.maxMs
+			});
+		}
+
+		return true;
+	}
+
+	void GpuProfiler::frame() {
+		assert(valid());
+
+		if (!mStack.empty()) {
+			VP_LOG_WARN("GPU profiler: {} zones still open at the end of the frame", mStack.size());
+			while (!mStack.empty()) end_zone();
+		}
+
+		Frame& current = mFrames[mCurrent];
+		glQueryCounter(current.queries[1], GL_TIMESTAMP);
+		current.pending = true;
+
+		// Oldest first, so the latest finished frame is resolved last
+		for (std::uint32_t i = 1; i <= mFrames.size(); ++i) {
+			Frame& frame = mFrames[(mCurrent + i) % mFrames.size()];
+			if (frame.pending && resolve(frame)) frame.pending = false;
+		}
+
+		mCurrent = (mCurrent + 1) % mFrames.size();
+
+		Frame& next = mFrames[mCurrent];
+		if (next.pending) {
+			++mDroppedFrames;
+			next.pending = false;
+		}
+
+		next.zones.clear();
+		glQueryCounter(next.queries[0], GL_TIMESTAMP);
+	}
+
+	std::string GpuProfiler::to_json() const {
+		std::string json = std::format("{{\"frameMs\":{:.4f},\"averageFrameMs\":{:.4f},\"droppedFrames\":{},\"zones\":[", mFrameMs, mAverageFrameMs, mDroppedFrames);
+
+		bool first = true;
+		for (std::uint32_t i = 0; i < mResolved.size(); ++i) {
+			if (mResolved[i].parent != kNoParent) continue;
+			if (!first) json += ',';
+			write_zone(json, mResolved, i);
+			first = false;
+		}
+
+		json += "]}";
+		return json;
+	}
+
+	bool GpuProfiler::write_json(char const* path) const {
+		std::ofstream file(path, std::ios::binary);
+		if (!file) {
+			VP_LOG_ERROR("GPU profiler: unable to write {}", path);
+			return false;
+		}
+
+		file << to_json();
+		return static_cast<bool>(file);
+	}
+
+	void GpuProfiler::make_active() {
+		gActive = this;
+	}
+
+	GpuProfiler* GpuProfiler::active() {
+		return gActive;
+	}
+}
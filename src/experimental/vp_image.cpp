@@ -3,22 +3,29 @@
 #ifdef VP_HAS_STB_IMAGE
 
 #include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+#include "vulpengine/experimental/vp_vfs.hpp"
 
 #include <stb_image.h>
 
 namespace vulpengine::experimental {
 	Image::Image(char const* filename, bool flip) {
-		stbi_set_flip_vertically_on_load(flip);
-		mPixels = stbi_load(filename, &mWidth, &mHeight, nullptr, 4);
+		vfs::File const file = vfs::open(filename);
 
-		if (!mPixels) {
-			VP_LOG_ERROR("{}", stbi_failure_reason());
+		if (!file) {
+			VP_LOG_ERROR("Unable to open image {}", filename);
+			return;
 		}
+
+		*this = Image(file.bytes(), flip);
 	}
 
-	Image::Image(std::string const& filename, bool flip) {
-		stbi_set_flip_vertically_on_load(flip);
-		mPixels = stbi_load(filename.c_str(), &mWidth, &mHeight, nullptr, 4);
+	Image::Image(std::string const& filename, bool flip) : Image(filename.c_str(), flip) {}
+
+	Image::Image(std::span<std::byte const> encoded, bool flip) {
+		// Images decode on job workers, the global flag would race
+		stbi_set_flip_vertically_on_load_thread(flip);
+		mPixels = stbi_load_from_memory(reinterpret_cast<stbi_uc const*>(encoded.data()), static_cast<int>(encoded.size()), &mWidth, &mHeight, nullptr, 4);
 
 		if (!mPixels) {
 			VP_LOG_ERROR("{}", stbi_failure_reason());
@@ -37,5 +44,17 @@ namespace vulpengine::experimental {
 			stbi_image_free(mPixels);
 		}
 	}
+
+	Task<Image> load_image(std::filesystem::path path, bool flip) {
+		vfs::File const file = co_await tasks::read_file(path);
+
+		if (!file) {
+			VP_LOG_ERROR("Unable to open image {}", path.string());
+			co_return Image();
+		}
+
+		VP_PROFILE_CPU_N("decode image");
+		co_return Image(file.bytes(), flip);
+	}
 }
 #endif // VP_HAS_STB_IMAGE
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include "vulpengine/experimental/vp_jobs.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vulpengine::experimental::jobs {
+	using detail::Job;
+
+	struct detail::CounterAccess final {
+		static void add(Counter& counter) {
+			counter.mPending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static void lock(Counter& counter) {
+			while (counter.mLock.test_and_set(std::memory_order_acquire))
+				std::this_thread::yield();
+		}
+
+		static void unlock(Counter& counter) {
+			counter.mLock.clear(std::memory_order_release);
+		}
+
+		// Returns the continuations to queue once the counter reaches zero. The last decrement
+		// happens under the lock, `done` waits for the unlock so the counter outlives this call.
+		static Job* finish(Counter& counter) {
+			std::uint32_t pending = counter.mPending.load(std::memory_order_relaxed);
+			while (pending > 1)
+				if (counter.mPending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+					return nullptr;
+
+			lock(counter);
+			Job* continuations = nullptr;
+			if (counter.mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				continuations = std::exchange(counter.mContinuations, nullptr);
+			unlock(counter);
+			return continuations;
+		}
+
+		// False if the counter is already zero, the job should run right away
+		static bool defer(Counter& counter, Job* job) {
+			lock(counter);
+			bool const pending = counter.mPending.load(std::memory_order_acquire) != 0;
+
+			if (pending) {
+				job->next = counter.mContinuations;
+				counter.mContinuations = job;
+			}
+
+			unlock(counter);
+			return pending;
+		}
+	};
+
+	namespace {
+		constexpr std::size_t kJobBlockSize = 64;
+		constexpr std::size_t kJobCacheSize = 256;
+		constexpr int kIdleSpins = 32;
+
+		// Chase-Lev deque as in "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al. 2013).
+		// The owner pushes and pops at the bottom, thieves take from the top.
+		class WorkDeque final {
+		public:
+			WorkDeque(std::size_t capacity) : mJobs(std::make_unique<std::atomic<Job*>[]>(capacity)), mMask(static_cast<std::int64_t>(capacity) - 1) {}
+
+			// Owner only, false when full
+			bool push(Job* job) {
+				std::int64_t const bottom = mBottom.load(std::memory_order_relaxed);
+				std::int64_t const top = mTop.load(std::memory_order_acquire);
+				if (bottom - top > mMask) return false;
+
+				mJobs[bottom & mMask].store(job, std::memory_order_relaxed);
+				mBottom.store(bottom + 1, std::memory_order_release); // The paper's release fence, as a store sanitizers understand
+				return true;
+			}
+
+			// Owner only
+			Job* pop() {
+				std::int64_t const bottom = mBottom.load(std::memory_order_relaxed) - 1;
+				mBottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::int64_t top = mTop.load(std::memory_order_relaxed);
+
+				if (top > bottom) {
+					mBottom.store(bottom + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+
+				Job* job = mJobs[bottom & mMask].load(std::memory_order_relaxed);
+
+				// The last job, race thieves for it
+				if (top == bottom) {
+					if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+						job = nullptr;
+					mBottom.store(bottom + 1, std::memory_order_relaxed);
+				}
+
+				return job;
+			}
+
+			// Any thread
+			Job* steal() {
+				std::int64_t top = mTop.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::int64_t const bottom = mBottom.load(std::memory_order_acquire);
+				if (top >= bottom) return nullptr;
+
+				Job* job = mJobs[top & mMask].load(std::memory_order_relaxed);
+				if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					return nullptr; // Lost to another thief or the owner
+				return job;
+			}
+		private:
+			alignas(64) std::atomic<std::int64_t> mTop = 0;
+			alignas(64) std::atomic<std::int64_t> mBottom = 0;
+			std::unique_ptr<std::atomic<Job*>[]> mJobs;
+			std::int64_t mMask;
+		};
+
+		struct Scheduler final {
+			std::vector<std::unique_ptr<WorkDeque>> deques; // Main thread first, then one per worker
+			std::vector<std::thread> workers;
+
+			// Submissions from threads without a deque
+			std::mutex injectedMutex;
+			std::deque<Job*> injected;
+			std::atomic<std::size_t> injectedCount = 0;
+
+			std::atomic_bool stop = false;
+			std::atomic<std::uint32_t> epoch = 0;
+			std::atomic<std::uint32_t> sleeping = 0;
+		};
+
+		std::mutex gInitMutex;
+		std::atomic<Scheduler*> gScheduler = nullptr;
+		std::atomic<std::uint32_t> gGeneration = 0; // Tells thread locals from a previous init apart
+
+		// Profiler thread names must outlive the profiler
+		std::deque<std::string> gThreadNames;
+
+		struct ThreadState final {
+			std::uint32_t index = kForeignThread;
+			std::uint32_t generation = 0;
+			std::uint64_t random = 0x9E3779B97F4A7C15ull;
+		};
+
+		thread_local ThreadState tThread;
+
+		// Jobs are recycled through a per thread cache backed by a shared pool that is never freed
+		struct JobPool final {
+			std::mutex mutex;
+			std::vector<Job*> free;
+			std::vector<std::unique_ptr<Job[]>> blocks;
+		};
+
+		JobPool& job_pool() {
+			static JobPool* pool = new JobPool;
+			return *pool;
+		}
+
+		struct JobCache final {
+			std::vector<Job*> jobs;
+
+			~JobCache() noexcept {
+				if (jobs.empty()) return;
+				JobPool& pool = job_pool();
+				std::lock_guard lock(pool.mutex);
+				pool.free.insert(pool.free.end(), jobs.begin(), jobs.end());
+			}
+		};
+
+		thread_local JobCache tJobCache;
+
+		void release_job(Job* job) {
+			std::vector<Job*>& cache = tJobCache.jobs;
+			cache.push_back(job);
+			if (cache.size() < kJobCacheSize) return;
+
+			// Jobs finish on whichever thread ran them, hand half back so submitting threads don't run dry
+			JobPool& pool = job_pool();
+			std::lock_guard lock(pool.mutex);
+			pool.free.insert(pool.free.end(), cache.begin() + kJobCacheSize / 2, cache.end());
+			cache.resize(kJobCacheSize / 2);
+		}
+
+		WorkDeque* own_deque(Scheduler& scheduler) {
+			if (tThread.index == kForeignThread || tThread.generation != gGeneration.load(std::memory_order_relaxed)) return nullptr;
+			return scheduler.deques[tThread.index].get();
+		}
+
+		std::uint64_t next_random() {
+			std::uint64_t& state = tThread.random;
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+
+		Job* find_job(Scheduler& scheduler) {
+			WorkDeque* own = own_deque(scheduler);
+			if (own) {
+				if (Job* job = own->pop()) return job;
+			}
+
+			if (scheduler.injectedCount.load(std::memory_order_acquire)) {
+				std::lock_guard lock(scheduler.injectedMutex);
+				if (!scheduler.injected.empty()) {
+					Job* job = scheduler.injected.front();
+					scheduler.injected.pop_front();
+					scheduler.injectedCount.fetch_sub(1, std::memory_order_relaxed);
+					return job;
+				}
+			}
+
+			// Starting from a random victim spreads thieves out
+			std::size_t const count = scheduler.deques.size();
+			std::size_t const start = static_cast<std::size_t>(next_random() % count);
+
+			for (std::size_t i = 0; i < count; ++i) {
+				WorkDeque* victim = scheduler.deques[(start + i) % count].get();
+				if (victim == own) continue;
+				if (Job* job = victim->steal()) return job;
+			}
+
+			return nullptr;
+		}
+
+		void wake(Scheduler& scheduler) {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!scheduler.sleeping.load(std::memory_order_seq_cst)) return;
+
+			scheduler.epoch.fetch_add(1, std::memory_order_seq_cst);
+			scheduler.epoch.notify_one();
+		}
+
+		// The counter was incremented when the job was submitted
+		void enqueue(Scheduler& scheduler, Job* job);
+
+		void execute(Scheduler& scheduler, Job* job) {
+			{
+#ifdef VP_HAS_TRACY
+				ZoneScopedN("job");
+				ZoneName(job->name, std::strlen(job->name));
+#else
+				VP_PROFILE_CPU_N(job->name);
+#endif
+				job->invoke(*job);
+			}
+
+			Counter* counter = job->counter;
+			release_job(job);
+			if (!counter) return;
+
+			for (Job* continuation = detail::CounterAccess::finish(*counter); continuation;) {
+				Job* next = continuation->next;
+				enqueue(scheduler, continuation);
+				continuation = next;
+			}
+		}
+
+		void enqueue(Scheduler& scheduler, Job* job) {
+			if (WorkDeque* own = own_deque(scheduler)) {
+				if (!own->push(job)) {
+					execute(scheduler, job); // Full, running it now keeps the submitter from blocking
+					return;
+				}
+			} else {
+				std::lock_guard lock(scheduler.injectedMutex);
+				scheduler.injected.push_back(job);
+				scheduler.injectedCount.fetch_add(1, std::memory_order_release);
+			}
+
+			wake(scheduler);
+		}
+
+		void worker_loop(Scheduler& scheduler, std::uint32_t index, std::uint32_t generation, char const* name) {
+			tThread.index = index;
+			tThread.generation = generation;
+			tThread.random ^= static_cast<std::uint64_t>(index) * 0xBF58476D1CE4E5B9ull;
+
+#ifdef VP_HAS_TRACY
+			tracy::SetThreadName(name);
+#else
+			profiler::set_thread_name(name);
+#endif
+
+			while (!scheduler.stop.load(std::memory_order_acquire)) {
+				Job* job = nullptr;
+
+				for (int spin = 0; spin < kIdleSpins && !job; ++spin) {
+					job = find_job(scheduler);
+					if (!job) std::this_thread::yield();
+				}
+
+				if (job) {
+					execute(scheduler, job);
+					continue;
+				}
+
+				// Checked again after announcing sleep, a submitter either sees us sleeping or we see its job
+				scheduler.sleeping.fetch_add(1, std::memory_order_seq_cst);
+				std::uint32_t const epoch = scheduler.epoch.load(std::memory_order_seq_cst);
+
+				if (!scheduler.stop.load(std::memory_order_acquire)) {
+					if ((job = find_job(scheduler))) {
+						scheduler.sleeping.fetch_sub(1, std::memory_order_relaxed);
+						execute(scheduler, job);
+						continue;
+					}
+
+					scheduler.epoch.wait(epoch, std::memory_order_seq_cst);
+				}
+
+				scheduler.sleeping.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		Scheduler& scheduler() {
+			Scheduler* scheduler = gScheduler.load(std::memory_order_acquire);
+			if (!scheduler) {
+				init();
+				scheduler = gScheduler.load(std::memory_order_acquire);
+			}
+			return *scheduler;
+		}
+	}
+
+	Job* detail::allocate_job() {
+		std::vector<Job*>& cache = tJobCache.jobs;
+
+		if (cache.empty()) {
+			JobPool& pool = job_pool();
+			std::lock_guard lock(pool.mutex);
+
+			if (pool.free.empty()) {
+				pool.blocks.push_back(std::make_unique<Job[]>(kJobBlockSize));
+				for (std::size_t i = 0; i < kJobBlockSize; ++i) cache.push_back(&pool.blocks.back()[i]);
+			} else {
+				std::size_t const take = std::min(pool.free.size(), kJobBlockSize);
+				cache.insert(cache.end(), pool.free.end() - take, pool.free.end());
+				pool.free.resize(pool.free.size() - take);
+			}
+		}
+
+		Job* job = cache.back();
+		cache.pop_back();
+		job->next = nullptr;
+		return job;
+	}
+
+	void detail::submit(Job* job) {
+		Scheduler& scheduler = jobs::scheduler();
+		if (job->counter) CounterAccess::add(*job->counter);
+		enqueue(scheduler, job);
+	}
+
+	void detail::submit_after(Counter& dependency, Job* job) {
+		Scheduler& scheduler = jobs::scheduler();
+		if (job->counter) CounterAccess::add(*job->counter);
+		if (!CounterAccess::defer(dependency, job)) enqueue(scheduler, job);
+	}
+
+	void init(CreateInfo const& info) {
+		std::lock_guard lock(gInitMutex);
+		if (gScheduler.load(std::memory_order_acquire)) return;
+
+		std::uint32_t const workerCount = info.workerCount.value_or(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+		std::size_t capacity = 2;
+		while (capacity < info.dequeCapacity) capacity *= 2;
+
+		auto* scheduler = new Scheduler;
+		for (std::uint32_t i = 0; i <= workerCount; ++i)
+			scheduler->deques.push_back(std::make_unique<WorkDeque>(capacity));
+
+		std::uint32_t const generation = gGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+		tThread.index = 0;
+		tThread.generation = generation;
+
+		while (gThreadNames.size() < workerCount)
+			gThreadNames.push_back("Job Worker " + std::to_string(gThreadNames.size() + 1));
+
+		gScheduler.store(scheduler, std::memory_order_release);
+
+		for (std::uint32_t i = 1; i <= workerCount; ++i)
+			scheduler->workers.emplace_back(worker_loop, std::ref(*scheduler), i, generation, gThreadNames[i - 1].c_str());
+
+		VP_LOG_DEBUG("Job system started with {} workers", workerCount);
+	}
+
+	void shutdown() {
+		std::lock_guard lock(gInitMutex);
+		Scheduler* scheduler = gScheduler.load(std::memory_order_acquire);
+		if (!scheduler) return;
+
+		scheduler->stop.store(true, std::memory_order_release);
+		scheduler->epoch.fetch_add(1, std::memory_order_seq_cst);
+		scheduler->epoch.notify_all();
+
+		for (std::thread& worker : scheduler->workers) worker.join();
+
+		// Whatever the workers left behind runs here, jobs submitted meanwhile land in the main deque
+		while (Job* job = find_job(*scheduler))
+			execute(*scheduler, job);
+
+		gScheduler.store(nullptr, std::memory_order_release);
+		gGeneration.fetch_add(1, std::memory_order_relaxed);
+		delete scheduler;
+	}
+
+	bool initialized() {
+		return gScheduler.load(std::memory_order_acquire) != nullptr;
+	}
+
+	std::uint32_t worker_count() {
+		Scheduler* scheduler = gScheduler.load(std::memory_order_acquire);
+		return scheduler ? static_cast<std::uint32_t>(scheduler->workers.size()) : 0;
+	}
+
+	std::uint32_t thread_index() {
+		if (tThread.generation != gGeneration.load(std::memory_order_relaxed)) return kForeignThread;
+		return tThread.index;
+	}
+
+	void wait(Counter& counter) {
+		if (counter.done()) return;
+
+		VP_PROFILE_CPU_N("jobs::wait");
+		Scheduler& scheduler = jobs::scheduler();
+
+		while (!counter.done()) {
+			if (Job* job = find_job(scheduler)) {
+				execute(scheduler, job);
+				continue;
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
+	bool run_one() {
+		Scheduler* scheduler = gScheduler.load(std::memory_order_acquire);
+		if (!scheduler) return false;
+
+		Job* job = find_job(*scheduler);
+		if (!job) return false;
+
+		execute(*scheduler, job);
+		return true;
+	}
+}
@@ -1,6 +1,11 @@
 #include "vulpengine/vp_log.hpp"
 #include "vulpengine/vp_util.hpp"
+#include "vulpengine/vp_profile.hpp"
 #include "vulpengine/experimental/vp_ogl.hpp"
+#include "vulpengine/experimental/vp_ogl_state.hpp"
+#include "vulpengine/experimental/vp_gpu_memory.hpp"
+#include "vulpengine/experimental/vp_jobs.hpp"
+#include "vulpengine/experimental/vp_stream.hpp"
 
 #include <stb_include.h>
 
@@ -9,10 +14,19 @@
 #endif
 
 #include <cassert>
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <format>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <fstream>
+#include <filesystem>
+#include <future>
+#include <chrono>
+#include <thread>
 
 namespace {
 #define VP_IMPL_EXPAND(x) case x: return #x
@@ -60,6 +74,7 @@ namespace vulpengine::experimental {
 
 		glCreateBuffers(1, &mHandle);
 		glNamedBufferStorage(mHandle, info.content.size_bytes(), info.content.data(), info.flags);
+		gpumemory::track(gpumemory::Category::kBuffer, mHandle, info.content.size_bytes(), info.label);
 
 		if (!info.label.empty()) {
 			glObjectLabel(GL_BUFFER, mHandle, static_cast<GLsizei>(info.label.size()), info.label.data());
@@ -73,12 +88,18 @@ namespace vulpengine::experimental {
 
 	Buffer::~Buffer() noexcept {
 		if (mHandle) {
+			glstate::forget_buffer(mHandle);
+			gpumemory::untrack(gpumemory::Category::kBuffer, mHandle);
 			glDeleteBuffers(1, &mHandle);
 		}
 	}
 
 	void Buffer::bind_base(GLenum target, GLuint index) const {
-		glBindBufferBase(target, index, mHandle);
+		glstate::bind_buffer_base(target, index, mHandle);
+	}
+
+	void Buffer::bind_range(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) const {
+		glstate::bind_buffer_range(target, index, mHandle, offset, size);
 	}
 
 	void Buffer::upload(GLintptr offset, std::span<std::byte const> data) const {
@@ -134,12 +155,14 @@ namespace vulpengine::experimental {
 	}
 
 	Framebuffer::~Framebuffer() noexcept {
-		if (mHandle)
+		if (mHandle) {
+			glstate::forget_framebuffer(mHandle);
 			glDeleteFramebuffers(1, &mHandle);
+		}
 	}
 
 	void Framebuffer::bind() {
-		glBindFramebuffer(GL_FRAMEBUFFER, mHandle);
+		glstate::bind_framebuffer(GL_FRAMEBUFFER, mHandle);
 	}
 }
 
@@ -152,6 +175,7 @@ namespace vulpengine::experimental {
 
 		glCreateRenderbuffers(1, &mHandle);
 		glNamedRenderbufferStorage(mHandle, info.internalFormat, info.width, info.height);
+		gpumemory::track(gpumemory::Category::kRenderbuffer, mHandle, gpumemory::renderbuffer_size(mHandle, info.internalFormat, info.width, info.height), info.label);
 
 		if (!info.label.empty())
 			glObjectLabel(GL_RENDERBUFFER, mHandle, static_cast<GLsizei>(info.label.size()), info.label.data());
@@ -163,8 +187,10 @@ namespace vulpengine::experimental {
 	}
 
 	Renderbuffer::~Renderbuffer() noexcept {
-		if (mHandle)
+		if (mHandle) {
+			gpumemory::untrack(gpumemory::Category::kRenderbuffer, mHandle);
 			glDeleteRenderbuffers(1, &mHandle);
+		}
 	}
 }
 
@@ -252,12 +278,15 @@ namespace vulpengine::experimental {
 		assert(info.levels > 0);
 
 		glCreateTextures(info.target, 1, &mHandle);
+		mInternalFormat = info.internalFormat;
 
 		if (info.depth > 0)
 			glTextureStorage3D(mHandle, info.levels, info.internalFormat, info.width, info.height, info.depth);
 		else
 			glTextureStorage2D(mHandle, info.levels, info.internalFormat, info.width, info.height);
 
+		gpumemory::track(gpumemory::Category::kTexture, mHandle, gpumemory::texture_size(mHandle, info.target, info.internalFormat, info.levels, info.width, info.height, info.depth), info.label);
+
 		glTextureParameteri(mHandle, GL_TEXTURE_MIN_FILTER, info.minFilter);
 		glTextureParameteri(mHandle, GL_TEXTURE_MAG_FILTER, info.magFilter);
 		glTextureParameteri(mHandle, GL_TEXTURE_WRAP_S, info.wrap);
@@ -279,12 +308,15 @@ namespace vulpengine::experimental {
 
 	Texture& Texture::operator=(Texture&& other) noexcept {
 		std::swap(mHandle, other.mHandle);
+		std::swap(mInternalFormat, other.mInternalFormat);
 		return *this;
 	}
 
 	Texture::~Texture() noexcept {
 		if (mHandle) {
 			VP_LOG_TRACE("Destroyed texture: {}", mHandle);
+			glstate::forget_texture(mHandle);
+			gpumemory::untrack(gpumemory::Category::kTexture, mHandle);
 			glDeleteTextures(1, &mHandle);
 		}
 	}
@@ -302,12 +334,28 @@ namespace vulpengine::experimental {
 	}
 
 	void Texture::bind(GLuint unit) const {
-		glBindTextureUnit(unit, mHandle);
+		glstate::bind_texture_unit(unit, mHandle);
 	}
 
 	void Texture::generate_mips() const {
 		glGenerateTextureMipmap(mHandle);
 	}
+
+	void Texture::bind_image(GLuint unit, GLenum access, GLint level, GLenum format) const {
+		assert(access == GL_READ_ONLY || access == GL_WRITE_ONLY || access == GL_READ_WRITE);
+		glBindImageTexture(unit, mHandle, level, GL_TRUE, 0, access, format == GL_NONE ? mInternalFormat : format);
+	}
+}
+
+// Memory Barriers
+namespace vulpengine::experimental {
+	void memory_barrier(Barrier barriers) {
+		glMemoryBarrier(static_cast<GLbitfield>(barriers));
+	}
+
+	void memory_barrier_by_region(Barrier barriers) {
+		glMemoryBarrierByRegion(static_cast<GLbitfield>(barriers));
+	}
 }
 
 // Vertex Array
@@ -364,13 +412,14 @@ namespace vulpengine::experimental {
 
 	VertexArray::~VertexArray() noexcept {
 		if (mHandle) {
+			glstate::forget_vertex_array(mHandle);
 			glDeleteVertexArrays(1, &mHandle);
 		}
 	}
 
 	void VertexArray::bind() const {
 		assert(valid());
-		glBindVertexArray(mHandle);
+		glstate::bind_vertex_array(mHandle);
 	}
 }
 
@@ -385,6 +434,28 @@ namespace vulpengine::experimental {
 			return source;
 		}
 
+		// Non blocking, true once the driver finished compiling or linking, always true without parallel compile support
+		bool completed(GLuint handle, bool program) {
+			GLint completionStatus = GL_TRUE;
+#if defined(GL_KHR_parallel_shader_compile)
+			if (GLAD_GL_KHR_parallel_shader_compile) {
+				if (program) glGetProgramiv(handle, GL_COMPLETION_STATUS_KHR, &completionStatus);
+				else glGetShaderiv(handle, GL_COMPLETION_STATUS_KHR, &completionStatus);
+				return completionStatus;
+			}
+#endif
+#if defined(GL_ARB_parallel_shader_compile)
+			if (GLAD_GL_ARB_parallel_shader_compile) {
+				if (program) glGetProgramiv(handle, GL_COMPLETION_STATUS_ARB, &completionStatus);
+				else glGetShaderiv(handle, GL_COMPLETION_STATUS_ARB, &completionStatus);
+				return completionStatus;
+			}
+#endif
+			return completionStatus;
+		}
+
+		// Compilation is only issued here, errors are reported by `check`.
+		// This lets the driver compile multiple shaders at once with KHR_parallel_shader_compile.
 		class Shader final {
 		public:
 			struct CreateInfo {
@@ -406,32 +477,10 @@ namespace vulpengine::experimental {
 				glShaderSource(mHandle, 1, &string, &length);
 				glCompileShader(mHandle);
 
-				GLint infoLogLength;
-				glGetShaderiv(mHandle, GL_INFO_LOG_LENGTH, &infoLogLength);
-
-				GLint compileStatus;
-				glGetShaderiv(mHandle, GL_COMPILE_STATUS, &compileStatus);
-
-				if (infoLogLength > 0) {
-					std::string infoLog;
-					infoLog.resize(infoLogLength);
-					glGetShaderInfoLog(mHandle, infoLogLength, nullptr, infoLog.data());
-
-					if (compileStatus)
-						VP_LOG_INFO("Shader info log in {}: {}", info.label, infoLog);
-					else
-						VP_LOG_ERROR("Shader compile error in {}: {}", info.label, infoLog);
-				}
-
 				if (!info.label.empty())
 					glObjectLabel(GL_SHADER, mHandle, static_cast<GLsizei>(info.label.size()), info.label.data());
 
 				VP_LOG_TRACE("Created shader: {}", mHandle);
-
-				if (!compileStatus) {
-					Shader::~Shader();
-					mHandle = 0;
-				}
 			}
 
 			Shader(Shader const&) = delete;
@@ -449,6 +498,33 @@ namespace vulpengine::experimental {
 				}
 			}
 
+			// Non blocking, always true without parallel compile support
+			bool complete() const {
+				return completed(mHandle, false);
+			}
+
+			// Blocks until compilation has finished, logs and returns the compile status
+			bool check(std::string_view label) const {
+				GLint infoLogLength;
+				glGetShaderiv(mHandle, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+				GLint compileStatus;
+				glGetShaderiv(mHandle, GL_COMPILE_STATUS, &compileStatus);
+
+				if (infoLogLength > 0) {
+					std::string infoLog;
+					infoLog.resize(infoLogLength);
+					glGetShaderInfoLog(mHandle, infoLogLength, nullptr, infoLog.data());
+
+					if (compileStatus)
+						VP_LOG_INFO("Shader info log in {}: {}", label, infoLog);
+					else
+						VP_LOG_ERROR("Shader compile error in {}: {}", label, infoLog);
+				}
+
+				return compileStatus;
+			}
+
 			inline explicit operator bool() const { return mHandle; }
 			inline bool valid() const { return mHandle; }
 			inline GLuint handle() const { return mHandle; }
@@ -457,107 +533,590 @@ namespace vulpengine::experimental {
 		};
 	}
 
-	ShaderProgram::ShaderProgram(CreateInfo const& info) {
-		assert(info.file != nullptr);
+	namespace {
+		struct Introspection final {
+			UnorderedStringMap<int> uniforms;
+			UnorderedStringMap<ShaderProgram::Block> uniformBlocks;
+			UnorderedStringMap<ShaderProgram::Block> storageBlocks;
+		};
 
-		std::unique_ptr vertSource = preprocessShader(info.file, "#version 460 core\n#define VERT", info.includePath);
-		if (!vertSource) return;
+		UnorderedStringMap<int> introspect_uniforms(GLuint program) {
+			UnorderedStringMap<int> uniforms;
 
-		std::unique_ptr fragSource = preprocessShader(info.file, "#version 460 core\n#define FRAG", info.includePath);
-		if (!fragSource) return;
+			GLint activeUniforms;
+			GLint maxUniformNameLength;
+			glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &activeUniforms);
+			glGetProgramInterfaceiv(program, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxUniformNameLength);
 
-		std::string vertLabel = std::format("{} [vert]", info.file);
-		std::string fragLabel = std::format("{} [frag]", info.file);
+			std::unique_ptr<char[]> uniformNameBuffer = std::make_unique<char[]>(maxUniformNameLength);
 
-		Shader vert = { {
-			.type = GL_VERTEX_SHADER,
-			.source = vertSource.get(),
-			.label = vertLabel
-		} };
+			for (int i = 0; i < activeUniforms; ++i) {
+				GLsizei length;
+				glGetProgramResourceName(program, GL_UNIFORM, i, maxUniformNameLength, &length, uniformNameBuffer.get());
+				std::string_view name(uniformNameBuffer.get(), length);
 
-		if (!vert) return;
+				std::array<GLenum, 1> properties = { GL_LOCATION };
+				GLint location;
+				glGetProgramResourceiv(program, GL_UNIFORM, i, static_cast<GLsizei>(properties.size()), properties.data(), 1, nullptr, &location);
 
-		Shader frag = { {
-			.type = GL_FRAGMENT_SHADER,
-			.source = fragSource.get(),
-			.label = fragLabel
-		} };
+				if (location != -1) uniforms[std::string(name)] = location;
+			}
 
-		if (!frag) return;
+			return uniforms;
+		}
 
-		mHandle = glCreateProgram();
-		glAttachShader(mHandle, vert.handle());
-		glAttachShader(mHandle, frag.handle());
-		glLinkProgram(mHandle);
-		glDetachShader(mHandle, vert.handle());
-		glDetachShader(mHandle, frag.handle());
+		// `blockInterface` is GL_UNIFORM_BLOCK or GL_SHADER_STORAGE_BLOCK
+		// `variableInterface` is the matching GL_UNIFORM or GL_BUFFER_VARIABLE
+		UnorderedStringMap<ShaderProgram::Block> introspect_blocks(GLuint program, GLenum blockInterface, GLenum variableInterface) {
+			UnorderedStringMap<ShaderProgram::Block> blocks;
+
+			GLint activeBlocks;
+			GLint maxBlockNameLength;
+			GLint maxVariableNameLength;
+			glGetProgramInterfaceiv(program, blockInterface, GL_ACTIVE_RESOURCES, &activeBlocks);
+			glGetProgramInterfaceiv(program, blockInterface, GL_MAX_NAME_LENGTH, &maxBlockNameLength);
+			glGetProgramInterfaceiv(program, variableInterface, GL_MAX_NAME_LENGTH, &maxVariableNameLength);
+
+			if (activeBlocks <= 0) return blocks;
+
+			std::unique_ptr<char[]> nameBuffer = std::make_unique<char[]>(std::max(maxBlockNameLength, maxVariableNameLength));
+			bool const isStorage = variableInterface == GL_BUFFER_VARIABLE;
+
+			for (int i = 0; i < activeBlocks; ++i) {
+				GLsizei length;
+				glGetProgramResourceName(program, blockInterface, i, maxBlockNameLength, &length, nameBuffer.get());
+				std::string blockName(nameBuffer.get(), length);
+
+				std::array<GLenum, 3> blockProperties = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
+				std::array<GLint, 3> blockValues;
+				glGetProgramResourceiv(program, blockInterface, i, static_cast<GLsizei>(blockProperties.size()), blockProperties.data(), static_cast<GLsizei>(blockValues.size()), nullptr, blockValues.data());
+
+				ShaderProgram::Block& block = blocks[std::move(blockName)];
+				block.binding = blockValues[0];
+				block.size = blockValues[1];
+
+				std::vector<GLint> variables(blockValues[2]);
+				GLenum const activeVariables = GL_ACTIVE_VARIABLES;
+				glGetProgramResourceiv(program, blockInterface, i, 1, &activeVariables, static_cast<GLsizei>(variables.size()), nullptr, variables.data());
+
+				for (GLint variable : variables) {
+					glGetProgramResourceName(program, variableInterface, variable, maxVariableNameLength, &length, nameBuffer.get());
+					std::string_view name(nameBuffer.get(), length);
+					if (name.ends_with("[0]")) name.remove_suffix(3);
+
+					std::array<GLenum, 6> properties = { GL_TYPE, GL_OFFSET, GL_ARRAY_SIZE, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_TOP_LEVEL_ARRAY_STRIDE };
+					std::array<GLint, 6> values{};
+					GLsizei const propertyCount = static_cast<GLsizei>(properties.size()) - (isStorage ? 0 : 1);
+					glGetProgramResourceiv(program, variableInterface, variable, propertyCount, properties.data(), static_cast<GLsizei>(values.size()), nullptr, values.data());
+
+					block.members[std::string(name)] = {
+						.type = static_cast<GLenum>(values[0]),
+						.offset = values[1],
+						.arraySize = values[2],
+						.arrayStride = values[3],
+						.matrixStride = values[4],
+						.topLevelArrayStride = values[5]
+					};
+				}
+			}
 
-		GLint infoLogLength;
-		glGetProgramiv(mHandle, GL_INFO_LOG_LENGTH, &infoLogLength);
+			return blocks;
+		}
 
-		GLint linkStatus;
-		glGetProgramiv(mHandle, GL_LINK_STATUS, &linkStatus);
+		Introspection introspect(GLuint program) {
+			return {
+				.uniforms = introspect_uniforms(program),
+				.uniformBlocks = introspect_blocks(program, GL_UNIFORM_BLOCK, GL_UNIFORM),
+				.storageBlocks = introspect_blocks(program, GL_SHADER_STORAGE_BLOCK, GL_BUFFER_VARIABLE)
+			};
+		}
 
-		if (infoLogLength > 0) {
-			std::string infoLog;
-			infoLog.resize(infoLogLength);
-			glGetProgramInfoLog(mHandle, infoLogLength, nullptr, infoLog.data());
+		// Program binary cache file layout, all values are native endian:
+		// u32 magic, u32 version, u32 binaryFormat,
+		// u32 uniformCount, uniformCount * { string name, i32 location },
+		// 2 * (uniform blocks then storage blocks) {
+		//   u32 blockCount, blockCount * {
+		//     string name, i32 binding, i32 size,
+		//     u32 memberCount, memberCount * { string name, u32 type, i32 offset, arraySize, arrayStride, matrixStride, topLevelArrayStride }
+		//   }
+		// },
+		// u32 binaryLength, u8[binaryLength] binary
+		//
+		// Strings are stored as u32 length followed by the characters
+		constexpr std::uint32_t kProgramBinaryMagic = 0x42505056; // "VPPB"
+		constexpr std::uint32_t kProgramBinaryVersion = 2;
+
+		bool supports_program_binaries() {
+			static GLint const formats = [] {
+				GLint v = 0;
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &v);
+				return v;
+			}();
 
-			if (linkStatus)
-				VP_LOG_INFO("Program info log in {}: {}", info.file, infoLog);
-			else
-				VP_LOG_ERROR("Program link error in {}: {}", info.file, infoLog);
+			return formats > 0;
 		}
 
-		glObjectLabel(GL_PROGRAM, mHandle, -1, info.file);
+		// Binaries are only valid for the driver that produced them
+		std::string const& driver_identity() {
+			static std::string const identity = std::format("{}\n{}\n{}",
+				reinterpret_cast<char const*>(glGetString(GL_VENDOR)),
+				reinterpret_cast<char const*>(glGetString(GL_RENDERER)),
+				reinterpret_cast<char const*>(glGetString(GL_VERSION))
+			);
 
-		if (!linkStatus) {
-			glDeleteProgram(mHandle);
-			mHandle = 0;
+			return identity;
 		}
 
-		if (mHandle)
-			VP_LOG_TRACE("Created shader program: {}", mHandle);
+		std::filesystem::path program_binary_path(char const* directory, std::span<std::string_view const> sources) {
+			std::uint64_t hash = hash_fnv1a(driver_identity());
+			for (auto source : sources) {
+				// Hash the length too so moving text between stages changes the key
+				std::uint64_t const length = source.size();
+				hash = hash_fnv1a(std::string_view(reinterpret_cast<char const*>(&length), sizeof(length)), hash);
+				hash = hash_fnv1a(source, hash);
+			}
 
-		if (!mHandle) return;
+			return std::filesystem::path(directory) / std::format("{:016x}.bin", hash);
+		}
 
-		// Do introspection
+		class BinaryReader final {
+		public:
+			BinaryReader(std::span<char const> data) : mData(data) {}
 
-		GLint activeUniforms;
-		GLint maxUniformNameLength;
-		glGetProgramInterfaceiv(mHandle, GL_UNIFORM, GL_ACTIVE_RESOURCES, &activeUniforms);
-		glGetProgramInterfaceiv(mHandle, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxUniformNameLength);
+			template<class T>
+			bool read(T& value) {
+				return read(&value, sizeof(T));
+			}
 
-		std::unique_ptr<char[]> uniformNameBuffer = std::make_unique<char[]>(maxUniformNameLength);
+			bool read(std::string& value) {
+				std::uint32_t length;
+				if (!read(length)) return false;
+				if (mData.size() - mOffset < length) return false;
+				value.assign(mData.data() + mOffset, length);
+				mOffset += length;
+				return true;
+			}
 
-		for (int i = 0; i < activeUniforms; ++i) {
-			GLsizei length;
-			glGetProgramResourceName(mHandle, GL_UNIFORM, i, maxUniformNameLength, &length, uniformNameBuffer.get());
-			std::string_view name(uniformNameBuffer.get(), length);
+			bool read(void* data, std::size_t size) {
+				if (mData.size() - mOffset < size) return false;
+				memcpy(data, mData.data() + mOffset, size);
+				mOffset += size;
+				return true;
+			}
+		private:
+			std::span<char const> mData;
+			std::size_t mOffset = 0;
+		};
+
+		void write_string(ByteStream& stream, std::string_view value) {
+			stream.write(static_cast<std::uint32_t>(value.size()));
+			stream.write(value.data(), value.size());
+		}
+
+		bool read_blocks(BinaryReader& reader, UnorderedStringMap<ShaderProgram::Block>& blocks) {
+			std::uint32_t blockCount;
+			if (!reader.read(blockCount)) return false;
+
+			for (std::uint32_t i = 0; i < blockCount; ++i) {
+				std::string blockName;
+				ShaderProgram::Block block;
+				std::uint32_t memberCount;
+
+				if (!(reader.read(blockName) && reader.read(block.binding) && reader.read(block.size) && reader.read(memberCount)))
+					return false;
+
+				for (std::uint32_t j = 0; j < memberCount; ++j) {
+					std::string name;
+					ShaderProgram::BlockMember member;
+					std::uint32_t type;
+
+					if (!(reader.read(name) && reader.read(type) && reader.read(member.offset) && reader.read(member.arraySize) &&
+						reader.read(member.arrayStride) && reader.read(member.matrixStride) && reader.read(member.topLevelArrayStride)))
+						return false;
+
+					member.type = type;
+					block.members[std::move(name)] = member;
+				}
+
+				blocks[std::move(blockName)] = std::move(block);
+			}
+
+			return true;
+		}
+
+		void write_blocks(ByteStream& stream, UnorderedStringMap<ShaderProgram::Block> const& blocks) {
+			stream.write(static_cast<std::uint32_t>(blocks.size()));
+
+			for (auto const& [blockName, block] : blocks) {
+				write_string(stream, blockName);
+				stream.write(static_cast<std::int32_t>(block.binding));
+				stream.write(static_cast<std::int32_t>(block.size));
+				stream.write(static_cast<std::uint32_t>(block.members.size()));
+
+				for (auto const& [name, member] : block.members) {
+					write_string(stream, name);
+					stream.write(static_cast<std::uint32_t>(member.type));
+					stream.write(static_cast<std::int32_t>(member.offset));
+					stream.write(static_cast<std::int32_t>(member.arraySize));
+					stream.write(static_cast<std::int32_t>(member.arrayStride));
+					stream.write(static_cast<std::int32_t>(member.matrixStride));
+					stream.write(static_cast<std::int32_t>(member.topLevelArrayStride));
+				}
+			}
+		}
+
+		GLuint load_program_binary(std::filesystem::path const& path, Introspection& introspection) {
+			std::optional<std::vector<char>> file = read_file(path);
+			if (!file) return 0;
+
+			BinaryReader reader(*file);
+
+			std::uint32_t magic, version, binaryFormat, uniformCount;
+			bool valid = reader.read(magic) && reader.read(version) && reader.read(binaryFormat) && reader.read(uniformCount);
+			valid = valid && magic == kProgramBinaryMagic && version == kProgramBinaryVersion;
+
+			for (std::uint32_t i = 0; valid && i < uniformCount; ++i) {
+				std::string name;
+				std::int32_t location;
+
+				valid = reader.read(name) && reader.read(location);
+				if (valid) introspection.uniforms[std::move(name)] = location;
+			}
+
+			valid = valid && read_blocks(reader, introspection.uniformBlocks);
+			valid = valid && read_blocks(reader, introspection.storageBlocks);
+
+			std::uint32_t binaryLength;
+			std::vector<std::byte> binary;
+			valid = valid && reader.read(binaryLength);
+			if (valid) binary.resize(binaryLength);
+			valid = valid && reader.read(binary.data(), binary.size());
+
+			GLint linkStatus = GL_FALSE;
+			GLuint program = 0;
+
+			if (valid) {
+				program = glCreateProgram();
+				glProgramBinary(program, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+				glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+			}
+
+			if (!linkStatus) {
+				// Driver updates invalidate binaries, drop the stale entry so it gets rebuilt
+				VP_LOG_WARN("Rejected program binary: {}", path.string());
+				if (program) glDeleteProgram(program);
+				introspection = {};
+
+				std::error_code ec;
+				std::filesystem::remove(path, ec);
+				return 0;
+			}
+
+			return program;
+		}
+
+		void store_program_binary(std::filesystem::path const& path, GLuint program, Introspection const& introspection) {
+			GLint binaryLength = 0;
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+			if (binaryLength <= 0) return;
+
+			std::vector<std::byte> binary(binaryLength);
+			GLenum binaryFormat;
+			glGetProgramBinary(program, binaryLength, &binaryLength, &binaryFormat, binary.data());
+
+			ByteStream stream;
+			stream.write(kProgramBinaryMagic);
+			stream.write(kProgramBinaryVersion);
+			stream.write(static_cast<std::uint32_t>(binaryFormat));
+			stream.write(static_cast<std::uint32_t>(introspection.uniforms.size()));
+
+			for (auto const& [name, location] : introspection.uniforms) {
+				write_string(stream, name);
+				stream.write(static_cast<std::int32_t>(location));
+			}
 
-			std::array<GLenum, 1> properties = { GL_LOCATION };
-			GLint location;
-			glGetProgramResourceiv(mHandle, GL_UNIFORM, i, static_cast<GLsizei>(properties.size()), properties.data(), 1, nullptr, &location);
+			write_blocks(stream, introspection.uniformBlocks);
+			write_blocks(stream, introspection.storageBlocks);
 
-			if (location != -1) mActiveUniforms[std::string(name)] = location;
+			stream.write(static_cast<std::uint32_t>(binaryLength));
+			stream.write(binary.data(), binaryLength);
+
+			std::error_code ec;
+			std::filesystem::create_directories(path.parent_path(), ec);
+
+			// Write then rename, a crash while writing must not leave a truncated entry behind
+			std::filesystem::path temporary = path;
+			temporary += ".tmp";
+
+			{
+				std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!file) {
+					VP_LOG_WARN("Failed to write program binary: {}", path.string());
+					return;
+				}
+
+				file.write(reinterpret_cast<char const*>(stream.span().data()), stream.span().size());
+			}
+
+			std::filesystem::rename(temporary, path, ec);
+			if (ec) std::filesystem::remove(temporary, ec);
+		}
+	}
+
+	namespace {
+		struct Stage final {
+			GLenum type;
+			char const* inject;
+			char const* suffix;
+		};
+
+		constexpr std::array kGraphicsStages = {
+			Stage{ GL_VERTEX_SHADER, "#version 460 core\n#define VERT", "vert" },
+			Stage{ GL_FRAGMENT_SHADER, "#version 460 core\n#define FRAG", "frag" },
+		};
+
+		constexpr std::array kComputeStages = {
+			Stage{ GL_COMPUTE_SHADER, "#version 460 core\n#define COMP", "comp" },
+		};
+
+		// Returns an empty vector if any stage fails to preprocess, safe to call from any thread
+		std::vector<std::string> preprocess_stages(char const* file, char const* includePath, std::span<Stage const> stages, std::span<std::string_view const> defines) {
+			std::vector<std::string> sources;
+			sources.reserve(stages.size());
+
+			for (auto const& stage : stages) {
+				std::string inject = stage.inject;
+				for (auto define : defines) {
+					inject += "\n#define ";
+					inject += define;
+				}
+
+				std::unique_ptr source = preprocessShader(file, inject.c_str(), includePath);
+				if (!source) return {};
+				sources.emplace_back(source.get());
+			}
+
+			return sources;
+		}
+
+		// Variants of the same file get distinct labels, eg. `lit.glsl (SKINNING, SHADOWS)`
+		std::string program_label(char const* file, std::span<std::string_view const> defines) {
+			std::string label = file;
+			if (defines.empty()) return label;
+
+			label += " (";
+			for (std::size_t i = 0; i < defines.size(); ++i) {
+				if (i > 0) label += ", ";
+				label += defines[i];
+			}
+			label += ')';
+			return label;
 		}
+
+		// Builds one program in steps, `advance` never waits on the driver unless asked to.
+		// The program binary cache is consulted before anything is compiled.
+		class ProgramBuilder final {
+		public:
+			ProgramBuilder(std::string label, std::span<Stage const> stages, std::vector<std::string> sources, char const* cacheDirectory)
+				: mLabel(std::move(label)), mStages(stages), mSources(std::move(sources)) {
+				assert(mSources.size() == mStages.size());
+
+				if (cacheDirectory && supports_program_binaries()) {
+					std::vector<std::string_view> views(mSources.begin(), mSources.end());
+					mCachePath = program_binary_path(cacheDirectory, views);
+
+					mProgram = load_program_binary(*mCachePath, mIntrospection);
+
+					if (mProgram) {
+						glObjectLabel(GL_PROGRAM, mProgram, -1, mLabel.c_str());
+						VP_LOG_TRACE("Loaded cached shader program: {}", mProgram);
+						mState = State::kDone;
+						return;
+					}
+				}
+
+				mShaders.reserve(mStages.size());
+
+				for (std::size_t i = 0; i < mStages.size(); ++i) {
+					std::string stageLabel = std::format("{} [{}]", mLabel, mStages[i].suffix);
+
+					mShaders.emplace_back(Shader::CreateInfo{
+						.type = mStages[i].type,
+						.source = mSources[i],
+						.label = stageLabel
+					});
+				}
+			}
+
+			// Returns true once the program is finished, successfully or not
+			bool advance(bool wait) {
+				switch (mState) {
+				case State::kCompiling:
+					for (auto const& shader : mShaders)
+						if (!wait && !shader.complete()) return false;
+
+					for (std::size_t i = 0; i < mShaders.size(); ++i) {
+						if (!mShaders[i].check(std::format("{} [{}]", mLabel, mStages[i].suffix))) {
+							mState = State::kDone;
+							return true;
+						}
+					}
+
+					mProgram = glCreateProgram();
+					if (mCachePath) glProgramParameteri(mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+					for (auto const& shader : mShaders) glAttachShader(mProgram, shader.handle());
+					glLinkProgram(mProgram);
+
+					mState = State::kLinking;
+					[[fallthrough]];
+				case State::kLinking:
+					if (!wait && !completed(mProgram, true)) return false;
+
+					finish_link();
+					mState = State::kDone;
+					[[fallthrough]];
+				case State::kDone:
+					return true;
+				}
+
+				return true;
+			}
+
+			// Only valid once `advance` has returned true, the handle is 0 on failure
+			GLuint take(Introspection& introspection) {
+				assert(mState == State::kDone);
+				introspection = std::move(mIntrospection);
+				return std::exchange(mProgram, 0);
+			}
+
+			ProgramBuilder(ProgramBuilder const&) = delete;
+			ProgramBuilder& operator=(ProgramBuilder const&) = delete;
+
+			~ProgramBuilder() noexcept {
+				if (mProgram) glDeleteProgram(mProgram);
+			}
+		private:
+			void finish_link() {
+				for (auto const& shader : mShaders) glDetachShader(mProgram, shader.handle());
+				mShaders.clear();
+
+				GLint infoLogLength;
+				glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+				GLint linkStatus;
+				glGetProgramiv(mProgram, GL_LINK_STATUS, &linkStatus);
+
+				if (infoLogLength > 0) {
+					std::string infoLog;
+					infoLog.resize(infoLogLength);
+					glGetProgramInfoLog(mProgram, infoLogLength, nullptr, infoLog.data());
+
+					if (linkStatus)
+						VP_LOG_INFO("Program info log in {}: {}", mLabel, infoLog);
+					else
+						VP_LOG_ERROR("Program link error in {}: {}", mLabel, infoLog);
+				}
+
+				glObjectLabel(GL_PROGRAM, mProgram, -1, mLabel.c_str());
+
+				if (!linkStatus) {
+					glDeleteProgram(mProgram);
+					mProgram = 0;
+					return;
+				}
+
+				VP_LOG_TRACE("Created shader program: {}", mProgram);
+
+				mIntrospection = introspect(mProgram);
+
+				if (mCachePath) store_program_binary(*mCachePath, mProgram, mIntrospection);
+			}
+
+			enum class State {
+				kCompiling,
+				kLinking,
+				kDone
+			};
+
+			std::string mLabel;
+			std::span<Stage const> mStages;
+			std::vector<std::string> mSources;
+			std::optional<std::filesystem::path> mCachePath;
+			std::vector<Shader> mShaders;
+			GLuint mProgram = 0;
+			Introspection mIntrospection;
+			State mState = State::kCompiling;
+		};
+	}
+
+	ShaderProgram::ShaderProgram(CreateInfo const& info) {
+		assert(info.file != nullptr);
+
+		std::vector<std::string> sources = preprocess_stages(info.file, info.includePath, kGraphicsStages, info.defines);
+		if (sources.empty()) return;
+
+		ProgramBuilder builder(program_label(info.file, info.defines), kGraphicsStages, std::move(sources), info.cacheDirectory);
+		builder.advance(true);
+
+		Introspection introspection;
+		mHandle = builder.take(introspection);
+		mActiveUniforms = std::move(introspection.uniforms);
+		mUniformBlocks = std::move(introspection.uniformBlocks);
+		mStorageBlocks = std::move(introspection.storageBlocks);
+		index_uniforms();
+	}
+
+	ShaderProgram::ShaderProgram(SourceInfo const& info) {
+		assert(!info.vertex.empty());
+		assert(!info.fragment.empty());
+
+		std::vector<std::string> sources = { std::string(info.vertex), std::string(info.fragment) };
+
+		ProgramBuilder builder(info.label ? info.label : "", kGraphicsStages, std::move(sources), info.cacheDirectory);
+		builder.advance(true);
+
+		Introspection introspection;
+		mHandle = builder.take(introspection);
+		mActiveUniforms = std::move(introspection.uniforms);
+		mUniformBlocks = std::move(introspection.uniformBlocks);
+		mStorageBlocks = std::move(introspection.storageBlocks);
+		index_uniforms();
+	}
+
+	ShaderProgram::ShaderProgram(GLuint handle, UnorderedStringMap<int>&& uniforms, UnorderedStringMap<Block>&& uniformBlocks, UnorderedStringMap<Block>&& storageBlocks)
+		: mHandle(handle), mActiveUniforms(std::move(uniforms)), mUniformBlocks(std::move(uniformBlocks)), mStorageBlocks(std::move(storageBlocks)) {
+		index_uniforms();
+	}
+
+	void ShaderProgram::index_uniforms() {
+		mUniformIds.clear();
+		mUniformIds.reserve(mActiveUniforms.size());
+
+		for (auto const& [name, location] : mActiveUniforms)
+			mUniformIds.emplace_back(StringId::from_runtime(name).hash, location);
+
+		std::sort(mUniformIds.begin(), mUniformIds.end());
 	}
 
 	ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept {
 		std::swap(mHandle, other.mHandle);
 		std::swap(mActiveUniforms, other.mActiveUniforms);
+		std::swap(mUniformBlocks, other.mUniformBlocks);
+		std::swap(mStorageBlocks, other.mStorageBlocks);
+		std::swap(mUniformIds, other.mUniformIds);
 		return *this;
 	}
 
 	ShaderProgram::~ShaderProgram() noexcept {
 		if (mHandle) {
 			VP_LOG_TRACE("Destroyed shader program: {}", mHandle);
+			glstate::forget_program(mHandle);
 			glDeleteProgram(mHandle);
 		}
 	}
 
 	void ShaderProgram::bind() const {
-		glUseProgram(mHandle);
+		glstate::use_program(mHandle);
 	}
 
 	GLint ShaderProgram::get_uniform_location(std::string_view name) const {
@@ -566,6 +1125,40 @@ namespace vulpengine::experimental {
 		return it->second;
 	}
 
+	ShaderProgram::Block const* ShaderProgram::get_uniform_block(std::string_view name) const {
+		auto it = mUniformBlocks.find(name);
+		if (it == mUniformBlocks.end()) return nullptr;
+		return &it->second;
+	}
+
+	ShaderProgram::Block const* ShaderProgram::get_storage_block(std::string_view name) const {
+		auto it = mStorageBlocks.find(name);
+		if (it == mStorageBlocks.end()) return nullptr;
+		return &it->second;
+	}
+
+	GLint ShaderProgram::get_uniform_location(StringId id) const {
+		auto it = std::lower_bound(mUniformIds.begin(), mUniformIds.end(), id.hash, [](auto const& entry, std::uint64_t hash) { return entry.first < hash; });
+		if (it == mUniformIds.end() || it->first != id.hash) return -1;
+		return it->second;
+	}
+
+	void ShaderProgram::push(Uniform<int> uniform, int v0) const {
+		glProgramUniform1i(mHandle, uniform.location, v0);
+	}
+
+	void ShaderProgram::push(Uniform<int> uniform, std::span<int const> v0) const {
+		glProgramUniform1iv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), v0.data());
+	}
+
+	void ShaderProgram::push(Uniform<float> uniform, float v0) const {
+		glProgramUniform1f(mHandle, uniform.location, v0);
+	}
+
+	void ShaderProgram::push(Uniform<float> uniform, std::span<float const> v0) const {
+		glProgramUniform1fv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), v0.data());
+	}
+
 	void ShaderProgram::push_1i(std::string_view name, int const* v0, int count) const {
 		glProgramUniform1iv(mHandle, get_uniform_location(name), count, v0);
 	}
@@ -642,6 +1235,316 @@ namespace vulpengine::experimental {
 	void ShaderProgram::push_3f(std::string_view name, glm::vec3 const& v0) const { push_3f(name, glm::value_ptr(v0)); }
 	void ShaderProgram::push_4f(std::string_view name, glm::vec4 const& v0) const { push_4f(name, glm::value_ptr(v0)); }
 	void ShaderProgram::push_mat4f(std::string_view name, glm::mat4 const& v0) const { push_mat4f(name, glm::value_ptr(v0)); }
+
+	void ShaderProgram::push(Uniform<glm::ivec2> uniform, glm::ivec2 const& v0) const { glProgramUniform2iv(mHandle, uniform.location, 1, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::ivec2> uniform, std::span<glm::ivec2 const> v0) const { glProgramUniform2iv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), reinterpret_cast<int const*>(v0.data())); }
+	void ShaderProgram::push(Uniform<glm::ivec3> uniform, glm::ivec3 const& v0) const { glProgramUniform3iv(mHandle, uniform.location, 1, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::ivec3> uniform, std::span<glm::ivec3 const> v0) const { glProgramUniform3iv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), reinterpret_cast<int const*>(v0.data())); }
+	void ShaderProgram::push(Uniform<glm::ivec4> uniform, glm::ivec4 const& v0) const { glProgramUniform4iv(mHandle, uniform.location, 1, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::ivec4> uniform, std::span<glm::ivec4 const> v0) const { glProgramUniform4iv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), reinterpret_cast<int const*>(v0.data())); }
+	void ShaderProgram::push(Uniform<glm::vec2> uniform, glm::vec2 const& v0) const { glProgramUniform2fv(mHandle, uniform.location, 1, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::vec2> uniform, std::span<glm::vec2 const> v0) const { glProgramUniform2fv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), reinterpret_cast<float const*>(v0.data())); }
+	void ShaderProgram::push(Uniform<glm::vec3> uniform, glm::vec3 const& v0) const { glProgramUniform3fv(mHandle, uniform.location, 1, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::vec3> uniform, std::span<glm::vec3 const> v0) const { glProgramUniform3fv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), reinterpret_cast<float const*>(v0.data())); }
+	void ShaderProgram::push(Uniform<glm::vec4> uniform, glm::vec4 const& v0) const { glProgramUniform4fv(mHandle, uniform.location, 1, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::vec4> uniform, std::span<glm::vec4 const> v0) const { glProgramUniform4fv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), reinterpret_cast<float const*>(v0.data())); }
+	void ShaderProgram::push(Uniform<glm::mat4> uniform, glm::mat4 const& v0) const { glProgramUniformMatrix4fv(mHandle, uniform.location, 1, GL_FALSE, glm::value_ptr(v0)); }
+	void ShaderProgram::push(Uniform<glm::mat4> uniform, std::span<glm::mat4 const> v0) const { glProgramUniformMatrix4fv(mHandle, uniform.location, static_cast<GLsizei>(v0.size()), GL_FALSE, reinterpret_cast<float const*>(v0.data())); }
 #endif
 }
+
+// Compute Program
+namespace vulpengine::experimental {
+	ComputeProgram::ComputeProgram(CreateInfo const& info) {
+		assert(info.file != nullptr);
+
+		std::vector<std::string> sources = preprocess_stages(info.file, info.includePath, kComputeStages, info.defines);
+		if (sources.empty()) return;
+
+		ProgramBuilder builder(program_label(info.file, info.defines), kComputeStages, std::move(sources), info.cacheDirectory);
+		builder.advance(true);
+
+		Introspection introspection;
+		GLuint handle = builder.take(introspection);
+		if (!handle) return;
+
+		mProgram = ShaderProgram(handle, std::move(introspection.uniforms), std::move(introspection.uniformBlocks), std::move(introspection.storageBlocks));
+		glGetProgramiv(handle, GL_COMPUTE_WORK_GROUP_SIZE, mWorkGroupSize.data());
+	}
+
+	void ComputeProgram::dispatch(GLuint x, GLuint y, GLuint z) const {
+		assert(valid());
+		mProgram.bind();
+		glDispatchCompute(x, y, z);
+	}
+
+	void ComputeProgram::dispatch_threads(GLuint x, GLuint y, GLuint z) const {
+		assert(valid());
+		assert(mWorkGroupSize[0] > 0 && mWorkGroupSize[1] > 0 && mWorkGroupSize[2] > 0);
+
+		auto groups = [](GLuint count, GLint size) { return (count + static_cast<GLuint>(size) - 1) / static_cast<GLuint>(size); };
+		dispatch(groups(x, mWorkGroupSize[0]), groups(y, mWorkGroupSize[1]), groups(z, mWorkGroupSize[2]));
+	}
+
+	void ComputeProgram::dispatch_indirect(Buffer const& buffer, GLintptr offset) const {
+		assert(valid());
+		assert(buffer.valid());
+		mProgram.bind();
+		glstate::bind_buffer(GL_DISPATCH_INDIRECT_BUFFER, buffer.handle());
+		glDispatchComputeIndirect(offset);
+	}
+}
+
+// Shader Compiler
+namespace vulpengine::experimental {
+	struct ShaderCompiler::Job final {
+		std::string file;
+		std::string label;
+		std::string includePath;
+		std::optional<std::string> cacheDirectory;
+
+		std::future<std::vector<std::string>> sources;
+		std::optional<ProgramBuilder> builder;
+		std::optional<ShaderProgram> program;
+	};
+
+	ShaderCompiler::ShaderCompiler() {
+		// Let the driver pick how many threads it uses
+#if defined(GL_KHR_parallel_shader_compile)
+		if (GLAD_GL_KHR_parallel_shader_compile) {
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+			return;
+		}
+#endif
+#if defined(GL_ARB_parallel_shader_compile)
+		if (GLAD_GL_ARB_parallel_shader_compile) {
+			glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+			return;
+		}
+#endif
+	}
+
+	ShaderCompiler::ShaderCompiler(ShaderCompiler&&) noexcept = default;
+	ShaderCompiler& ShaderCompiler::operator=(ShaderCompiler&&) noexcept = default;
+	ShaderCompiler::~ShaderCompiler() noexcept = default;
+
+	ShaderCompiler::Ticket ShaderCompiler::submit(ShaderProgram::CreateInfo const& info) {
+		assert(info.file != nullptr);
+
+		std::unique_ptr<Job> job = std::make_unique<Job>();
+		job->file = info.file;
+		job->label = program_label(info.file, info.defines);
+		job->includePath = info.includePath;
+		if (info.cacheDirectory) job->cacheDirectory = info.cacheDirectory;
+
+		std::vector<std::string> defines(info.defines.begin(), info.defines.end());
+
+		std::promise<std::vector<std::string>> sources;
+		job->sources = sources.get_future();
+
+		jobs::run([file = job->file, includePath = job->includePath, defines = std::move(defines), sources = std::move(sources)]() mutable {
+			std::vector<std::string_view> views(defines.begin(), defines.end());
+			sources.set_value(preprocess_stages(file.c_str(), includePath.c_str(), kGraphicsStages, views));
+		}, "preprocess shader");
+
+		return add(std::move(job));
+	}
+
+	ShaderCompiler::Ticket ShaderCompiler::submit(ShaderProgram::SourceInfo const& info) {
+		assert(!info.vertex.empty());
+		assert(!info.fragment.empty());
+
+		std::unique_ptr<Job> job = std::make_unique<Job>();
+		if (info.label) job->label = info.label;
+		if (info.cacheDirectory) job->cacheDirectory = info.cacheDirectory;
+
+		// Already preprocessed, hand the sources over through a ready future
+		std::promise<std::vector<std::string>> sources;
+		sources.set_value({ std::string(info.vertex), std::string(info.fragment) });
+		job->sources = sources.get_future();
+
+		return add(std::move(job));
+	}
+
+	ShaderCompiler::Ticket ShaderCompiler::add(std::unique_ptr<Job> job) {
+		++mPending;
+
+		if (mFreeSlots.empty()) {
+			mSlots.push_back({ .job = std::move(job) });
+			return { static_cast<std::uint32_t>(mSlots.size() - 1), mSlots.back().generation };
+		}
+
+		std::uint32_t const index = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		mSlots[index].job = std::move(job);
+		return { index, mSlots[index].generation };
+	}
+
+	bool ShaderCompiler::advance(Job& job, bool wait) {
+		if (job.program) return true;
+
+		if (!job.builder) {
+			// Waiting helps with queued jobs, the preprocess job may be one of them
+			while (job.sources.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				if (!wait) return false;
+				if (!jobs::run_one()) std::this_thread::yield();
+			}
+
+			std::vector<std::string> sources = job.sources.get();
+
+			if (sources.empty()) {
+				job.program.emplace();
+				return true;
+			}
+
+			job.builder.emplace(job.label, kGraphicsStages, std::move(sources), job.cacheDirectory ? job.cacheDirectory->c_str() : nullptr);
+		}
+
+		if (!job.builder->advance(wait)) return false;
+
+		Introspection introspection;
+		GLuint handle = job.builder->take(introspection);
+		job.program.emplace(ShaderProgram(handle, std::move(introspection.uniforms), std::move(introspection.uniformBlocks), std::move(introspection.storageBlocks)));
+		job.builder.reset();
+		return true;
+	}
+
+	bool ShaderCompiler::poll() {
+		VP_PROFILE_CPU;
+
+		// Issue every compile that's ready before checking any of them,
+		// this keeps as many shaders in flight in the driver as possible
+		for (Slot& slot : mSlots) {
+			if (!slot.job || slot.job->program) continue;
+			if (advance(*slot.job, false)) --mPending;
+		}
+
+		return mPending == 0;
+	}
+
+	void ShaderCompiler::wait() {
+		VP_PROFILE_CPU;
+
+		poll();
+
+		for (Slot& slot : mSlots) {
+			if (!slot.job || slot.job->program) continue;
+			advance(*slot.job, true);
+			--mPending;
+		}
+	}
+
+	bool ShaderCompiler::ready(Ticket ticket) const {
+		assert(ticket.index < mSlots.size());
+		assert(mSlots[ticket.index].generation == ticket.generation && "Ticket was already taken");
+		Slot const& slot = mSlots[ticket.index];
+		return slot.job && slot.job->program;
+	}
+
+	ShaderProgram ShaderCompiler::take(Ticket ticket) {
+		assert(ready(ticket));
+		Slot& slot = mSlots[ticket.index];
+		ShaderProgram program = std::move(*slot.job->program);
+		slot.job = nullptr;
+		if (++slot.generation == 0) slot.generation = 1;
+		mFreeSlots.push_back(ticket.index);
+		return program;
+	}
+}
+
+// Block Writer
+namespace vulpengine::experimental {
+	namespace {
+		// Bytes one element of the member covers, matrices are vectors `matrixStride` apart.
+		// The layout doesn't say which way a matrix is stored, the longer side is taken.
+		std::size_t block_member_size(ShaderProgram::BlockMember const& member) {
+			auto matrix = [&](std::size_t columns, std::size_t rows) { return std::max(columns, rows) * static_cast<std::size_t>(member.matrixStride); };
+
+			switch (member.type) {
+			case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL:
+				return 4;
+			case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: case GL_DOUBLE:
+				return 8;
+			case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+				return 12;
+			case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: case GL_DOUBLE_VEC2:
+				return 16;
+			case GL_DOUBLE_VEC3:
+				return 24;
+			case GL_DOUBLE_VEC4:
+				return 32;
+			case GL_FLOAT_MAT2: case GL_DOUBLE_MAT2: return matrix(2, 2);
+			case GL_FLOAT_MAT3: case GL_DOUBLE_MAT3: return matrix(3, 3);
+			case GL_FLOAT_MAT4: case GL_DOUBLE_MAT4: return matrix(4, 4);
+			case GL_FLOAT_MAT2x3: case GL_DOUBLE_MAT2x3: return matrix(2, 3);
+			case GL_FLOAT_MAT2x4: case GL_DOUBLE_MAT2x4: return matrix(2, 4);
+			case GL_FLOAT_MAT3x2: case GL_DOUBLE_MAT3x2: return matrix(3, 2);
+			case GL_FLOAT_MAT3x4: case GL_DOUBLE_MAT3x4: return matrix(3, 4);
+			case GL_FLOAT_MAT4x2: case GL_DOUBLE_MAT4x2: return matrix(4, 2);
+			case GL_FLOAT_MAT4x3: case GL_DOUBLE_MAT4x3: return matrix(4, 3);
+			default:
+				return std::numeric_limits<std::size_t>::max(); // Unknown, left unchecked
+			}
+		}
+	}
+
+	BlockWriter::BlockWriter(CreateInfo const& info)
+		: mData(info.block.size), mMembers(info.block.members), mBinding(static_cast<GLuint>(info.block.binding)) {
+		assert(info.block.size > 0);
+
+		mBuffer = { {
+			.content = mData,
+			.flags = GL_DYNAMIC_STORAGE_BIT,
+			.label = info.label
+		} };
+	}
+
+	bool BlockWriter::set(std::string_view member, void const* data, std::size_t size, GLint index) {
+		auto it = mMembers.find(member);
+		if (it == mMembers.end()) return false;
+
+		auto const& layout = it->second;
+		assert(index >= 0 && (layout.arraySize == 0 || index < layout.arraySize)); // Unsized arrays report 0
+		assert(size <= block_member_size(layout) && "Value is larger than the member");
+
+		write(layout.offset + static_cast<GLintptr>(index) * layout.arrayStride, data, size);
+		return true;
+	}
+
+	void BlockWriter::write(GLintptr offset, void const* data, std::size_t size) {
+		assert(offset >= 0 && static_cast<std::size_t>(offset) + size <= mData.size() && "Write past the end of the block");
+
+		// Unchanged writes don't grow the upload
+		if (memcmp(mData.data() + offset, data, size) == 0) return;
+		memcpy(mData.data() + offset, data, size);
+
+		std::size_t const begin = static_cast<std::size_t>(offset);
+		std::size_t const end = begin + size;
+
+		if (dirty()) {
+			mDirtyBegin = std::min(mDirtyBegin, begin);
+			mDirtyEnd = std::max(mDirtyEnd, end);
+		}
+		else {
+			mDirtyBegin = begin;
+			mDirtyEnd = end;
+		}
+	}
+
+	void BlockWriter::flush() {
+		if (!dirty()) return;
+
+		mBuffer.upload(mDirtyBegin, std::span(mData).subspan(mDirtyBegin, mDirtyEnd - mDirtyBegin));
+		mDirtyBegin = 0;
+		mDirtyEnd = 0;
+	}
+
+	void BlockWriter::bind(GLenum target) const {
+		bind(target, mBinding);
+	}
+
+	void BlockWriter::bind(GLenum target, GLuint index) const {
+		mBuffer.bind_base(target, index);
+	}
+}
 #endif // VP_HAS_SHADER_PROGRAM
\ No newline at end of file
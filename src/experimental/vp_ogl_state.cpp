@@ -0,0 +1,278 @@
+#include "vulpengine/experimental/vp_ogl_state.hpp"
+
+#include <array>
+#include <algorithm>
+
+namespace vulpengine::experimental::glstate {
+	namespace {
+		// Never a valid name or enum, the next call always goes through
+		constexpr GLuint kUnknown = 0xFFFFFFFF;
+
+		// Bindings past these are passed through untracked
+		constexpr std::size_t kMaxTextureUnits = 32;
+		constexpr std::size_t kMaxBufferIndices = 16;
+
+		constexpr std::array kTrackedCapabilities = {
+			GLenum(GL_BLEND),
+			GLenum(GL_DEPTH_TEST),
+			GLenum(GL_CULL_FACE),
+			GLenum(GL_SCISSOR_TEST),
+			GLenum(GL_STENCIL_TEST),
+			GLenum(GL_FRAMEBUFFER_SRGB),
+			GLenum(GL_POLYGON_OFFSET_FILL),
+			GLenum(GL_PROGRAM_POINT_SIZE),
+			GLenum(GL_RASTERIZER_DISCARD),
+			GLenum(GL_TEXTURE_CUBE_MAP_SEAMLESS),
+		};
+
+		// GL_ELEMENT_ARRAY_BUFFER is vertex array state and passed through
+		constexpr std::array kTrackedBufferTargets = {
+			GLenum(GL_ARRAY_BUFFER),
+			GLenum(GL_UNIFORM_BUFFER),
+			GLenum(GL_SHADER_STORAGE_BUFFER),
+			GLenum(GL_DRAW_INDIRECT_BUFFER),
+			GLenum(GL_DISPATCH_INDIRECT_BUFFER),
+			GLenum(GL_PIXEL_PACK_BUFFER),
+			GLenum(GL_PIXEL_UNPACK_BUFFER),
+			GLenum(GL_COPY_READ_BUFFER),
+			GLenum(GL_COPY_WRITE_BUFFER),
+		};
+
+		// Only the indexed targets vulpengine binds, others are passed through
+		constexpr std::array kTrackedIndexedTargets = {
+			GLenum(GL_UNIFORM_BUFFER),
+			GLenum(GL_SHADER_STORAGE_BUFFER),
+		};
+
+		struct IndexedBinding final {
+			GLuint buffer = kUnknown;
+			GLintptr offset = 0;
+			GLsizeiptr size = 0; // 0 for the whole buffer
+
+			bool operator==(IndexedBinding const&) const = default;
+		};
+
+		template<std::size_t N>
+		constexpr std::array<GLuint, N> unknown_array() {
+			std::array<GLuint, N> array;
+			array.fill(kUnknown);
+			return array;
+		}
+
+		struct State final {
+			GLuint program = kUnknown;
+			GLuint vertexArray = kUnknown;
+			GLuint drawFramebuffer = kUnknown;
+			GLuint readFramebuffer = kUnknown;
+
+			std::array<GLuint, kMaxTextureUnits> textures = unknown_array<kMaxTextureUnits>();
+			std::array<GLuint, kTrackedBufferTargets.size()> buffers = unknown_array<kTrackedBufferTargets.size()>();
+			std::array<std::array<IndexedBinding, kMaxBufferIndices>, kTrackedIndexedTargets.size()> indexedBuffers;
+
+			// 0 or 1 when known
+			std::array<GLuint, kTrackedCapabilities.size()> capabilities = unknown_array<kTrackedCapabilities.size()>();
+
+			GLenum blendSource = kUnknown;
+			GLenum blendDestination = kUnknown;
+			GLenum blendEquation = kUnknown;
+			GLenum depthFunc = kUnknown;
+			GLuint depthMask = kUnknown;
+			GLenum cullFace = kUnknown;
+
+			Stats stats;
+		};
+
+		thread_local State gState;
+
+		template<class T, std::size_t N>
+		std::size_t index_of(std::array<T, N> const& array, T value) {
+			return std::find(array.begin(), array.end(), value) - array.begin();
+		}
+
+		// Returns true if the call should be issued, and updates `cached`
+		template<class T>
+		bool update(T& cached, T value) {
+			if (cached == value) {
+				++gState.stats.elided;
+				return false;
+			}
+
+			cached = value;
+			++gState.stats.issued;
+			return true;
+		}
+
+		void passthrough() {
+			++gState.stats.issued;
+		}
+
+		GLuint* generic_buffer(GLenum target) {
+			std::size_t const index = index_of(kTrackedBufferTargets, target);
+			return index < kTrackedBufferTargets.size() ? &gState.buffers[index] : nullptr;
+		}
+
+		IndexedBinding* indexed_buffer(GLenum target, GLuint index) {
+			std::size_t const targetIndex = index_of(kTrackedIndexedTargets, target);
+			if (targetIndex >= kTrackedIndexedTargets.size() || index >= kMaxBufferIndices) return nullptr;
+			return &gState.indexedBuffers[targetIndex][index];
+		}
+
+		void bind_indexed(GLenum target, GLuint index, IndexedBinding const& binding) {
+			// Indexed binds also change the generic binding point
+			if (GLuint* generic = generic_buffer(target)) *generic = binding.buffer;
+
+			IndexedBinding* cached = indexed_buffer(target, index);
+			if (!cached) {
+				passthrough();
+			} else if (!update(*cached, binding)) {
+				return;
+			}
+
+			if (binding.size == 0) glBindBufferBase(target, index, binding.buffer);
+			else glBindBufferRange(target, index, binding.buffer, binding.offset, binding.size);
+		}
+	}
+
+	void use_program(GLuint program) {
+		if (update(gState.program, program)) glUseProgram(program);
+	}
+
+	void bind_vertex_array(GLuint vertexArray) {
+		if (update(gState.vertexArray, vertexArray)) glBindVertexArray(vertexArray);
+	}
+
+	void bind_framebuffer(GLenum target, GLuint framebuffer) {
+		switch (target) {
+			case GL_FRAMEBUFFER:
+				if (gState.drawFramebuffer == framebuffer && gState.readFramebuffer == framebuffer) {
+					++gState.stats.elided;
+					return;
+				}
+				gState.drawFramebuffer = framebuffer;
+				gState.readFramebuffer = framebuffer;
+				passthrough();
+				break;
+			case GL_DRAW_FRAMEBUFFER:
+				if (!update(gState.drawFramebuffer, framebuffer)) return;
+				break;
+			case GL_READ_FRAMEBUFFER:
+				if (!update(gState.readFramebuffer, framebuffer)) return;
+				break;
+			default:
+				passthrough();
+		}
+
+		glBindFramebuffer(target, framebuffer);
+	}
+
+	void bind_texture_unit(GLuint unit, GLuint texture) {
+		if (unit < kMaxTextureUnits) {
+			if (!update(gState.textures[unit], texture)) return;
+		} else {
+			passthrough();
+		}
+
+		glBindTextureUnit(unit, texture);
+	}
+
+	void bind_buffer(GLenum target, GLuint buffer) {
+		if (GLuint* cached = generic_buffer(target)) {
+			if (!update(*cached, buffer)) return;
+		} else {
+			passthrough();
+		}
+
+		glBindBuffer(target, buffer);
+	}
+
+	void bind_buffer_base(GLenum target, GLuint index, GLuint buffer) {
+		bind_indexed(target, index, { buffer, 0, 0 });
+	}
+
+	void bind_buffer_range(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+		bind_indexed(target, index, { buffer, offset, size });
+	}
+
+	void set_enabled(GLenum capability, bool enabled) {
+		std::size_t const index = index_of(kTrackedCapabilities, capability);
+
+		if (index < kTrackedCapabilities.size()) {
+			if (!update(gState.capabilities[index], GLuint(enabled))) return;
+		} else {
+			passthrough();
+		}
+
+		if (enabled) glEnable(capability);
+		else glDisable(capability);
+	}
+
+	void blend_func(GLenum source, GLenum destination) {
+		if (gState.blendSource == source && gState.blendDestination == destination) {
+			++gState.stats.elided;
+			return;
+		}
+
+		gState.blendSource = source;
+		gState.blendDestination = destination;
+		passthrough();
+		glBlendFunc(source, destination);
+	}
+
+	void blend_equation(GLenum mode) {
+		if (update(gState.blendEquation, mode)) glBlendEquation(mode);
+	}
+
+	void depth_func(GLenum func) {
+		if (update(gState.depthFunc, func)) glDepthFunc(func);
+	}
+
+	void depth_mask(bool enabled) {
+		if (update(gState.depthMask, GLuint(enabled))) glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+
+	void cull_face(GLenum mode) {
+		if (update(gState.cullFace, mode)) glCullFace(mode);
+	}
+
+	// A deleted program stays in use until another is bound, but its name can be reused before that
+	void forget_program(GLuint program) {
+		if (gState.program == program) gState.program = kUnknown;
+	}
+
+	void forget_vertex_array(GLuint vertexArray) {
+		if (gState.vertexArray == vertexArray) gState.vertexArray = kUnknown;
+	}
+
+	void forget_framebuffer(GLuint framebuffer) {
+		if (gState.drawFramebuffer == framebuffer) gState.drawFramebuffer = kUnknown;
+		if (gState.readFramebuffer == framebuffer) gState.readFramebuffer = kUnknown;
+	}
+
+	void forget_texture(GLuint texture) {
+		std::replace(gState.textures.begin(), gState.textures.end(), texture, kUnknown);
+	}
+
+	void forget_buffer(GLuint buffer) {
+		std::replace(gState.buffers.begin(), gState.buffers.end(), buffer, kUnknown);
+
+		for (auto& indices : gState.indexedBuffers) {
+			for (auto& binding : indices) {
+				if (binding.buffer == buffer) binding = {};
+			}
+		}
+	}
+
+	void invalidate() {
+		Stats const stats = gState.stats;
+		gState = {};
+		gState.stats = stats;
+	}
+
+	Stats stats() {
+		return gState.stats;
+	}
+
+	void reset_stats() {
+		gState.stats = {};
+	}
+}
@@ -0,0 +1,339 @@
+#include "vulpengine/experimental/vp_render_graph.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+#include "vulpengine/experimental/vp_ogl_state.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr std::uint32_t kNoPass = 0xFFFFFFFF;
+	}
+
+	// Builder
+	RenderGraph::Resource RenderGraph::Builder::create(ResourceInfo const& info, std::string_view label) {
+		assert(info.width > 0);
+		assert(info.height > 0);
+		assert(info.internalFormat != GL_NONE);
+
+		auto& resource = mGraph.mResources.emplace_back();
+		resource.label = label;
+		resource.info = info;
+		return static_cast<Resource>(mGraph.mResources.size() - 1);
+	}
+
+	RenderGraph::Resource RenderGraph::Builder::read(Resource resource) {
+		assert(resource < mGraph.mResources.size());
+
+		auto& virtualResource = mGraph.mResources[resource];
+		assert(!virtualResource.info.renderbuffer && "Renderbuffers can't be read");
+
+		Pass& pass = mGraph.mPasses[mPass];
+		pass.reads.push_back(resource);
+		if (virtualResource.lastWriter != kNoPass) pass.dependencies.push_back(virtualResource.lastWriter);
+
+		return resource;
+	}
+
+	RenderGraph::Resource RenderGraph::Builder::write(Resource resource, GLenum attachment) {
+		assert(resource < mGraph.mResources.size());
+
+		auto& virtualResource = mGraph.mResources[resource];
+		assert(attachment != GL_NONE || !virtualResource.info.renderbuffer);
+
+		// Writes keep previous contents, so they depend on the previous writer too
+		Pass& pass = mGraph.mPasses[mPass];
+		pass.writes.emplace_back(resource, attachment);
+		if (virtualResource.lastWriter != kNoPass && virtualResource.lastWriter != mPass) pass.dependencies.push_back(virtualResource.lastWriter);
+		virtualResource.lastWriter = mPass;
+
+		return resource;
+	}
+
+	void RenderGraph::Builder::side_effect() {
+		mGraph.mPasses[mPass].sideEffect = true;
+	}
+
+	// Context
+	Texture const& RenderGraph::Context::texture(Resource resource) const {
+		auto const& virtualResource = mGraph.mResources[resource];
+		if (virtualResource.texture) return *virtualResource.texture;
+
+		assert(virtualResource.pooled != nullptr && "Resource isn't used by this pass");
+		return std::get<Texture>(virtualResource.pooled->object);
+	}
+
+	Renderbuffer const& RenderGraph::Context::renderbuffer(Resource resource) const {
+		auto const& virtualResource = mGraph.mResources[resource];
+		if (virtualResource.renderbuffer) return *virtualResource.renderbuffer;
+
+		assert(virtualResource.pooled != nullptr && "Resource isn't used by this pass");
+		return std::get<Renderbuffer>(virtualResource.pooled->object);
+	}
+
+	GLuint RenderGraph::PooledResource::handle() const {
+		return std::visit([](auto const& value) { return value.handle(); }, object);
+	}
+
+	RenderGraph::Resource RenderGraph::import(Texture& texture, std::string_view label) {
+		auto& resource = mResources.emplace_back();
+		resource.label = label;
+		resource.texture = &texture;
+		resource.imported = true;
+		resource.info.internalFormat = texture.internal_format();
+		glGetTextureLevelParameteriv(texture.handle(), 0, GL_TEXTURE_WIDTH, &resource.info.width);
+		glGetTextureLevelParameteriv(texture.handle(), 0, GL_TEXTURE_HEIGHT, &resource.info.height);
+		return static_cast<Resource>(mResources.size() - 1);
+	}
+
+	RenderGraph::Resource RenderGraph::import(Renderbuffer& renderbuffer, std::string_view label) {
+		auto& resource = mResources.emplace_back();
+		resource.label = label;
+		resource.renderbuffer = &renderbuffer;
+		resource.imported = true;
+		resource.info.renderbuffer = true;
+		glGetNamedRenderbufferParameteriv(renderbuffer.handle(), GL_RENDERBUFFER_WIDTH, &resource.info.width);
+		glGetNamedRenderbufferParameteriv(renderbuffer.handle(), GL_RENDERBUFFER_HEIGHT, &resource.info.height);
+		return static_cast<Resource>(mResources.size() - 1);
+	}
+
+	RenderGraph::Resource RenderGraph::import_default_framebuffer(GLsizei width, GLsizei height) {
+		auto& resource = mResources.emplace_back();
+		resource.label = "Default Framebuffer";
+		resource.imported = true;
+		resource.defaultFramebuffer = true;
+		resource.info.width = width;
+		resource.info.height = height;
+		resource.info.renderbuffer = true;
+		return static_cast<Resource>(mResources.size() - 1);
+	}
+
+	void RenderGraph::add_pass(std::string_view name, SetupCallback const& setup, ExecuteCallback execute) {
+		auto& pass = mPasses.emplace_back();
+		pass.name = name;
+		pass.execute = std::move(execute);
+
+		Builder builder(*this, static_cast<std::uint32_t>(mPasses.size() - 1));
+		setup(builder);
+	}
+
+	// Dependencies always point to earlier passes, one backwards sweep marks everything needed
+	void RenderGraph::cull() {
+		for (auto& pass : mPasses) {
+			pass.alive = pass.sideEffect || std::any_of(pass.writes.begin(), pass.writes.end(), [this](auto const& write) {
+				return mResources[write.first].imported;
+			});
+		}
+
+		for (std::size_t i = mPasses.size(); i-- > 0;) {
+			if (!mPasses[i].alive) continue;
+			for (std::uint32_t dependency : mPasses[i].dependencies) mPasses[dependency].alive = true;
+		}
+	}
+
+	RenderGraph::PooledResource& RenderGraph::acquire(ResourceInfo const& info, std::string_view label) {
+		for (auto& pooled : mPool) {
+			if (pooled->inUse || !(pooled->info == info)) continue;
+
+			pooled->inUse = true;
+			pooled->lastFrame = mFrame;
+			return *pooled;
+		}
+
+		auto& pooled = *mPool.emplace_back(std::make_unique<PooledResource>());
+		pooled.info = info;
+		pooled.inUse = true;
+		pooled.lastFrame = mFrame;
+
+		if (info.renderbuffer) {
+			pooled.object = Renderbuffer({
+				.width = info.width,
+				.height = info.height,
+				.internalFormat = info.internalFormat,
+				.label = label
+			});
+		} else {
+			pooled.object = Texture({
+				.target = GL_TEXTURE_2D,
+				.width = info.width,
+				.height = info.height,
+				.internalFormat = info.internalFormat,
+				.label = label,
+				.levels = info.levels
+			});
+		}
+
+		VP_LOG_TRACE("Render graph allocated transient: {}", label);
+		return pooled;
+	}
+
+	GLuint RenderGraph::bind_attachments(Pass const& pass) {
+		FramebufferKey key;
+		GLsizei width = 0, height = 0;
+		bool defaultFramebuffer = false;
+
+		for (auto const& [resource, attachment] : pass.writes) {
+			if (attachment == GL_NONE) continue;
+
+			auto const& virtualResource = mResources[resource];
+			width = virtualResource.info.width;
+			height = virtualResource.info.height;
+
+			if (virtualResource.defaultFramebuffer) {
+				defaultFramebuffer = true;
+				continue;
+			}
+
+			GLuint const handle = virtualResource.pooled ? virtualResource.pooled->handle()
+				: virtualResource.texture ? virtualResource.texture->handle() : virtualResource.renderbuffer->handle();
+
+			key.emplace_back(attachment, handle, virtualResource.info.renderbuffer);
+		}
+
+		if (defaultFramebuffer) {
+			assert(key.empty() && "The default framebuffer can't be combined with other attachments");
+			glstate::bind_framebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, width, height);
+			return 0;
+		}
+
+		if (key.empty()) return 0;
+
+		std::sort(key.begin(), key.end());
+
+		auto it = mFramebuffers.find(key);
+
+		if (it == mFramebuffers.end()) {
+			std::vector<Framebuffer::Attachment> framebufferAttachments;
+			bool imported = false;
+
+			for (auto const& [resource, attachment] : pass.writes) {
+				if (attachment == GL_NONE) continue;
+
+				auto const& virtualResource = mResources[resource];
+				imported |= virtualResource.imported;
+
+				if (virtualResource.info.renderbuffer) {
+					Renderbuffer& renderbuffer = virtualResource.pooled ? std::get<Renderbuffer>(virtualResource.pooled->object) : *virtualResource.renderbuffer;
+					framebufferAttachments.push_back({ attachment, std::ref(renderbuffer) });
+				} else {
+					Texture& texture = virtualResource.pooled ? std::get<Texture>(virtualResource.pooled->object) : *virtualResource.texture;
+					framebufferAttachments.push_back({ attachment, std::ref(texture) });
+				}
+			}
+
+			it = mFramebuffers.emplace(std::move(key), CachedFramebuffer{
+				.framebuffer = Framebuffer({ .attachments = framebufferAttachments }),
+				.imported = imported
+			}).first;
+		}
+
+		it->second.lastFrame = mFrame;
+		it->second.framebuffer.bind();
+		glViewport(0, 0, width, height);
+
+		return it->second.framebuffer.handle();
+	}
+
+	void RenderGraph::evict() {
+		std::vector<GLuint> evicted;
+
+		std::erase_if(mPool, [&](auto const& pooled) {
+			if (pooled->lastFrame + mPoolLifetime >= mFrame) return false;
+			evicted.push_back(pooled->handle());
+			return true;
+		});
+
+		// Framebuffers attached to deleted objects would see their names reused.
+		// Imports can be deleted by the caller between frames, so theirs never outlive the frame.
+		std::erase_if(mFramebuffers, [&](auto const& entry) {
+			if (entry.second.imported || entry.second.lastFrame + mPoolLifetime < mFrame) return true;
+
+			return std::any_of(entry.first.begin(), entry.first.end(), [&](auto const& attachment) {
+				return std::find(evicted.begin(), evicted.end(), std::get<1>(attachment)) != evicted.end();
+			});
+		});
+	}
+
+	void RenderGraph::execute() {
+		VP_PROFILE_CPU;
+
+		mStats = {};
+		mStats.passes = static_cast<std::uint32_t>(mPasses.size());
+
+		cull();
+
+		// Lifetimes only count passes that run
+		for (std::uint32_t i = 0; i < mPasses.size(); ++i) {
+			Pass const& pass = mPasses[i];
+
+			if (!pass.alive) {
+				++mStats.culledPasses;
+				continue;
+			}
+
+			auto use = [&](Resource resource) {
+				auto& virtualResource = mResources[resource];
+				virtualResource.firstUse = std::min(virtualResource.firstUse, i);
+				virtualResource.lastUse = std::max(virtualResource.lastUse, i);
+			};
+
+			for (Resource resource : pass.reads) use(resource);
+			for (auto const& write : pass.writes) use(write.first);
+		}
+
+		std::vector<GLenum> invalidated;
+
+		for (std::uint32_t i = 0; i < mPasses.size(); ++i) {
+			Pass const& pass = mPasses[i];
+			if (!pass.alive) continue;
+
+			for (auto& resource : mResources) {
+				if (resource.imported || resource.firstUse != i) continue;
+				resource.pooled = &acquire(resource.info, resource.label);
+				++mStats.transientResources;
+			}
+
+			GLuint const framebuffer = bind_attachments(pass);
+
+			pass.execute(Context(*this, framebuffer));
+
+			invalidated.clear();
+
+			// Release transients ending here, they can alias resources acquired by later passes
+			for (Resource resource = 0; resource < mResources.size(); ++resource) {
+				auto& virtualResource = mResources[resource];
+				if (virtualResource.imported || !virtualResource.pooled || virtualResource.lastUse != i) continue;
+
+				auto write = std::find_if(pass.writes.begin(), pass.writes.end(), [&](auto const& write) { return write.first == resource; });
+
+				if (framebuffer && write != pass.writes.end() && write->second != GL_NONE) {
+					invalidated.push_back(write->second);
+				} else if (!virtualResource.info.renderbuffer) {
+					glInvalidateTexImage(virtualResource.pooled->handle(), 0);
+				}
+
+				virtualResource.pooled->inUse = false;
+				virtualResource.pooled = nullptr;
+			}
+
+			if (!invalidated.empty())
+				glInvalidateNamedFramebufferData(framebuffer, static_cast<GLsizei>(invalidated.size()), invalidated.data());
+		}
+
+		mStats.physicalResources = static_cast<std::uint32_t>(std::count_if(mPool.begin(), mPool.end(), [this](auto const& pooled) {
+			return pooled->lastFrame == mFrame;
+		}));
+
+		evict();
+
+		mStats.pooledResources = static_cast<std::uint32_t>(mPool.size());
+		mStats.framebuffers = static_cast<std::uint32_t>(mFramebuffers.size());
+
+		mPasses.clear();
+		mResources.clear();
+		++mFrame;
+	}
+}
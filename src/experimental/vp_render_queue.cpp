@@ -0,0 +1,192 @@
+#include "vulpengine/experimental/vp_render_queue.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+#include "vulpengine/experimental/vp_ogl_state.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr int kDepthBits = 25;
+		constexpr int kMeshBits = 12;
+		constexpr int kMaterialBits = 12;
+		constexpr int kProgramBits = 10;
+
+		// Non-negative floats sort the same as their bit patterns, keep the top bits
+		std::uint64_t quantize_depth(float depth) {
+			depth = std::max(depth, 0.0f);
+
+			std::uint32_t bits;
+			std::memcpy(&bits, &depth, sizeof(bits));
+			return bits >> (32 - kDepthBits);
+		}
+
+		std::uint64_t make_key(std::uint8_t layer, bool translucent, std::uint64_t program, std::uint64_t material, std::uint64_t mesh, float depth) {
+			std::uint64_t const state = (program << (kMaterialBits + kMeshBits)) | (material << kMeshBits) | mesh;
+			std::uint64_t key = (std::uint64_t(layer) << 60) | (std::uint64_t(translucent) << 59);
+
+			if (translucent) {
+				std::uint64_t const backToFront = ((1ull << kDepthBits) - 1) - quantize_depth(depth);
+				key |= (backToFront << (kProgramBits + kMaterialBits + kMeshBits)) | state;
+			} else {
+				key |= (state << kDepthBits) | quantize_depth(depth);
+			}
+
+			return key;
+		}
+
+		// Whether an id is left for the object, known objects already have one
+		template<class T>
+		bool has_id(std::unordered_map<T const*, std::uint16_t> const& ids, T const* object, std::size_t max) {
+			return ids.size() < max || ids.contains(object);
+		}
+
+		template<class T>
+		std::uint16_t intern(std::unordered_map<T const*, std::uint16_t>& ids, std::vector<T const*>& objects, T const* object) {
+			auto [it, inserted] = ids.try_emplace(object, static_cast<std::uint16_t>(objects.size()));
+			if (inserted) objects.push_back(object);
+			return it->second;
+		}
+	}
+
+	RenderQueue::RenderQueue(CreateInfo const& info) : mDrawIdLocation(info.drawIdLocation) {}
+
+	RenderQueue::MaterialHandle RenderQueue::add_material(Material const& material) {
+		assert(mMaterials.size() < kMaxMaterials);
+		mMaterials.push_back(material);
+		return static_cast<MaterialHandle>(mMaterials.size() - 1);
+	}
+
+	void RenderQueue::submit(DrawInfo const& info) {
+		assert(info.mesh.valid());
+		assert(info.program.valid());
+		assert(info.material < mMaterials.size());
+		assert(info.layer <= kMaxLayer);
+
+		// Ids past the key's bits would overwrite its other fields
+		if (!has_id(mProgramIds, &info.program, kMaxPrograms) || !has_id(mMeshIds, &info.mesh, kMaxMeshes)) {
+			++mDropped;
+			return;
+		}
+
+		std::uint16_t const program = intern(mProgramIds, mPrograms, &info.program);
+		std::uint16_t const mesh = intern(mMeshIds, mMeshes, &info.mesh);
+
+		mSorted.push_back({ make_key(info.layer, info.translucent, program, info.material, mesh, info.depth), static_cast<std::uint32_t>(mPackets.size()) });
+		mPackets.push_back({ program, info.material, mesh, info.translucent, info.drawId, info.count });
+	}
+
+	// LSD radix sort on 8 bit digits, digits that are the same for every key are skipped
+	void RenderQueue::sort() {
+		VP_PROFILE_CPU;
+
+		std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+
+		for (SortEntry const& entry : mSorted) {
+			for (int digit = 0; digit < 8; ++digit)
+				++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+		}
+
+		mScratch.resize(mSorted.size());
+
+		for (int digit = 0; digit < 8; ++digit) {
+			auto& histogram = histograms[digit];
+			if (histogram[(mSorted.front().key >> (digit * 8)) & 0xFF] == mSorted.size()) continue;
+
+			std::uint32_t offset = 0;
+			for (auto& count : histogram) {
+				std::uint32_t const next = offset + count;
+				count = offset;
+				offset = next;
+			}
+
+			for (SortEntry const& entry : mSorted)
+				mScratch[histogram[(entry.key >> (digit * 8)) & 0xFF]++] = entry;
+
+			mSorted.swap(mScratch);
+		}
+	}
+
+	void RenderQueue::replay() {
+		VP_PROFILE_CPU;
+
+		glstate::Stats const before = glstate::stats();
+
+		Packet const* previous = nullptr;
+
+		for (SortEntry const& entry : mSorted) {
+			Packet const& packet = mPackets[entry.packet];
+
+			if (!previous || previous->translucent != packet.translucent) {
+				if (previous) ++mStats.blendChanges;
+
+				glstate::set_enabled(GL_BLEND, packet.translucent);
+				glstate::depth_mask(!packet.translucent);
+				if (packet.translucent) glstate::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
+
+			if (!previous || previous->program != packet.program) {
+				if (previous) ++mStats.programChanges;
+				mPrograms[packet.program]->bind();
+			}
+
+			if (!previous || previous->material != packet.material) {
+				if (previous) ++mStats.materialChanges;
+
+				Material const& material = mMaterials[packet.material];
+
+				for (std::size_t unit = 0; unit < material.textures.size(); ++unit) {
+					if (material.textures[unit]) material.textures[unit]->bind(static_cast<GLuint>(unit));
+				}
+
+				if (material.uniforms) material.uniforms->bind_base(GL_UNIFORM_BUFFER, material.uniformBinding);
+			}
+
+			if (previous && previous->mesh != packet.mesh) ++mStats.meshChanges;
+
+			if (mDrawIdLocation >= 0)
+				glProgramUniform1ui(mPrograms[packet.program]->handle(), mDrawIdLocation, packet.drawId);
+
+			mMeshes[packet.mesh]->draw(packet.count);
+			previous = &packet;
+		}
+
+		// Leave the defaults for whatever draws next, a depth clear needs depth writes on
+		glstate::set_enabled(GL_BLEND, false);
+		glstate::depth_mask(true);
+
+		glstate::Stats const after = glstate::stats();
+		mStats.issued = after.issued - before.issued;
+		mStats.elided = after.elided - before.elided;
+	}
+
+	void RenderQueue::flush() {
+		VP_PROFILE_CPU;
+
+		mStats = {};
+		mStats.draws = static_cast<std::uint32_t>(mPackets.size());
+		mStats.dropped = mDropped;
+
+		if (mDropped) VP_LOG_ERROR("Render queue dropped {} draws, a flush takes at most {} programs and {} meshes", mDropped, kMaxPrograms, kMaxMeshes);
+		mDropped = 0;
+
+		if (!mPackets.empty()) {
+			sort();
+			replay();
+		}
+
+		mPackets.clear();
+		mSorted.clear();
+		mPrograms.clear();
+		mMeshes.clear();
+		mProgramIds.clear();
+		mMeshIds.clear();
+	}
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
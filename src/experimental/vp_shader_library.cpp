@@ -0,0 +1,380 @@
+#include "vulpengine/experimental/vp_shader_library.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_util.hpp"
+#include "vulpengine/vp_profile.hpp"
+#include "vulpengine/experimental/vp_vfs.hpp"
+
+#include <cassert>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+// These platform files should define `class FileWatcher` with
+// `void watch(std::filesystem::path const& file)` and
+// `std::vector<std::filesystem::path> wait(std::chrono::milliseconds timeout)`
+// `wait` returns the canonical paths of changed files
+
+#ifdef VP_WINDOWS
+#	include "vp_shader_library_win.inl"
+#endif
+
+#ifdef VP_LINUX
+#	include "vp_shader_library_linux.inl"
+#endif
+
+namespace vulpengine::experimental {
+	namespace {
+		constexpr std::array<std::string_view, 2> kStageInjects = {
+			"#version 460 core\n#define VERT",
+			"#version 460 core\n#define FRAG",
+		};
+
+		constexpr int kMaxIncludeDepth = 32;
+
+		std::filesystem::path canonical_path(std::filesystem::path const& path) {
+			std::error_code ec;
+			std::filesystem::path result = std::filesystem::weakly_canonical(path, ec);
+			return ec ? path : result;
+		}
+
+		// Every file is read once, from a mounted archive or disk, and shared between stages and programs
+		class IncludeCache final {
+		public:
+			std::shared_ptr<std::string const> get(std::filesystem::path const& path) {
+				std::string key = path.string();
+
+				{
+					std::lock_guard lock(mMutex);
+					auto it = mFiles.find(key);
+					if (it != mFiles.end()) return it->second;
+				}
+
+				vfs::File const contents = vfs::open(path);
+				if (!contents) return nullptr;
+
+				auto file = std::make_shared<std::string const>(contents.text());
+
+				std::lock_guard lock(mMutex);
+				return mFiles.try_emplace(std::move(key), std::move(file)).first->second;
+			}
+
+			void invalidate(std::filesystem::path const& path) {
+				std::lock_guard lock(mMutex);
+				mFiles.erase(path.string());
+			}
+		private:
+			std::mutex mMutex;
+			std::unordered_map<std::string, std::shared_ptr<std::string const>> mFiles;
+		};
+
+		// Matches stb_include: `#include "file"` is resolved against the include path and `#inject` is replaced by `inject`.
+		// `#line` directives use the index into `dependencies` as the source string number.
+		class Preprocessor final {
+		public:
+			Preprocessor(IncludeCache& cache, std::filesystem::path const& includePath, std::string_view inject)
+				: mCache(cache), mIncludePath(includePath), mInject(inject) {}
+
+			bool run(std::filesystem::path const& file, std::string& output, std::vector<std::filesystem::path>& dependencies) {
+				mOutput = &output;
+				mDependencies = &dependencies;
+				return expand(canonical_path(file), 0);
+			}
+		private:
+			bool expand(std::filesystem::path const& file, int depth) {
+				if (depth > kMaxIncludeDepth) {
+					VP_LOG_ERROR("Shader preprocessor error in {}: includes nested too deeply", file.string());
+					return false;
+				}
+
+				std::shared_ptr<std::string const> source = mCache.get(file);
+				if (!source) {
+					VP_LOG_ERROR("Shader preprocessor error: unable to open {}", file.string());
+					return false;
+				}
+
+				std::size_t const sourceIndex = add_dependency(file);
+				if (depth > 0) *mOutput += std::format("#line 1 {}\n", sourceIndex);
+
+				std::string_view remaining = *source;
+				int lineNumber = 0;
+
+				while (!remaining.empty()) {
+					std::size_t const end = remaining.find('\n');
+					std::string_view line = remaining.substr(0, end);
+					remaining.remove_prefix(end == std::string_view::npos ? remaining.size() : end + 1);
+					++lineNumber;
+
+					std::string_view directive = line.substr(std::min(line.find_first_not_of(" \t"), line.size()));
+
+					if (directive.starts_with("#inject")) {
+						*mOutput += mInject;
+						*mOutput += '\n';
+						*mOutput += std::format("#line {} {}\n", lineNumber + 1, sourceIndex);
+						continue;
+					}
+
+					if (directive.starts_with("#include")) {
+						std::size_t const open = directive.find('"');
+						std::size_t const close = open == std::string_view::npos ? open : directive.find('"', open + 1);
+
+						if (close == std::string_view::npos) {
+							VP_LOG_ERROR("Shader preprocessor error in {}({}): malformed include", file.string(), lineNumber);
+							return false;
+						}
+
+						std::filesystem::path included = canonical_path(mIncludePath / directive.substr(open + 1, close - open - 1));
+
+						if (!expand(included, depth + 1)) return false;
+						*mOutput += std::format("\n#line {} {}\n", lineNumber + 1, sourceIndex);
+						continue;
+					}
+
+					*mOutput += line;
+					*mOutput += '\n';
+				}
+
+				return true;
+			}
+
+			std::size_t add_dependency(std::filesystem::path const& file) {
+				auto it = std::find(mDependencies->begin(), mDependencies->end(), file);
+				if (it != mDependencies->end()) return it - mDependencies->begin();
+				mDependencies->push_back(file);
+				return mDependencies->size() - 1;
+			}
+
+			IncludeCache& mCache;
+			std::filesystem::path const& mIncludePath;
+			std::string_view mInject;
+			std::string* mOutput = nullptr;
+			std::vector<std::filesystem::path>* mDependencies = nullptr;
+		};
+
+		struct Sources final {
+			std::array<std::string, kStageInjects.size()> stages;
+			std::vector<std::filesystem::path> dependencies;
+		};
+
+		std::optional<Sources> preprocess_program(IncludeCache& cache, std::filesystem::path const& includePath, std::filesystem::path const& file) {
+			Sources sources;
+
+			for (std::size_t i = 0; i < kStageInjects.size(); ++i) {
+				// Stages share a file list, `#line` source numbers match between them
+				Preprocessor preprocessor(cache, includePath, kStageInjects[i]);
+				if (!preprocessor.run(file, sources.stages[i], sources.dependencies)) return std::nullopt;
+			}
+
+			return sources;
+		}
+	}
+
+	struct ShaderLibrary::Impl final {
+		struct Entry final {
+			std::filesystem::path file;
+			std::vector<std::filesystem::path> dependencies;
+			ShaderProgram program;
+		};
+
+		struct Rebuild final {
+			Handle handle;
+			Sources sources;
+		};
+
+		std::filesystem::path includePath;
+		std::optional<std::string> cacheDirectory;
+
+		IncludeCache cache;
+		ShaderCompiler compiler;
+
+		// Guards `entries` metadata, `reverseGraph` and `rebuilds`, programs are only touched on the GL thread
+		mutable std::mutex mutex;
+		std::vector<std::unique_ptr<Entry>> entries;
+		std::unordered_map<std::string, std::unordered_set<Handle>> reverseGraph;
+		std::vector<Rebuild> rebuilds;
+		std::vector<std::pair<ShaderCompiler::Ticket, Rebuild>> compiling;
+
+		std::optional<FileWatcher> watcher;
+		std::atomic_bool stop = false;
+		std::thread thread;
+
+		~Impl() noexcept {
+			if (thread.joinable()) {
+				stop = true;
+				thread.join();
+			}
+		}
+
+		// Expects `mutex` to be held
+		void set_dependencies(Handle handle, std::vector<std::filesystem::path> dependencies) {
+			Entry& entry = *entries[handle];
+
+			for (auto const& file : entry.dependencies)
+				reverseGraph[file.string()].erase(handle);
+
+			entry.dependencies = std::move(dependencies);
+
+			for (auto const& file : entry.dependencies) {
+				reverseGraph[file.string()].insert(handle);
+				if (watcher) watcher->watch(file);
+			}
+		}
+
+		void watch_loop() {
+			while (!stop) {
+				std::vector<std::filesystem::path> changed = watcher->wait(std::chrono::milliseconds(100));
+				if (changed.empty()) continue;
+
+				VP_PROFILE_CPU;
+
+				std::unordered_set<Handle> affected;
+				std::vector<std::pair<Handle, std::filesystem::path>> files;
+
+				{
+					std::lock_guard lock(mutex);
+
+					for (auto const& file : changed) {
+						auto it = reverseGraph.find(file.string());
+						if (it == reverseGraph.end()) continue;
+						affected.insert(it->second.begin(), it->second.end());
+					}
+
+					for (Handle handle : affected)
+						files.emplace_back(handle, entries[handle]->file);
+				}
+
+				// Invalidate everything before preprocessing so no program sees a stale include
+				for (auto const& file : changed)
+					cache.invalidate(file);
+
+				for (auto& [handle, file] : files) {
+					VP_LOG_INFO("Reloading shader program: {}", file.string());
+
+					std::optional<Sources> sources = preprocess_program(cache, includePath, file);
+					if (!sources) continue;
+
+					std::lock_guard lock(mutex);
+					set_dependencies(handle, sources->dependencies);
+					rebuilds.push_back({ handle, std::move(*sources) });
+				}
+			}
+		}
+	};
+
+	ShaderLibrary::ShaderLibrary(CreateInfo const& info) : mImpl(std::make_unique<Impl>()) {
+		mImpl->includePath = canonical_path(info.includePath);
+		if (info.cacheDirectory) mImpl->cacheDirectory = info.cacheDirectory;
+
+		if (info.watch) {
+			mImpl->watcher.emplace();
+			mImpl->thread = std::thread(&Impl::watch_loop, mImpl.get());
+		}
+	}
+
+	ShaderLibrary::ShaderLibrary(ShaderLibrary&&) noexcept = default;
+	ShaderLibrary& ShaderLibrary::operator=(ShaderLibrary&&) noexcept = default;
+
+	ShaderLibrary::~ShaderLibrary() noexcept = default;
+
+	ShaderLibrary::Handle ShaderLibrary::load(char const* file) {
+		VP_PROFILE_CPU;
+		assert(valid());
+		assert(file != nullptr);
+
+		std::filesystem::path path = canonical_path(file);
+		std::optional<Sources> sources = preprocess_program(mImpl->cache, mImpl->includePath, path);
+
+		auto entry = std::make_unique<Impl::Entry>();
+		entry->file = path;
+
+		if (sources) {
+			entry->program = { {
+				.vertex = sources->stages[0],
+				.fragment = sources->stages[1],
+				.label = file,
+				.cacheDirectory = mImpl->cacheDirectory ? mImpl->cacheDirectory->c_str() : nullptr
+			} };
+		}
+
+		std::lock_guard lock(mImpl->mutex);
+		mImpl->entries.push_back(std::move(entry));
+		Handle handle = mImpl->entries.size() - 1;
+
+		// A program that failed to preprocess is still watched, fixing the file builds it
+		mImpl->set_dependencies(handle, sources ? std::move(sources->dependencies) : std::vector{ path });
+		return handle;
+	}
+
+	ShaderProgram const& ShaderLibrary::get(Handle handle) const {
+		assert(valid());
+		std::lock_guard lock(mImpl->mutex);
+		assert(handle < mImpl->entries.size());
+		return mImpl->entries[handle]->program;
+	}
+
+	std::vector<std::filesystem::path> ShaderLibrary::dependencies(Handle handle) const {
+		assert(valid());
+		std::lock_guard lock(mImpl->mutex);
+		assert(handle < mImpl->entries.size());
+		return mImpl->entries[handle]->dependencies;
+	}
+
+	std::size_t ShaderLibrary::update() {
+		VP_PROFILE_CPU;
+		assert(valid());
+
+		std::vector<Impl::Rebuild> rebuilds;
+
+		{
+			std::lock_guard lock(mImpl->mutex);
+			rebuilds.swap(mImpl->rebuilds);
+		}
+
+		for (auto& rebuild : rebuilds) {
+			std::string label = mImpl->entries[rebuild.handle]->file.string();
+
+			ShaderCompiler::Ticket ticket = mImpl->compiler.submit(ShaderProgram::SourceInfo{
+				.vertex = rebuild.sources.stages[0],
+				.fragment = rebuild.sources.stages[1],
+				.label = label.c_str(),
+				.cacheDirectory = mImpl->cacheDirectory ? mImpl->cacheDirectory->c_str() : nullptr
+			});
+
+			mImpl->compiling.emplace_back(ticket, std::move(rebuild));
+		}
+
+		if (mImpl->compiling.empty()) return 0;
+
+		mImpl->compiler.poll();
+
+		std::size_t swapped = 0;
+
+		std::erase_if(mImpl->compiling, [&](auto& compiling) {
+			auto& [ticket, rebuild] = compiling;
+			if (!mImpl->compiler.ready(ticket)) return false;
+
+			ShaderProgram program = mImpl->compiler.take(ticket);
+
+			// Keep the last working version around if the edit broke something
+			if (program) {
+				mImpl->entries[rebuild.handle]->program = std::move(program);
+				++swapped;
+			}
+
+			return true;
+		});
+
+		return swapped;
+	}
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
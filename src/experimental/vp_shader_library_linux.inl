@@ -0,0 +1,80 @@
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace {
+	// Directories are watched instead of files, editors often save by replacing the file
+	class FileWatcher final {
+	public:
+		FileWatcher() {
+			mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (mFd == -1) VP_LOG_ERROR("inotify_init1 failed, shaders won't reload");
+		}
+
+		FileWatcher(FileWatcher const&) = delete;
+		FileWatcher& operator=(FileWatcher const&) = delete;
+
+		~FileWatcher() noexcept {
+			if (mFd != -1) close(mFd);
+		}
+
+		void watch(std::filesystem::path const& file) {
+			if (mFd == -1) return;
+
+			std::filesystem::path directory = file.parent_path();
+
+			std::lock_guard lock(mMutex);
+			for (auto const& [wd, path] : mDirectories)
+				if (path == directory) return;
+
+			int wd = inotify_add_watch(mFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+			if (wd == -1) {
+				VP_LOG_WARN("Unable to watch {}", directory.string());
+				return;
+			}
+
+			mDirectories.emplace(wd, std::move(directory));
+		}
+
+		std::vector<std::filesystem::path> wait(std::chrono::milliseconds timeout) {
+			std::vector<std::filesystem::path> changed;
+			if (mFd == -1) {
+				std::this_thread::sleep_for(timeout);
+				return changed;
+			}
+
+			pollfd fd = { .fd = mFd, .events = POLLIN, .revents = 0 };
+			if (poll(&fd, 1, static_cast<int>(timeout.count())) <= 0) return changed;
+
+			// Saving usually produces a burst of events, give it a moment to settle
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+			alignas(inotify_event) char buffer[4096];
+
+			for (;;) {
+				ssize_t length = read(mFd, buffer, sizeof(buffer));
+				if (length <= 0) break;
+
+				std::lock_guard lock(mMutex);
+
+				for (char* ptr = buffer; ptr < buffer + length;) {
+					inotify_event const* event = reinterpret_cast<inotify_event const*>(ptr);
+					ptr += sizeof(inotify_event) + event->len;
+
+					auto it = mDirectories.find(event->wd);
+					if (it == mDirectories.end() || event->len == 0) continue;
+
+					std::filesystem::path path = it->second / event->name;
+					if (std::find(changed.begin(), changed.end(), path) == changed.end())
+						changed.push_back(std::move(path));
+				}
+			}
+
+			return changed;
+		}
+	private:
+		int mFd = -1;
+		std::mutex mMutex;
+		std::unordered_map<int, std::filesystem::path> mDirectories;
+	};
+}
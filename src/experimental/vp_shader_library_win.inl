@@ -0,0 +1,34 @@
+namespace {
+	// Polls modification times, simple and good enough for a handful of shader files
+	class FileWatcher final {
+	public:
+		void watch(std::filesystem::path const& file) {
+			std::error_code ec;
+			auto time = std::filesystem::last_write_time(file, ec);
+
+			std::lock_guard lock(mMutex);
+			mFiles.try_emplace(file.string(), file, ec ? std::filesystem::file_time_type::min() : time);
+		}
+
+		std::vector<std::filesystem::path> wait(std::chrono::milliseconds timeout) {
+			std::this_thread::sleep_for(timeout);
+
+			std::vector<std::filesystem::path> changed;
+			std::lock_guard lock(mMutex);
+
+			for (auto& [key, entry] : mFiles) {
+				std::error_code ec;
+				auto time = std::filesystem::last_write_time(entry.first, ec);
+				if (ec || time == entry.second) continue;
+
+				entry.second = time;
+				changed.push_back(entry.first);
+			}
+
+			return changed;
+		}
+	private:
+		std::mutex mMutex;
+		std::unordered_map<std::string, std::pair<std::filesystem::path, std::filesystem::file_time_type>> mFiles;
+	};
+}
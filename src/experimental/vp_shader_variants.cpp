@@ -0,0 +1,92 @@
+#include "vulpengine/experimental/vp_shader_variants.hpp"
+
+#ifdef VP_HAS_SHADER_PROGRAM
+
+#include "vulpengine/vp_profile.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+namespace vulpengine::experimental {
+	ShaderVariantKey::ShaderVariantKey(std::initializer_list<std::string_view> defines) {
+		for (auto define : defines) this->define(define);
+	}
+
+	ShaderVariantKey& ShaderVariantKey::define(std::string_view define) {
+		auto it = std::lower_bound(mDefines.begin(), mDefines.end(), define);
+		if (it != mDefines.end() && *it == define) return *this;
+		mDefines.emplace(it, define);
+
+		// Separate entries so `AB` and `A`,`B` hash differently
+		mId = hash_fnv1a("");
+		for (auto const& entry : mDefines) {
+			mId = hash_fnv1a(entry, mId);
+			mId = hash_fnv1a("\n", mId);
+		}
+
+		return *this;
+	}
+
+	ShaderVariants::ShaderVariants(CreateInfo const& info)
+		: mFile(info.file), mIncludePath(info.includePath), mBackground(info.background), mFallback(info.fallback) {
+		assert(info.file != nullptr);
+		if (info.cacheDirectory) mCacheDirectory = info.cacheDirectory;
+		if (mBackground) mCompiler.emplace();
+	}
+
+	ShaderProgram::CreateInfo ShaderVariants::create_info(ShaderVariantKey const& key, std::vector<std::string_view>& defines) const {
+		defines.assign(key.defines().begin(), key.defines().end());
+
+		return {
+			.file = mFile.c_str(),
+			.includePath = mIncludePath.c_str(),
+			.defines = defines,
+			.cacheDirectory = mCacheDirectory ? mCacheDirectory->c_str() : nullptr
+		};
+	}
+
+	ShaderProgram const& ShaderVariants::get(ShaderVariantKey const& key) {
+		auto it = mVariants.find(key.id());
+		if (it != mVariants.end() && !it->second.ticket) return it->second.program;
+
+		std::vector<std::string_view> defines;
+
+		if (it == mVariants.end()) {
+			VP_PROFILE_CPU;
+
+			if (!mBackground || key == mFallback) {
+				Variant& variant = mVariants[key.id()];
+				variant.program = ShaderProgram(create_info(key, defines));
+				return variant.program;
+			}
+
+			mVariants[key.id()].ticket = mCompiler->submit(create_info(key, defines));
+		}
+
+		// Still compiling in the background
+		return get(mFallback);
+	}
+
+	bool ShaderVariants::ready(ShaderVariantKey const& key) const {
+		auto it = mVariants.find(key.id());
+		return it != mVariants.end() && !it->second.ticket;
+	}
+
+	bool ShaderVariants::update() {
+		if (!mCompiler || mCompiler->pending() == 0) return true;
+
+		VP_PROFILE_CPU;
+
+		bool const done = mCompiler->poll();
+
+		for (auto& [id, variant] : mVariants) {
+			if (!variant.ticket || !mCompiler->ready(*variant.ticket)) continue;
+			variant.program = mCompiler->take(*variant.ticket);
+			variant.ticket.reset();
+		}
+
+		return done;
+	}
+}
+
+#endif // VP_HAS_SHADER_PROGRAM
@@ -0,0 +1,51 @@
+#include "vulpengine/experimental/vp_state.hpp"
+
+#include "vulpengine/vp_profile.hpp"
+
+#include <algorithm>
+
+namespace vulpengine::experimental {
+	StateManager::~StateManager() noexcept {
+		abandon();
+		for (Loading& loading : mAbandoned) tasks::sync_wait(std::move(loading.task));
+		if (mState) mState->on_detach();
+	}
+
+	void StateManager::update() {
+		VP_PROFILE_CPU;
+
+		std::erase_if(mAbandoned, [](Loading const& loading) { return loading.task.done(); });
+
+		if (mNext.state && mNext.task.done()) {
+			mNext.task = {};
+			attach(std::move(mNext.state));
+		}
+
+		// Nothing to tick until the first preload is ready
+		if (mState) mState->update();
+	}
+
+	void StateManager::reset() {
+		abandon();
+		if (mState) mState->on_detach();
+		mState = nullptr;
+	}
+
+	void StateManager::attach(std::unique_ptr<State> state) {
+		VP_PROFILE_CPU;
+
+		if (mState) mState->on_detach();
+		mState = nullptr;
+
+		state->report_progress(1.0f);
+		mState = std::move(state);
+		mState->on_attach();
+	}
+
+	void StateManager::abandon() {
+		if (!mNext.state) return;
+
+		if (mNext.task.done()) mNext = {};
+		else mAbandoned.push_back(std::move(mNext));
+	}
+}
@@ -0,0 +1,151 @@
+#include "vulpengine/experimental/vp_task.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+#include "vulpengine/experimental/vp_async_io.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace vulpengine::experimental::tasks {
+	namespace {
+		// Reads block, so they get their own thread rather than stalling a job worker
+		struct IoThread final {
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::deque<detail::ReadRequest*> requests;
+			std::thread thread;
+			bool stop = false;
+		};
+
+		struct GlQueue final {
+			std::mutex mutex;
+			std::vector<std::coroutine_handle<>> handles;
+			std::atomic<std::thread::id> thread;
+		};
+
+		IoThread gIo;
+		GlQueue gGl;
+
+		void resume(detail::ReadRequest* request) {
+			std::coroutine_handle<> const handle = request->handle;
+			jobs::run([handle] { handle.resume(); }, "task");
+		}
+
+		void io_loop() {
+#ifdef VP_HAS_TRACY
+			tracy::SetThreadName("I/O");
+#else
+			profiler::set_thread_name("I/O");
+#endif
+
+			aio::Reader reader;
+			std::vector<detail::ReadRequest*> batch;
+			std::vector<aio::Completion> completions;
+
+			while (true) {
+				{
+					// Only sleeps with nothing in flight, requests arriving meanwhile make the next batch
+					std::unique_lock lock(gIo.mutex);
+					if (!reader.pending()) gIo.wake.wait(lock, [] { return gIo.stop || !gIo.requests.empty(); });
+					if (gIo.requests.empty() && !reader.pending()) return; // Stopping, and everything queued was read
+
+					batch.assign(gIo.requests.begin(), gIo.requests.end());
+					gIo.requests.clear();
+				}
+
+				for (detail::ReadRequest* request : batch) {
+					// Archives are mapped, reading from one is a copy or a decompress
+					std::error_code ec;
+					std::uintmax_t size = 0;
+					bool const loose = vfs::loose_files() && !vfs::archived(request->path);
+					if (loose) size = std::filesystem::file_size(request->path, ec);
+
+					if (!loose || ec) {
+						VP_PROFILE_CPU_N("read_file");
+						request->file = vfs::open(request->path);
+						resume(request);
+						continue;
+					}
+
+					request->buffer.resize(static_cast<std::size_t>(size));
+					reader.read(request->path, request->buffer, reinterpret_cast<std::uintptr_t>(request));
+				}
+
+				reader.submit();
+				if (!reader.pending()) continue;
+
+				completions.clear();
+				reader.wait(completions);
+
+				for (aio::Completion const& completion : completions) {
+					auto* request = reinterpret_cast<detail::ReadRequest*>(completion.user);
+					if (completion.ok && completion.bytes == request->buffer.size()) request->file = vfs::File(std::move(request->buffer));
+					resume(request);
+				}
+			}
+		}
+	}
+
+	void detail::queue_read(ReadRequest& request) {
+		{
+			std::lock_guard lock(gIo.mutex);
+			if (!gIo.thread.joinable()) {
+				gIo.stop = false;
+				gIo.thread = std::thread(io_loop);
+			}
+			gIo.requests.push_back(&request);
+		}
+
+		gIo.wake.notify_one();
+	}
+
+	void detail::queue_gl(std::coroutine_handle<> handle) {
+		std::lock_guard lock(gGl.mutex);
+		gGl.handles.push_back(handle);
+	}
+
+	bool detail::claim_gl_thread() {
+		std::thread::id none;
+		std::thread::id const self = std::this_thread::get_id();
+		return gGl.thread.compare_exchange_strong(none, self, std::memory_order_relaxed) || none == self;
+	}
+
+	bool on_gl_thread() {
+		return gGl.thread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+	}
+
+	std::size_t poll() {
+		if (!detail::claim_gl_thread()) {
+			VP_LOG_ERROR("tasks::poll called off the GL thread");
+			return 0;
+		}
+
+		// Continuations queued while these run wait for the next poll
+		thread_local std::vector<std::coroutine_handle<>> tReady;
+		{
+			std::lock_guard lock(gGl.mutex);
+			if (gGl.handles.empty()) return 0;
+			std::swap(tReady, gGl.handles);
+		}
+
+		VP_PROFILE_CPU_N("tasks::poll");
+		for (std::coroutine_handle<> handle : tReady) handle.resume();
+
+		std::size_t const count = tReady.size();
+		tReady.clear();
+		return count;
+	}
+
+	void shutdown() {
+		{
+			std::lock_guard lock(gIo.mutex);
+			if (!gIo.thread.joinable()) return;
+			gIo.stop = true;
+		}
+
+		gIo.wake.notify_one();
+		gIo.thread.join();
+	}
+}
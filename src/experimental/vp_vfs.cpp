@@ -0,0 +1,182 @@
+#include "vulpengine/experimental/vp_vfs.hpp"
+
+#include "vulpengine/vp_log.hpp"
+#include "vulpengine/vp_profile.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+
+namespace vulpengine::experimental::vfs {
+	namespace {
+		struct Mount final {
+			std::filesystem::path path;
+			std::shared_ptr<Archive const> archive;
+		};
+
+		struct Location final {
+			std::shared_ptr<Archive const> archive;
+			std::size_t index = 0;
+		};
+
+		struct State final {
+			std::shared_mutex mutex;
+			std::vector<Mount> mounts; // Highest priority last
+			std::atomic_bool looseFiles = true;
+		};
+
+		State& state() {
+			static State instance;
+			return instance;
+		}
+
+		std::optional<Location> locate(std::filesystem::path const& path) {
+			State& vfs = state();
+			std::shared_lock lock(vfs.mutex);
+			if (vfs.mounts.empty()) return std::nullopt;
+
+			std::string const name = archive_path(path);
+
+			for (auto it = vfs.mounts.rbegin(); it != vfs.mounts.rend(); ++it)
+				if (std::optional<std::size_t> index = it->archive->find(name))
+					return Location{ it->archive, *index };
+
+			return std::nullopt;
+		}
+
+		std::optional<std::size_t> loose_size(std::filesystem::path const& path) {
+			std::error_code ec;
+			std::uintmax_t const size = std::filesystem::file_size(path, ec);
+			if (ec) return std::nullopt;
+			return static_cast<std::size_t>(size);
+		}
+
+		bool read_loose(std::filesystem::path const& path, std::span<std::byte> output) {
+			std::ifstream file(path, std::ios::in | std::ios::binary);
+			if (!file) return false;
+
+			file.read(reinterpret_cast<char*>(output.data()), static_cast<std::streamsize>(output.size()));
+			return file.gcount() == static_cast<std::streamsize>(output.size()) && file.peek() == std::ifstream::traits_type::eof();
+		}
+	}
+
+	File& File::operator=(File&& other) noexcept {
+		std::swap(mArchive, other.mArchive);
+		std::swap(mBuffer, other.mBuffer);
+		std::swap(mBytes, other.mBytes);
+		std::swap(mValid, other.mValid);
+		return *this;
+	}
+
+	bool mount(std::filesystem::path const& archive) {
+		auto mounted = std::make_shared<Archive const>(archive);
+		if (!mounted->valid()) return false;
+
+		State& vfs = state();
+		std::unique_lock lock(vfs.mutex);
+		vfs.mounts.push_back({ archive, std::move(mounted) });
+
+		VP_LOG_INFO("Mounted {} ({} files)", archive.string(), vfs.mounts.back().archive->entry_count());
+		return true;
+	}
+
+	bool unmount(std::filesystem::path const& archive) {
+		State& vfs = state();
+		std::unique_lock lock(vfs.mutex);
+
+		// The most recent mount of the same archive goes first
+		auto it = std::find_if(vfs.mounts.rbegin(), vfs.mounts.rend(), [&](Mount const& mount) { return mount.path == archive; });
+		if (it == vfs.mounts.rend()) return false;
+
+		vfs.mounts.erase(std::next(it).base());
+		return true;
+	}
+
+	void unmount_all() {
+		State& vfs = state();
+		std::unique_lock lock(vfs.mutex);
+		vfs.mounts.clear();
+	}
+
+	void set_loose_files(bool enabled) {
+		state().looseFiles.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool loose_files() {
+		return state().looseFiles.load(std::memory_order_relaxed);
+	}
+
+	bool exists(std::filesystem::path const& path) {
+		return size(path).has_value();
+	}
+
+	bool archived(std::filesystem::path const& path) {
+		return locate(path).has_value();
+	}
+
+	std::optional<std::size_t> size(std::filesystem::path const& path) {
+		if (std::optional<Location> location = locate(path))
+			return static_cast<std::size_t>(location->archive->entry(location->index).size);
+
+		if (!loose_files()) return std::nullopt;
+		return loose_size(path);
+	}
+
+	File open(std::filesystem::path const& path) {
+		VP_PROFILE_CPU;
+
+		File file;
+
+		if (std::optional<Location> location = locate(path)) {
+			Archive const& archive = *location->archive;
+			Archive::Entry const entry = archive.entry(location->index);
+
+			if (entry.compressed) {
+				file.mBuffer.resize(entry.size);
+				if (!archive.read(location->index, file.mBuffer)) return {};
+				file.mBytes = file.mBuffer;
+			} else {
+				file.mBytes = archive.view(location->index);
+			}
+
+			file.mArchive = std::move(location->archive);
+			file.mValid = true;
+			return file;
+		}
+
+		if (!loose_files()) return file;
+
+		std::optional<std::size_t> const size = loose_size(path);
+		if (!size) return file;
+
+		file.mBuffer.resize(*size);
+		if (!read_loose(path, file.mBuffer)) return {};
+
+		file.mBytes = file.mBuffer;
+		file.mValid = true;
+		return file;
+	}
+
+	bool read(std::filesystem::path const& path, std::span<std::byte> output) {
+		VP_PROFILE_CPU;
+
+		if (std::optional<Location> location = locate(path))
+			return location->archive->read(location->index, output);
+
+		if (!loose_files()) return false;
+
+		std::optional<std::size_t> const size = loose_size(path);
+		if (!size) return false;
+
+		if (*size != output.size()) {
+			VP_LOG_ERROR("Read of {} expects {} bytes, got {}", path.string(), *size, output.size());
+			return false;
+		}
+
+		return read_loose(path, output);
+	}
+}
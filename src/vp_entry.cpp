@@ -1,18 +1,36 @@
 #include "vulpengine/vp_entry.hpp"
 #include "vulpengine/vp_log.hpp"
+#include "vulpengine/experimental/vp_jobs.hpp"
+#include "vulpengine/experimental/vp_task.hpp"
+
+#ifdef VP_LIB_GLAD
+#include "vulpengine/experimental/vp_gpu_memory.hpp"
+#endif
 
 namespace vulpengine {
 	void entry_init() {
 #ifdef VP_HAS_SPDLOG
 		spdlog::set_level(spdlog::level::level_enum::trace);
+#else
+		logger::start();
 #endif
 	}
 
 	void entry_uninit() {
+		// Jobs may still log or free GPU memory, reads still queue jobs
+		vulpengine::experimental::tasks::shutdown();
+		vulpengine::experimental::jobs::shutdown();
+
+#ifdef VP_LIB_GLAD
+		vulpengine::experimental::gpumemory::report_leaks();
+#endif
+
 #ifdef VP_HAS_SPDLOG
 		spdlog::default_logger()->flush();
 		spdlog::drop_all();
 		spdlog::shutdown();
+#else
+		logger::stop();
 #endif
 	}
 }
@@ -0,0 +1,352 @@
+#include "vulpengine/vp_logger.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vulpengine::logger {
+	namespace {
+		constexpr std::size_t kRingSize = 1 << 16;
+
+		// Longer messages bypass the ring, they're rare (shader info logs) and would hog it
+		constexpr std::size_t kMaxQueuedMessage = kRingSize / 4;
+
+		constexpr std::chrono::milliseconds kIdleInterval{ 1 };
+
+		// stdout is flushed when the writer goes idle or after this long, stderr on every write
+		constexpr std::chrono::milliseconds kFlushInterval{ 100 };
+
+		struct Record final {
+			std::int64_t time; // system_clock nanoseconds
+			std::uint32_t length;
+			Level level;
+		};
+
+		// Single producer (the owning thread), single consumer (whoever holds the logger mutex)
+		struct ThreadRing final {
+			std::array<char, kRingSize> bytes;
+			std::atomic<std::uint64_t> head = 0;
+			std::atomic<std::uint64_t> tail = 0;
+			std::atomic_bool alive = true;
+
+			void copy_in(std::uint64_t position, void const* source, std::size_t size) {
+				std::size_t const offset = position & (kRingSize - 1);
+				std::size_t const first = std::min(size, kRingSize - offset);
+				std::memcpy(bytes.data() + offset, source, first);
+				std::memcpy(bytes.data(), static_cast<char const*>(source) + first, size - first);
+			}
+
+			void copy_out(std::uint64_t position, void* destination, std::size_t size) const {
+				std::size_t const offset = position & (kRingSize - 1);
+				std::size_t const first = std::min(size, kRingSize - offset);
+				std::memcpy(destination, bytes.data() + offset, first);
+				std::memcpy(static_cast<char*>(destination) + first, bytes.data(), size - first);
+			}
+
+			bool try_push(Record const& record, std::string_view message) {
+				std::size_t const size = sizeof(Record) + message.size();
+				std::uint64_t const h = head.load(std::memory_order_relaxed);
+
+				if (kRingSize - (h - tail.load(std::memory_order_acquire)) < size)
+					return false;
+
+				copy_in(h, &record, sizeof(Record));
+				copy_in(h + sizeof(Record), message.data(), message.size());
+				head.store(h + size, std::memory_order_release);
+				return true;
+			}
+		};
+
+		struct Line final {
+			Record record;
+			char const* data; // Into the ring, or null for a message that wrapped around and was copied
+			std::size_t offset; // Into the drained text, when `data` is null
+		};
+
+		struct Logger final {
+			std::mutex mutex;
+			std::vector<std::shared_ptr<ThreadRing>> rings;
+			std::FILE* out = stdout;
+			std::FILE* err = stderr;
+
+			std::atomic_bool running = false;
+			std::thread writer;
+
+			// Reused between drains, guarded by the mutex
+			std::vector<Line> lines;
+			std::vector<std::uint64_t> heads; // Per ring, where the drain stopped
+			std::string text;
+			std::string outBatch, errBatch;
+			std::time_t cachedSecond = -1;
+			char cachedPrefix[32] = {};
+			bool outDirty = false; // Written to `out` since its last flush
+
+			~Logger() noexcept {
+				stop();
+			}
+
+			void stop() {
+				if (!running.exchange(false)) return;
+				if (writer.joinable()) writer.join();
+			}
+		};
+
+		Logger& instance() {
+			static Logger logger;
+			return logger;
+		}
+
+		// Flags the ring so the writer can drop it once drained
+		struct ThreadHandle final {
+			std::shared_ptr<ThreadRing> ring;
+
+			~ThreadHandle() noexcept {
+				if (ring) ring->alive = false;
+			}
+		};
+
+		thread_local ThreadHandle tThread;
+
+		ThreadRing& thread_ring() {
+			if (!tThread.ring) {
+				auto ring = std::make_shared<ThreadRing>();
+
+				Logger& logger = instance();
+				std::lock_guard lock(logger.mutex);
+				logger.rings.push_back(ring);
+				tThread.ring = std::move(ring);
+			}
+
+			return *tThread.ring;
+		}
+
+		std::int64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		}
+
+		// "[2024-01-31 12:34:56.789] [warning] ", the date part is only rebuilt when the second changes
+		void append_line(Logger& logger, std::string& batch, Record const& record, std::string_view message) {
+			std::time_t const second = static_cast<std::time_t>(record.time / 1'000'000'000);
+
+			if (second != logger.cachedSecond) {
+				std::tm local{};
+#ifdef VP_WINDOWS
+				localtime_s(&local, &second);
+#else
+				localtime_r(&second, &local);
+#endif
+				std::strftime(logger.cachedPrefix, sizeof(logger.cachedPrefix), "[%Y-%m-%d %H:%M:%S", &local);
+				logger.cachedSecond = second;
+			}
+
+			int const milliseconds = static_cast<int>((record.time / 1'000'000) % 1000);
+			char const fraction[] = { '.', static_cast<char>('0' + milliseconds / 100), static_cast<char>('0' + milliseconds / 10 % 10), static_cast<char>('0' + milliseconds % 10), ']', ' ', '[' };
+
+			batch += logger.cachedPrefix;
+			batch.append(fraction, sizeof(fraction));
+			batch += to_string(record.level);
+			batch += "] ";
+			batch += message;
+			batch += '\n';
+		}
+
+		// Only errors are flushed right away, stdout is left to the stream's buffering and `flush_out`
+		void write_batches(Logger& logger) {
+			if (!logger.outBatch.empty()) {
+				std::fwrite(logger.outBatch.data(), 1, logger.outBatch.size(), logger.out);
+				logger.outBatch.clear();
+				logger.outDirty = true;
+			}
+
+			if (!logger.errBatch.empty()) {
+				std::fwrite(logger.errBatch.data(), 1, logger.errBatch.size(), logger.err);
+				std::fflush(logger.err);
+				logger.errBatch.clear();
+			}
+		}
+
+		// Caller holds the mutex
+		void flush_out(Logger& logger) {
+			if (!logger.outDirty) return;
+			std::fflush(logger.out);
+			logger.outDirty = false;
+		}
+
+		std::string& batch_for(Logger& logger, Level level) {
+			return level >= Level::kError ? logger.errBatch : logger.outBatch;
+		}
+
+		// Caller holds the mutex, returns the number of messages written
+		std::size_t drain_locked(Logger& logger) {
+			logger.lines.clear();
+			logger.text.clear();
+
+			std::size_t producers = 0;
+
+			// Messages are read in place, the rings' tails only move once they're written
+			logger.heads.clear();
+
+			for (auto const& ring : logger.rings) {
+				std::uint64_t position = ring->tail.load(std::memory_order_relaxed);
+				std::uint64_t const head = ring->head.load(std::memory_order_acquire);
+				logger.heads.push_back(head);
+				producers += position < head;
+
+				while (position < head) {
+					Line line;
+					ring->copy_out(position, &line.record, sizeof(Record));
+
+					std::size_t const offset = (position + sizeof(Record)) & (kRingSize - 1);
+					if (offset + line.record.length <= kRingSize) {
+						line.data = ring->bytes.data() + offset;
+						line.offset = 0;
+					} else {
+						line.data = nullptr;
+						line.offset = logger.text.size();
+						logger.text.resize(line.offset + line.record.length);
+						ring->copy_out(position + sizeof(Record), logger.text.data() + line.offset, line.record.length);
+					}
+
+					logger.lines.push_back(line);
+					position += sizeof(Record) + line.record.length;
+				}
+			}
+
+			if (!logger.lines.empty()) {
+				// Each ring is in order, lines from different threads are interleaved by time
+				if (producers > 1)
+					std::stable_sort(logger.lines.begin(), logger.lines.end(), [](Line const& a, Line const& b) { return a.record.time < b.record.time; });
+
+				for (Line const& line : logger.lines) {
+					std::string_view const message = line.data ? std::string_view(line.data, line.record.length) : std::string_view(logger.text).substr(line.offset, line.record.length);
+					append_line(logger, batch_for(logger, line.record.level), line.record, message);
+				}
+
+				write_batches(logger);
+			}
+
+			for (std::size_t i = 0; i < logger.rings.size(); ++i)
+				logger.rings[i]->tail.store(logger.heads[i], std::memory_order_release);
+
+			// Dead threads can't push again, once drained their rings go
+			std::erase_if(logger.rings, [](auto const& ring) { return !ring->alive.load(std::memory_order_acquire) && ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire); });
+
+			return logger.lines.size();
+		}
+
+		std::size_t drain(Logger& logger, bool flush = false) {
+			std::lock_guard lock(logger.mutex);
+			std::size_t const written = drain_locked(logger);
+			if (flush) flush_out(logger);
+			return written;
+		}
+
+		// Queued messages go first so a thread's lines stay in order
+		void write_now(Logger& logger, Record const& record, std::string_view message) {
+			std::lock_guard lock(logger.mutex);
+			drain_locked(logger);
+			append_line(logger, batch_for(logger, record.level), record, message);
+			write_batches(logger);
+		}
+	}
+
+	std::atomic<Level> detail::gLevel = Level::kTrace;
+
+	char* detail::line_buffer() {
+		thread_local char buffer[kLineBufferSize];
+		return buffer;
+	}
+
+	std::string& detail::format_buffer() {
+		thread_local std::string buffer;
+		return buffer;
+	}
+
+	void detail::submit(Level level, std::string_view message) {
+		Logger& logger = instance();
+		Record const record = { now(), static_cast<std::uint32_t>(message.size()), level };
+
+		if (!logger.running.load(std::memory_order_acquire) || message.size() > kMaxQueuedMessage) {
+			write_now(logger, record, message);
+			return;
+		}
+
+		ThreadRing& ring = thread_ring();
+
+		// The writer is behind, drain on this thread rather than wait for it, the ring is empty afterwards
+		if (!ring.try_push(record, message)) {
+			drain(logger);
+			ring.try_push(record, message);
+		}
+
+		// The writer may have done its final drain between the check above and the push
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (level >= Level::kCritical || !logger.running.load(std::memory_order_relaxed))
+			drain(logger);
+	}
+
+	void start() {
+		Logger& logger = instance();
+		if (logger.running.exchange(true)) return;
+
+		logger.writer = std::thread([&logger] {
+			auto lastFlush = std::chrono::steady_clock::now();
+
+			while (logger.running.load(std::memory_order_acquire)) {
+				std::size_t const written = drain(logger);
+				auto const time = std::chrono::steady_clock::now();
+
+				if (!written || time - lastFlush >= kFlushInterval) {
+					drain(logger, true);
+					lastFlush = time;
+				}
+
+				if (!written) std::this_thread::sleep_for(kIdleInterval);
+			}
+
+			drain(logger, true);
+		});
+	}
+
+	void stop() {
+		instance().stop();
+	}
+
+	bool running() {
+		return instance().running.load(std::memory_order_acquire);
+	}
+
+	void flush() {
+		drain(instance(), true);
+	}
+
+	void set_files(std::FILE* out, std::FILE* err) {
+		assert(out && err);
+
+		Logger& logger = instance();
+		std::lock_guard lock(logger.mutex);
+		drain_locked(logger);
+		flush_out(logger);
+		logger.out = out;
+		logger.err = err;
+	}
+
+	char const* to_string(Level level) {
+		switch (level) {
+			case Level::kTrace: return "trace";
+			case Level::kDebug: return "debug";
+			case Level::kInfo: return "info";
+			case Level::kWarn: return "warning";
+			case Level::kError: return "error";
+			case Level::kCritical: return "critical";
+			default: return "off";
+		}
+	}
+}
@@ -1,6 +1,11 @@
 #include "vulpengine/vp_util.hpp"
 
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 #ifdef VP_HAS_GLM
 #	include <glm/gtx/norm.hpp>
@@ -38,4 +43,71 @@ namespace vulpengine {
 		file.read(stream.data(), stream.size());
 		return stream;
 	}
-}
\ No newline at end of file
+
+	namespace {
+		constexpr std::size_t kInternBlockSize = 64 * 1024;
+
+		// Entries and their text are never freed, interned strings stay valid until exit
+		struct InternTable final {
+			std::shared_mutex mutex;
+			FlatMap<std::string_view, InternedString, StringMultiHash, StringEqual> strings;
+			std::deque<detail::InternEntry> entries;
+			std::vector<std::unique_ptr<char[]>> blocks;
+			char* cursor = nullptr;
+			std::size_t remaining = 0;
+
+			char* store(std::string_view str) {
+				std::size_t const size = str.size() + 1;
+
+				if (size > remaining) {
+					// Long strings get a block of their own so the current one isn't wasted
+					std::size_t const blockSize = std::max(size, kInternBlockSize);
+					blocks.push_back(std::make_unique<char[]>(blockSize));
+
+					if (blockSize != kInternBlockSize) {
+						std::memcpy(blocks.back().get(), str.data(), str.size());
+						return blocks.back().get();
+					}
+
+					cursor = blocks.back().get();
+					remaining = blockSize;
+				}
+
+				char* text = cursor;
+				std::memcpy(text, str.data(), str.size());
+				text[str.size()] = '\0';
+				cursor += size;
+				remaining -= size;
+				return text;
+			}
+		};
+
+		InternTable& intern_table() {
+			static InternTable* table = new InternTable;
+			return *table;
+		}
+	}
+
+	InternedString intern(std::string_view str) {
+		if (str.empty()) return {};
+
+		InternTable& table = intern_table();
+
+		{
+			std::shared_lock lock(table.mutex);
+			auto it = table.strings.find(str);
+			if (it != table.strings.end()) return it->second;
+		}
+
+		std::unique_lock lock(table.mutex);
+		auto it = table.strings.find(str);
+		if (it != table.strings.end()) return it->second;
+
+		char const* text = table.store(str);
+		detail::InternEntry const& entry = table.entries.emplace_back(detail::InternEntry{ hash_string(str), str.size(), text });
+
+		InternedString const interned(&entry);
+		table.strings.try_emplace(interned.view(), interned);
+		return interned;
+	}
+}
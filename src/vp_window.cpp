@@ -5,6 +5,8 @@
 #include "vulpengine/vp_platform.hpp"
 #include "vulpengine/vp_profile.hpp"
 #include "vulpengine/vp_log.hpp"
+#include "vulpengine/experimental/vp_frame_stats.hpp"
+#include "vulpengine/experimental/vp_ogl_state.hpp"
 
 // Prevent APIENTRY macro redefinition
 #ifdef VP_WINDOWS
@@ -15,6 +17,7 @@
 #include <GLFW/glfw3.h>
 
 #include <cstdint>
+#include <algorithm>
 
 #define VP_MAKE_VERSION(major, minor, revision) (major * 1000 + minor * 100 + revision)
 
@@ -22,9 +25,20 @@
 #	error GLFW 3.4+ is required
 #endif
 
+#ifdef VP_WINDOWS
+#	include "vp_window_win.inl"
+#endif
+
+#ifdef VP_LINUX
+#	include "vp_window_linux.inl"
+#endif
+
 namespace {
 	uint_fast16_t gWindowCount = 0;
 
+	// Decides which loader `Window::load_gl` uses
+	thread_local vulpengine::detail::HeadlessContext const* tCurrentHeadless = nullptr;
+
 	void errorCallback(int error, char const* description) {
 		VP_LOG_ERROR("GLFW Error {}: {}", error, description);
 	}
@@ -34,30 +48,53 @@ namespace vulpengine {
 	Window::Window(CreateInfo const& info) {
 		VP_PROFILE_CPU;
 
+		if (info.headless) {
+			mHeadless = detail::create_headless_context(info.width, info.height);
+
+			if (mHeadless) {
+				VP_LOG_DEBUG("Created headless context: {}", static_cast<void*>(mHeadless));
+				return;
+			}
+
+			VP_LOG_WARN("Headless context unavailable, falling back to a hidden GLFW window");
+			mHidden = true;
+		}
+
 		if (!gWindowCount) {
 			glfwSetErrorCallback(&errorCallback);
 
-			if (is_wsl())
-				glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
+			// Set every time, the hint outlives glfwTerminate
+			int platform = GLFW_ANY_PLATFORM;
+			if (info.headless && glfwPlatformSupported(GLFW_PLATFORM_NULL))
+				platform = GLFW_PLATFORM_NULL;
+			else if (is_wsl())
+				platform = GLFW_PLATFORM_X11;
+
+			glfwInitHint(GLFW_PLATFORM, platform);
 
 			if (!glfwInit()) return;
 		}
 
 		glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
-		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API); // OSMesa on the null platform
 		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
 #ifndef VP_DIST
 		glfwWindowHint(GLFW_CONTEXT_DEBUG, GLFW_TRUE);
 #endif
 
-		glfwWindowHint(GLFW_MAXIMIZED, info.maximized);
+		glfwWindowHint(GLFW_MAXIMIZED, info.maximized && !info.headless);
+		glfwWindowHint(GLFW_VISIBLE, !info.headless);
 
-		mHandle = glfwCreateWindow(info.width, info.height, info.title, nullptr, nullptr);
+		// Headless contexts accept 4.5 since software renderers may not offer 4.6
+		for (int minor = 6; minor >= (info.headless ? 5 : 6) && !mHandle; --minor) {
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+			glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+			mHandle = glfwCreateWindow(info.headless ? std::max(info.width, 1) : info.width, info.headless ? std::max(info.height, 1) : info.height, info.title, nullptr, nullptr);
+		}
 
-		if (!mHandle && !gWindowCount) {
-			glfwTerminate();
+		if (!mHandle) {
+			if (!gWindowCount) glfwTerminate();
 			return;
 		}
 
@@ -67,10 +104,23 @@ namespace vulpengine {
 
 	Window& Window::operator=(Window&& other) noexcept {
 		std::swap(mHandle, other.mHandle);
+		std::swap(mHeadless, other.mHeadless);
+		std::swap(mHidden, other.mHidden);
 		return *this;
 	}
 
 	Window::~Window() noexcept {
+		if (mHeadless) {
+			VP_LOG_DEBUG("Destroyed headless context: {}", static_cast<void*>(mHeadless));
+
+			if (tCurrentHeadless == mHeadless) {
+				detail::make_headless_context_current(nullptr);
+				tCurrentHeadless = nullptr;
+			}
+
+			detail::destroy_headless_context(mHeadless);
+		}
+
 		if (mHandle) {
 			VP_LOG_DEBUG("Destroyed window: {}", static_cast<void*>(mHandle));
 			glfwMakeContextCurrent(nullptr);
@@ -82,26 +132,48 @@ namespace vulpengine {
 	}
 
 	bool Window::should_close() const {
+		if (mHeadless) return false;
 		return glfwWindowShouldClose(mHandle);
 	}
 
+	// Nothing is presented for headless contexts, frame stats still see a (zero length) swap
 	void Window::swap_buffers() const {
 		VP_PROFILE_CPU;
 		VP_PROFILE_GPU;
-		glfwSwapBuffers(mHandle);
+
+		experimental::FrameStats* stats = experimental::FrameStats::active();
+		if (stats) stats->begin_swap();
+		if (mHandle) glfwSwapBuffers(mHandle);
+		if (stats) stats->end_swap();
 	}
 
+	// The GL state cache is per thread, what it remembers belongs to the previous context
 	void Window::make_context_current() const {
+		experimental::glstate::invalidate();
+
+		if (mHeadless) {
+			if (gWindowCount) glfwMakeContextCurrent(nullptr);
+			detail::make_headless_context_current(mHeadless);
+			tCurrentHeadless = mHeadless;
+			return;
+		}
+
+		if (tCurrentHeadless) {
+			detail::make_headless_context_current(nullptr);
+			tCurrentHeadless = nullptr;
+		}
+
 		glfwMakeContextCurrent(mHandle);
 	}
 
 	void Window::poll_events() {
 		VP_PROFILE_CPU;
-		glfwPollEvents();
+		if (gWindowCount) glfwPollEvents();
 	}
 
 	bool Window::load_gl() {
 		VP_PROFILE_CPU;
+		if (tCurrentHeadless) return gladLoadGL(&detail::headless_proc_address);
 		return gladLoadGL(&glfwGetProcAddress);
 	}
 }
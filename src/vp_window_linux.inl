@@ -0,0 +1,249 @@
+#include <dlfcn.h>
+
+#include <string_view>
+
+// EGL is loaded at runtime like GLFW does, so neither its headers nor libEGL are needed to build
+namespace {
+	using EGLBoolean = unsigned int;
+	using EGLint = std::int32_t;
+	using EGLenum = unsigned int;
+	using EGLDisplay = void*;
+	using EGLConfig = void*;
+	using EGLContext = void*;
+	using EGLSurface = void*;
+	using EGLDeviceEXT = void*;
+
+	constexpr EGLint kEglNone = 0x3038;
+	constexpr EGLint kEglExtensions = 0x3055;
+	constexpr EGLint kEglSurfaceType = 0x3033;
+	constexpr EGLint kEglPbufferBit = 0x0001;
+	constexpr EGLint kEglRenderableType = 0x3040;
+	constexpr EGLint kEglOpenGLBit = 0x0008;
+	constexpr EGLint kEglRedSize = 0x3024;
+	constexpr EGLint kEglGreenSize = 0x3023;
+	constexpr EGLint kEglBlueSize = 0x3022;
+	constexpr EGLint kEglAlphaSize = 0x3021;
+	constexpr EGLint kEglDepthSize = 0x3025;
+	constexpr EGLint kEglStencilSize = 0x3026;
+	constexpr EGLint kEglWidth = 0x3057;
+	constexpr EGLint kEglHeight = 0x3056;
+	constexpr EGLenum kEglOpenGLApi = 0x30A2;
+	constexpr EGLint kEglContextMajorVersion = 0x3098;
+	constexpr EGLint kEglContextMinorVersion = 0x30FB;
+	constexpr EGLint kEglContextOpenGLProfileMask = 0x30FD;
+	constexpr EGLint kEglContextOpenGLCoreProfileBit = 0x0001;
+	constexpr EGLint kEglContextOpenGLDebug = 0x31B0;
+	constexpr EGLint kEglContextOpenGLForwardCompatible = 0x31B1;
+	constexpr EGLenum kEglPlatformDevice = 0x313F;
+	constexpr EGLenum kEglPlatformSurfaceless = 0x31DD;
+
+	struct Egl final {
+		void* library = nullptr;
+
+		GLADapiproc(*GetProcAddress)(char const*) = nullptr;
+		EGLDisplay(*GetDisplay)(void*) = nullptr;
+		EGLDisplay(*GetPlatformDisplayEXT)(EGLenum, void*, EGLint const*) = nullptr;
+		EGLBoolean(*QueryDevicesEXT)(EGLint, EGLDeviceEXT*, EGLint*) = nullptr;
+		EGLBoolean(*Initialize)(EGLDisplay, EGLint*, EGLint*) = nullptr;
+		EGLBoolean(*Terminate)(EGLDisplay) = nullptr;
+		char const*(*QueryString)(EGLDisplay, EGLint) = nullptr;
+		EGLBoolean(*BindAPI)(EGLenum) = nullptr;
+		EGLBoolean(*ChooseConfig)(EGLDisplay, EGLint const*, EGLConfig*, EGLint, EGLint*) = nullptr;
+		EGLContext(*CreateContext)(EGLDisplay, EGLConfig, EGLContext, EGLint const*) = nullptr;
+		EGLBoolean(*DestroyContext)(EGLDisplay, EGLContext) = nullptr;
+		EGLSurface(*CreatePbufferSurface)(EGLDisplay, EGLConfig, EGLint const*) = nullptr;
+		EGLBoolean(*DestroySurface)(EGLDisplay, EGLSurface) = nullptr;
+		EGLBoolean(*MakeCurrent)(EGLDisplay, EGLSurface, EGLSurface, EGLContext) = nullptr;
+		EGLint(*GetError)() = nullptr;
+	};
+
+	Egl gEgl;
+	EGLDisplay gEglDisplay = nullptr;
+	uint_fast16_t gHeadlessCount = 0;
+
+	template<class T>
+	void load_symbol(T& function, char const* name) {
+		function = reinterpret_cast<T>(dlsym(gEgl.library, name));
+	}
+
+	bool load_egl() {
+		if (gEgl.library) return true;
+
+		gEgl.library = dlopen("libEGL.so.1", RTLD_LAZY | RTLD_LOCAL);
+		if (!gEgl.library) gEgl.library = dlopen("libEGL.so", RTLD_LAZY | RTLD_LOCAL);
+		if (!gEgl.library) return false;
+
+		load_symbol(gEgl.GetProcAddress, "eglGetProcAddress");
+		load_symbol(gEgl.GetDisplay, "eglGetDisplay");
+		load_symbol(gEgl.Initialize, "eglInitialize");
+		load_symbol(gEgl.Terminate, "eglTerminate");
+		load_symbol(gEgl.QueryString, "eglQueryString");
+		load_symbol(gEgl.BindAPI, "eglBindAPI");
+		load_symbol(gEgl.ChooseConfig, "eglChooseConfig");
+		load_symbol(gEgl.CreateContext, "eglCreateContext");
+		load_symbol(gEgl.DestroyContext, "eglDestroyContext");
+		load_symbol(gEgl.CreatePbufferSurface, "eglCreatePbufferSurface");
+		load_symbol(gEgl.DestroySurface, "eglDestroySurface");
+		load_symbol(gEgl.MakeCurrent, "eglMakeCurrent");
+		load_symbol(gEgl.GetError, "eglGetError");
+
+		if (!gEgl.GetProcAddress || !gEgl.GetDisplay || !gEgl.Initialize || !gEgl.Terminate || !gEgl.QueryString || !gEgl.BindAPI || !gEgl.ChooseConfig
+			|| !gEgl.CreateContext || !gEgl.DestroyContext || !gEgl.CreatePbufferSurface || !gEgl.DestroySurface || !gEgl.MakeCurrent || !gEgl.GetError) {
+			dlclose(gEgl.library);
+			gEgl = {};
+			return false;
+		}
+
+		gEgl.GetPlatformDisplayEXT = reinterpret_cast<decltype(gEgl.GetPlatformDisplayEXT)>(gEgl.GetProcAddress("eglGetPlatformDisplayEXT"));
+		gEgl.QueryDevicesEXT = reinterpret_cast<decltype(gEgl.QueryDevicesEXT)>(gEgl.GetProcAddress("eglQueryDevicesEXT"));
+		return true;
+	}
+
+	bool has_extension(char const* extensions, std::string_view name) {
+		if (!extensions) return false;
+
+		for (std::string_view list = extensions; !list.empty();) {
+			std::size_t const end = list.find(' ');
+			if (list.substr(0, end) == name) return true;
+			if (end == std::string_view::npos) break;
+			list.remove_prefix(end + 1);
+		}
+
+		return false;
+	}
+
+	// Surfaceless Mesa first, then the first EGL device (NVIDIA), then whatever the default display is
+	EGLDisplay open_display() {
+		char const* clientExtensions = gEgl.QueryString(nullptr, kEglExtensions);
+
+		if (gEgl.GetPlatformDisplayEXT) {
+			if (has_extension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+				EGLDisplay display = gEgl.GetPlatformDisplayEXT(kEglPlatformSurfaceless, nullptr, nullptr);
+				if (display && gEgl.Initialize(display, nullptr, nullptr)) return display;
+			}
+
+			if (gEgl.QueryDevicesEXT && has_extension(clientExtensions, "EGL_EXT_platform_device")) {
+				EGLDeviceEXT device = nullptr;
+				EGLint count = 0;
+
+				if (gEgl.QueryDevicesEXT(1, &device, &count) && count > 0) {
+					EGLDisplay display = gEgl.GetPlatformDisplayEXT(kEglPlatformDevice, device, nullptr);
+					if (display && gEgl.Initialize(display, nullptr, nullptr)) return display;
+				}
+			}
+		}
+
+		EGLDisplay display = gEgl.GetDisplay(nullptr);
+		if (display && gEgl.Initialize(display, nullptr, nullptr)) return display;
+
+		return nullptr;
+	}
+}
+
+namespace vulpengine::detail {
+	struct HeadlessContext final {
+		EGLContext context = nullptr;
+		EGLSurface surface = nullptr; // Null when surfaceless
+	};
+
+	HeadlessContext* create_headless_context(int width, int height) {
+		if (!load_egl()) {
+			VP_LOG_WARN("libEGL not found");
+			return nullptr;
+		}
+
+		if (!gHeadlessCount) {
+			gEglDisplay = open_display();
+
+			if (!gEglDisplay) {
+				VP_LOG_WARN("No EGL display available");
+				return nullptr;
+			}
+		}
+
+		// Keeps the display initialized until this function either returns a context or cleans up
+		++gHeadlessCount;
+
+		auto fail = [](char const* what) -> HeadlessContext* {
+			VP_LOG_WARN("{} (EGL error {:#x})", what, gEgl.GetError());
+
+			if (!--gHeadlessCount) {
+				gEgl.Terminate(gEglDisplay);
+				gEglDisplay = nullptr;
+			}
+
+			return nullptr;
+		};
+
+		if (!gEgl.BindAPI(kEglOpenGLApi))
+			return fail("EGL does not support desktop OpenGL");
+
+		EGLint const configAttributes[] = {
+			kEglSurfaceType, kEglPbufferBit,
+			kEglRenderableType, kEglOpenGLBit,
+			kEglRedSize, 8, kEglGreenSize, 8, kEglBlueSize, 8, kEglAlphaSize, 8,
+			kEglDepthSize, 24, kEglStencilSize, 8,
+			kEglNone
+		};
+
+		EGLConfig config = nullptr;
+		EGLint configCount = 0;
+		if (!gEgl.ChooseConfig(gEglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0)
+			return fail("No EGL config for OpenGL pbuffers");
+
+		// 4.6 is preferred, 4.5 is the minimum the engine supports and what older llvmpipe offers
+		EGLContext context = nullptr;
+		for (EGLint minor : { 6, 5 }) {
+			EGLint const contextAttributes[] = {
+				kEglContextMajorVersion, 4,
+				kEglContextMinorVersion, minor,
+				kEglContextOpenGLProfileMask, kEglContextOpenGLCoreProfileBit,
+				kEglContextOpenGLForwardCompatible, 1,
+#ifndef VP_DIST
+				kEglContextOpenGLDebug, 1,
+#endif
+				kEglNone
+			};
+
+			context = gEgl.CreateContext(gEglDisplay, config, nullptr, contextAttributes);
+			if (context) break;
+		}
+
+		if (!context)
+			return fail("Failed to create an OpenGL 4.5+ core EGL context");
+
+		EGLSurface surface = nullptr;
+		if (!has_extension(gEgl.QueryString(gEglDisplay, kEglExtensions), "EGL_KHR_surfaceless_context")) {
+			EGLint const surfaceAttributes[] = { kEglWidth, width > 0 ? width : 1, kEglHeight, height > 0 ? height : 1, kEglNone };
+			surface = gEgl.CreatePbufferSurface(gEglDisplay, config, surfaceAttributes);
+
+			if (!surface) {
+				gEgl.DestroyContext(gEglDisplay, context);
+				return fail("Failed to create an EGL pbuffer");
+			}
+		}
+
+		return new HeadlessContext{ context, surface };
+	}
+
+	void destroy_headless_context(HeadlessContext* context) {
+		gEgl.DestroyContext(gEglDisplay, context->context);
+		if (context->surface) gEgl.DestroySurface(gEglDisplay, context->surface);
+		delete context;
+
+		if (!--gHeadlessCount) {
+			gEgl.Terminate(gEglDisplay);
+			gEglDisplay = nullptr;
+		}
+	}
+
+	// Null releases the current context
+	bool make_headless_context_current(HeadlessContext const* context) {
+		if (!context) return gEglDisplay ? gEgl.MakeCurrent(gEglDisplay, nullptr, nullptr, nullptr) : true;
+		return gEgl.MakeCurrent(gEglDisplay, context->surface, context->surface, context->context);
+	}
+
+	GLADapiproc headless_proc_address(char const* name) {
+		return gEgl.GetProcAddress(name);
+	}
+}
@@ -0,0 +1,20 @@
+// No EGL on Windows, headless windows always use the hidden GLFW window fallback
+namespace vulpengine::detail {
+	struct HeadlessContext final {};
+
+	HeadlessContext* create_headless_context(int, int) {
+		return nullptr;
+	}
+
+	void destroy_headless_context(HeadlessContext* context) {
+		delete context;
+	}
+
+	bool make_headless_context_current(HeadlessContext const*) {
+		return false;
+	}
+
+	GLADapiproc headless_proc_address(char const*) {
+		return nullptr;
+	}
+}
@@ -0,0 +1,92 @@
+// Packs files and directories into an archive readable by vulpengine::experimental::Archive
+//
+// vp_pack [--store] <output> <paths...>   Entries are named by their path relative to the working directory
+// vp_pack --list <archive>
+
+#include "vulpengine/experimental/vp_archive.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace {
+	using namespace vulpengine::experimental;
+
+	int usage() {
+		std::fprintf(stderr, "usage: vp_pack [--store] <output> <paths...>\n       vp_pack --list <archive>\n");
+		return 1;
+	}
+
+	int list(char const* path) {
+		Archive const archive(path);
+		if (!archive) return 1;
+
+		for (std::size_t i = 0; i < archive.entry_count(); ++i) {
+			Archive::Entry const entry = archive.entry(i);
+			std::printf("%12llu %s %.*s\n", static_cast<unsigned long long>(entry.size), entry.compressed ? "lz" : "  ", static_cast<int>(entry.path.size()), entry.path.data());
+		}
+
+		return 0;
+	}
+
+	// Directories are walked recursively, files are added in a stable order so archives are reproducible
+	bool collect(std::filesystem::path const& path, std::vector<std::filesystem::path>& files) {
+		std::error_code ec;
+
+		if (std::filesystem::is_regular_file(path, ec)) {
+			files.push_back(path);
+			return true;
+		}
+
+		if (!std::filesystem::is_directory(path, ec)) {
+			std::fprintf(stderr, "%s: no such file or directory\n", path.string().c_str());
+			return false;
+		}
+
+		std::size_t const first = files.size();
+		for (auto const& entry : std::filesystem::recursive_directory_iterator(path, ec))
+			if (entry.is_regular_file()) files.push_back(entry.path());
+
+		std::sort(files.begin() + first, files.end());
+		return !ec;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc == 3 && std::strcmp(argv[1], "--list") == 0) return list(argv[2]);
+
+	int arg = 1;
+	bool compress = true;
+	if (arg < argc && std::strcmp(argv[arg], "--store") == 0) {
+		compress = false;
+		++arg;
+	}
+
+	if (argc - arg < 2) return usage();
+
+	std::filesystem::path const output = argv[arg++];
+
+	std::vector<std::filesystem::path> files;
+	for (; arg < argc; ++arg)
+		if (!collect(argv[arg], files)) return 1;
+
+	ArchiveBuilder builder;
+	std::uintmax_t total = 0;
+
+	for (auto const& file : files) {
+		// Packing the directory the archive is written to shouldn't pick up a previous build of it
+		std::error_code ec;
+		if (std::filesystem::equivalent(file, output, ec)) continue;
+
+		if (!builder.add_file(file, compress)) return 1;
+		total += std::filesystem::file_size(file);
+	}
+
+	if (!builder.write(output)) return 1;
+
+	std::printf("Packed %zu files, %llu bytes into %llu bytes\n", builder.entry_count(), static_cast<unsigned long long>(total), static_cast<unsigned long long>(std::filesystem::file_size(output)));
+	return 0;
+}